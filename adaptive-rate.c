@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \addtogroup cc26xx-web-demo
+ * @{
+ *
+ * \file
+ *   Activity-driven motion sample rate
+ */
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+#include "adaptive-rate.h"
+#include "motion-buffer.h"
+
+#include <stdint.h>
+/*---------------------------------------------------------------------------*/
+#define ACC_AXES           3 /* MOTION_BUFFER_AXIS_ACC_X to _Z */
+
+/* Running means carry this many fractional bits */
+#define MEAN_FRAC          4
+/*---------------------------------------------------------------------------*/
+static uint16_t floor_rate;
+static uint16_t ceiling_rate;
+static uint16_t threshold;
+static uint16_t rate;
+
+static int32_t mean[ACC_AXES];
+static uint32_t variance[ACC_AXES];
+static uint8_t primed;
+
+/* ADAPTIVE_RATE_HOLD in frame timestamp ticks */
+#define HOLD_TICKS \
+  ((uint32_t)((uint64_t)ADAPTIVE_RATE_HOLD * MOTION_FRAME_SECOND / CLOCK_SECOND))
+
+/* Last time the signal was active or the rate stepped down */
+static uint32_t last_change;
+/*---------------------------------------------------------------------------*/
+void
+adaptive_rate_init(uint16_t floor, uint16_t ceiling, uint16_t thr)
+{
+  uint8_t i;
+
+  floor_rate = floor;
+  ceiling_rate = ceiling < floor ? floor : ceiling;
+  threshold = thr;
+  rate = floor_rate;
+
+  for(i = 0; i < ACC_AXES; i++) {
+    mean[i] = 0;
+    variance[i] = 0;
+  }
+  primed = 0;
+  last_change = MOTION_FRAME_NOW();
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+adaptive_rate_add(const motion_frame_t *frame)
+{
+  int32_t dev;
+  uint32_t sq;
+  uint8_t i;
+
+  if(threshold == 0) {
+    return rate;
+  }
+
+  for(i = 0; i < ACC_AXES; i++) {
+    if(!primed) {
+      /* Don't mistake the first reading, gravity included, for motion */
+      mean[i] = (int32_t)frame->axis[i] << MEAN_FRAC;
+      continue;
+    }
+
+    dev = (int32_t)frame->axis[i] - (mean[i] >> MEAN_FRAC);
+    if(dev > INT16_MAX) {
+      dev = INT16_MAX;
+    } else if(dev < -INT16_MAX) {
+      dev = -INT16_MAX;
+    }
+    sq = (uint32_t)(dev * dev);
+
+    mean[i] += (dev << MEAN_FRAC) >> ADAPTIVE_RATE_SMOOTHING;
+    if(sq >= variance[i]) {
+      variance[i] += (sq - variance[i]) >> ADAPTIVE_RATE_SMOOTHING;
+    } else {
+      variance[i] -= (variance[i] - sq) >> ADAPTIVE_RATE_SMOOTHING;
+    }
+  }
+  primed = 1;
+
+  if(adaptive_rate_activity() > threshold) {
+    rate = ceiling_rate;
+    last_change = frame->timestamp;
+  } else if(rate > floor_rate &&
+            frame->timestamp - last_change >= HOLD_TICKS) {
+    /* Quiet: halve the distance to the floor */
+    rate = floor_rate + (rate - floor_rate) / 2;
+    last_change = frame->timestamp;
+  }
+
+  return rate;
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+adaptive_rate_get(void)
+{
+  return rate;
+}
+/*---------------------------------------------------------------------------*/
+uint32_t
+adaptive_rate_activity(void)
+{
+  /* Each term is below 2^30, so the sum can't wrap */
+  return variance[0] + variance[1] + variance[2];
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * @}
+ */
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \addtogroup cc26xx-web-demo
+ * @{
+ *
+ * \file
+ *   Header file for the activity-driven motion sample rate.
+ *
+ *   Every frame updates a running estimate of the accelerometer variance.
+ *   Above the activity threshold, the rate jumps to its ceiling so that the
+ *   movement is sampled in detail. Once the signal has been quiet for a
+ *   while, the rate decays step by step towards its floor.
+ */
+/*---------------------------------------------------------------------------*/
+#ifndef ADAPTIVE_RATE_H_
+#define ADAPTIVE_RATE_H_
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+#include "motion-buffer.h"
+
+#include <stdint.h>
+/*---------------------------------------------------------------------------*/
+/* How long the signal must stay quiet before each step down */
+#ifdef ADAPTIVE_RATE_CONF_HOLD
+#define ADAPTIVE_RATE_HOLD ADAPTIVE_RATE_CONF_HOLD
+#else
+#define ADAPTIVE_RATE_HOLD            (CLOCK_SECOND)
+#endif
+
+/* Weight of the newest frame in the running mean and variance: 1 / 2^n */
+#ifdef ADAPTIVE_RATE_CONF_SMOOTHING
+#define ADAPTIVE_RATE_SMOOTHING ADAPTIVE_RATE_CONF_SMOOTHING
+#else
+#define ADAPTIVE_RATE_SMOOTHING       2
+#endif
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief Sets the bounds and the threshold, and starts at the floor
+ * \param floor The rate when nothing happens, in Hz
+ * \param ceiling The rate during activity, in Hz. Raised to floor if lower
+ * \param threshold Activity threshold, in hundredths of a G squared. 0 keeps
+ *        the rate at the floor
+ */
+void adaptive_rate_init(uint16_t floor, uint16_t ceiling, uint16_t threshold);
+
+/**
+ * \brief Accounts for a new frame
+ * \param frame The frame
+ * \return The rate to sample at from now on, in Hz
+ */
+uint16_t adaptive_rate_add(const motion_frame_t *frame);
+
+/**
+ * \brief Returns the rate to sample at, in Hz
+ */
+uint16_t adaptive_rate_get(void);
+
+/**
+ * \brief Returns the current activity: the sum of the running variances of
+ *        the accelerometer axes, in hundredths of a G squared
+ */
+uint32_t adaptive_rate_activity(void);
+/*---------------------------------------------------------------------------*/
+#endif /* ADAPTIVE_RATE_H_ */
+/*---------------------------------------------------------------------------*/
+/**
+ * @}
+ */
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \addtogroup cc26xx-web-demo
+ * @{
+ *
+ * \file
+ *   A minimal CBOR encoder with append-only cursor semantics
+ */
+/*---------------------------------------------------------------------------*/
+#include "cbor-writer.h"
+
+#include <stdint.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+#define CBOR_MAJOR_UINT   0x00
+#define CBOR_MAJOR_NINT   0x20
+#define CBOR_MAJOR_BYTES  0x40
+#define CBOR_MAJOR_TEXT   0x60
+#define CBOR_MAJOR_ARRAY  0x80
+#define CBOR_MAJOR_MAP    0xA0
+
+#define CBOR_INFO_UINT8   24
+#define CBOR_INFO_UINT16  25
+#define CBOR_INFO_UINT32  26
+#define CBOR_INFO_UINT64  27
+/*---------------------------------------------------------------------------*/
+static void
+put(cbor_writer_t *w, uint8_t b)
+{
+  if(w->pos < w->size) {
+    w->buf[w->pos++] = b;
+  } else {
+    w->overflow = 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Writes an item header using the shortest argument encoding */
+static void
+put_head(cbor_writer_t *w, uint8_t major, uint32_t arg)
+{
+  if(arg < CBOR_INFO_UINT8) {
+    put(w, major | arg);
+  } else if(arg <= 0xFF) {
+    put(w, major | CBOR_INFO_UINT8);
+    put(w, arg);
+  } else if(arg <= 0xFFFF) {
+    put(w, major | CBOR_INFO_UINT16);
+    put(w, arg >> 8);
+    put(w, arg);
+  } else {
+    put(w, major | CBOR_INFO_UINT32);
+    put(w, arg >> 24);
+    put(w, arg >> 16);
+    put(w, arg >> 8);
+    put(w, arg);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+put_data(cbor_writer_t *w, const uint8_t *data, uint16_t len)
+{
+  if(w->overflow || len > w->size - w->pos) {
+    w->overflow = 1;
+    return;
+  }
+
+  memcpy(&w->buf[w->pos], data, len);
+  w->pos += len;
+}
+/*---------------------------------------------------------------------------*/
+void
+cbor_writer_init(cbor_writer_t *w, uint8_t *buf, uint16_t size)
+{
+  w->buf = buf;
+  w->size = size;
+  w->pos = 0;
+  w->overflow = 0;
+}
+/*---------------------------------------------------------------------------*/
+void
+cbor_writer_uint(cbor_writer_t *w, uint32_t value)
+{
+  put_head(w, CBOR_MAJOR_UINT, value);
+}
+/*---------------------------------------------------------------------------*/
+void
+cbor_writer_uint64(cbor_writer_t *w, uint64_t value)
+{
+  int shift;
+
+  if(value <= UINT32_MAX) {
+    put_head(w, CBOR_MAJOR_UINT, (uint32_t)value);
+    return;
+  }
+
+  put(w, CBOR_MAJOR_UINT | CBOR_INFO_UINT64);
+  for(shift = 56; shift >= 0; shift -= 8) {
+    put(w, value >> shift);
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+cbor_writer_int(cbor_writer_t *w, int32_t value)
+{
+  if(value < 0) {
+    /* Negative integers are encoded as -1 - n */
+    put_head(w, CBOR_MAJOR_NINT, (uint32_t)(-(value + 1)));
+  } else {
+    put_head(w, CBOR_MAJOR_UINT, value);
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+cbor_writer_bytes(cbor_writer_t *w, const uint8_t *data, uint16_t len)
+{
+  put_head(w, CBOR_MAJOR_BYTES, len);
+  put_data(w, data, len);
+}
+/*---------------------------------------------------------------------------*/
+void
+cbor_writer_text(cbor_writer_t *w, const char *str)
+{
+  uint16_t len = strlen(str);
+
+  put_head(w, CBOR_MAJOR_TEXT, len);
+  put_data(w, (const uint8_t *)str, len);
+}
+/*---------------------------------------------------------------------------*/
+void
+cbor_writer_array(cbor_writer_t *w, uint16_t count)
+{
+  put_head(w, CBOR_MAJOR_ARRAY, count);
+}
+/*---------------------------------------------------------------------------*/
+void
+cbor_writer_map(cbor_writer_t *w, uint16_t count)
+{
+  put_head(w, CBOR_MAJOR_MAP, count);
+}
+/*---------------------------------------------------------------------------*/
+int
+cbor_writer_len(const cbor_writer_t *w)
+{
+  return w->overflow ? -1 : w->pos;
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * @}
+ */
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \addtogroup cc26xx-web-demo
+ * @{
+ *
+ * \file
+ *   Header file for a minimal CBOR (RFC 7049) encoder.
+ *
+ *   Only the subset needed for motion publishes is supported: unsigned and
+ *   negative integers, byte and text strings, and definite-length arrays and
+ *   maps. Like the JSON writer, it appends through a cursor and latches an
+ *   overflow flag when the buffer runs out.
+ */
+/*---------------------------------------------------------------------------*/
+#ifndef CBOR_WRITER_H_
+#define CBOR_WRITER_H_
+/*---------------------------------------------------------------------------*/
+#include <stdint.h>
+/*---------------------------------------------------------------------------*/
+typedef struct cbor_writer {
+  uint8_t *buf;
+  uint16_t size;
+  uint16_t pos;
+  uint8_t overflow;
+} cbor_writer_t;
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief Prepares a writer to output into buf
+ * \param w A pointer to the writer
+ * \param buf The output buffer
+ * \param size The size of buf in bytes
+ */
+void cbor_writer_init(cbor_writer_t *w, uint8_t *buf, uint16_t size);
+
+/** \brief Writes an unsigned integer (major type 0) */
+void cbor_writer_uint(cbor_writer_t *w, uint32_t value);
+
+/** \brief Writes an unsigned 64-bit integer (major type 0) */
+void cbor_writer_uint64(cbor_writer_t *w, uint64_t value);
+
+/** \brief Writes a signed integer (major type 0 or 1) */
+void cbor_writer_int(cbor_writer_t *w, int32_t value);
+
+/** \brief Writes a byte string (major type 2) */
+void cbor_writer_bytes(cbor_writer_t *w, const uint8_t *data, uint16_t len);
+
+/** \brief Writes a text string (major type 3) */
+void cbor_writer_text(cbor_writer_t *w, const char *str);
+
+/**
+ * \brief Opens a definite-length array (major type 4)
+ * \param count The number of elements that will follow
+ */
+void cbor_writer_array(cbor_writer_t *w, uint16_t count);
+
+/**
+ * \brief Opens a definite-length map (major type 5)
+ * \param count The number of key/value pairs that will follow
+ */
+void cbor_writer_map(cbor_writer_t *w, uint16_t count);
+
+/**
+ * \brief Returns the number of bytes written so far
+ * \return The length, or -1 if the buffer overflowed
+ */
+int cbor_writer_len(const cbor_writer_t *w);
+/*---------------------------------------------------------------------------*/
+#endif /* CBOR_WRITER_H_ */
+/*---------------------------------------------------------------------------*/
+/**
+ * @}
+ */
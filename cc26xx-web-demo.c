@@ -43,12 +43,24 @@
 #include "lib/sensors.h"
 #include "lib/list.h"
 #include "sys/process.h"
+#include "sys/energest.h"
+#include "lib/random.h"
+#include "net/linkaddr.h"
 #include "net/ipv6/sicslowpan.h"
 #include "button-sensor.h"
 #include "batmon-sensor.h"
 #include "httpd-simple.h"
 #include "cc26xx-web-demo.h"
 #include "mqtt-client.h"
+#include "motion-buffer.h"
+#include "mpu-fifo.h"
+#include "mpu-wom.h"
+#include "pretrigger.h"
+#include "door-detector.h"
+#include "adaptive-rate.h"
+#include "sntp-client.h"
+#include "cycle-stats.h"
+#include "energy-stats.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -71,9 +83,38 @@ PROCESS(cc26xx_web_demo_process, "CC26XX Web Demo");
  */
 #define SENSOR_READING_PERIOD (CLOCK_SECOND * 0.50)
 
+/* Time between two motion samples, at least one tick */
+#define SAMPLE_PERIOD(rate) \
+  ((CLOCK_SECOND / (rate)) ? (CLOCK_SECOND / (rate)) : 1)
+
 struct ctimer batmon_timer;
 
 struct ctimer bmp_timer, hdc_timer, tmp_timer, opt_timer, mpu_timer;
+
+#if CC26XX_WEB_DEMO_MPU_FIFO
+static struct ctimer mpu_fifo_timer;
+static uint32_t mpu_fifo_drain_time;
+static uint16_t mpu_fifo_asked; /* The rate the FIFO was started with */
+static uint16_t mpu_fifo_rate;  /* The rate the MPU could give for it */
+static uint16_t mpu_fifo_kept; /* Frames past the deadband in this drain */
+static uint8_t mpu_fifo_running;
+#endif
+
+#if CC26XX_WEB_DEMO_WAKE_ON_MOTION
+/* Waiting for the MPU to power up, waiting for motion, sampling a window */
+#define WOM_STATE_ARMING    0
+#define WOM_STATE_ARMED     1
+#define WOM_STATE_SAMPLING  2
+
+static struct ctimer wom_window_timer;
+static struct ctimer pretrigger_timer;
+static uint8_t wom_state;
+#endif
+
+#if CC26XX_WEB_DEMO_DOOR_EVENTS
+/* Handed to the MQTT client with door_event. Door events are seconds apart */
+static door_detector_event_t door_last_event;
+#endif
 /*---------------------------------------------------------------------------*/
 /* Provide visible feedback via LEDS while searching for a network */
 #define NO_NET_LED_DURATION        (CC26XX_WEB_DEMO_NET_CONNECT_PERIODIC >> 1)
@@ -92,17 +133,25 @@ process_event_t cc26xx_web_demo_publish_event;
 process_event_t cc26xx_web_demo_config_loaded_event;
 process_event_t cc26xx_web_demo_load_config_defaults;
 process_event_t append_motion_sensor_event;
+process_event_t motion_window_end_event;
+process_event_t door_event;
 /*---------------------------------------------------------------------------*/
 /* Saved settings on flash: store, offset, magic */
 #define CONFIG_FLASH_OFFSET        0
 #define CONFIG_MAGIC      0xCC265002
 
 cc26xx_web_demo_config_t cc26xx_web_demo_config;
-motion_sensor_data_t motion_sensor_arr;
-const motion_sensor_data_t empty_motion_arr;
 /*---------------------------------------------------------------------------*/
 /* A cache of sensor values. Updated periodically or upon key press */
 LIST(sensor_list);
+
+/*
+ * The same readings, indexed by CC26XX_WEB_DEMO_SENSOR_xyz, and a bitmap of
+ * the ones that are being published. Lookups by type don't need to walk the
+ * list. Keep the bitmap in sync through set_publish()
+ */
+static cc26xx_web_demo_sensor_reading_t *sensor_registry[CC26XX_WEB_DEMO_SENSOR_COUNT];
+static uint32_t sensors_enabled;
 /*---------------------------------------------------------------------------*/
 /* The objects representing sensors used in this demo */
 #define DEMO_SENSOR(name, type, descr, xml_element, form_field, units) \
@@ -137,10 +186,55 @@ DEMO_SENSOR(mpu_gyro_y, CC26XX_WEB_DEMO_SENSOR_MPU_GYRO_Y,
 DEMO_SENSOR(mpu_gyro_z, CC26XX_WEB_DEMO_SENSOR_MPU_GYRO_Z,
             "Gyro Z", "gyro-z", "gyro_Z",
             CC26XX_WEB_DEMO_UNIT_GYRO);
+
+/* MPU readings in motion frame axis order */
+static cc26xx_web_demo_sensor_reading_t *const mpu_readings[] = {
+  &mpu_acc_x_reading, &mpu_acc_y_reading, &mpu_acc_z_reading,
+  &mpu_gyro_x_reading, &mpu_gyro_y_reading, &mpu_gyro_z_reading,
+};
 /*---------------------------------------------------------------------------*/
 
 static void init_mpu_reading(void *data);
+#if CC26XX_WEB_DEMO_MPU_FIFO
+static void restart_mpu_fifo(void);
+#endif
+#if CC26XX_WEB_DEMO_WAKE_ON_MOTION
+static void rearm_wake_on_motion(void);
+#endif
+
+/*---------------------------------------------------------------------------*/
+/* The rate the MPU should sample at right now, in Hz */
+static uint16_t
+current_sample_rate(void)
+{
+  if(cc26xx_web_demo_config.activity_threshold) {
+    return adaptive_rate_get();
+  }
+
+  return cc26xx_web_demo_config.sample_rate;
+}
+/*---------------------------------------------------------------------------*/
+/* Restarts the adaptive rate from its floor with the latest settings */
+static void
+reset_adaptive_rate(void)
+{
+  adaptive_rate_init(cc26xx_web_demo_config.rate_floor,
+                     cc26xx_web_demo_config.rate_ceiling,
+                     cc26xx_web_demo_config.activity_threshold);
+#if CC26XX_WEB_DEMO_MPU_FIFO
+  restart_mpu_fifo();
+#endif
+}
+/*---------------------------------------------------------------------------*/
+static void
+reset_deadbands(void)
+{
+  int i;
 
+  for(i = 0; i < CC26XX_WEB_DEMO_SENSOR_COUNT; i++) {
+    cc26xx_web_demo_config.deadband[i] = CC26XX_WEB_DEMO_DEFAULT_DEADBAND;
+  }
+}
 /*---------------------------------------------------------------------------*/
 static void
 publish_led_off(void *d)
@@ -149,11 +243,32 @@ publish_led_off(void *d)
 }
 /*---------------------------------------------------------------------------*/
 static void
+register_sensor(cc26xx_web_demo_sensor_reading_t *reading)
+{
+  list_add(sensor_list, reading);
+  sensor_registry[reading->type] = reading;
+  if(reading->publish) {
+    sensors_enabled |= (1UL << reading->type);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+set_publish(cc26xx_web_demo_sensor_reading_t *reading, uint8_t publish)
+{
+  reading->publish = publish;
+  if(publish) {
+    sensors_enabled |= (1UL << reading->type);
+  } else {
+    sensors_enabled &= ~(1UL << reading->type);
+    snprintf(reading->converted, CC26XX_WEB_DEMO_CONVERTED_LEN, "\"N/A\"");
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
 save_config()
 {
   /* Dump current running config to flash */
   int rv;
-  cc26xx_web_demo_sensor_reading_t *reading = NULL;
   rv = ext_flash_open();
   if(!rv) {
     printf("Could not open flash to save config\n");
@@ -168,15 +283,7 @@ save_config()
   } else {
     cc26xx_web_demo_config.magic = CONFIG_MAGIC;
     cc26xx_web_demo_config.len = sizeof(cc26xx_web_demo_config_t);
-    cc26xx_web_demo_config.sensors_bitmap = 0;
-
-    for(reading = list_head(sensor_list);
-        reading != NULL;
-        reading = list_item_next(reading)) {
-      if(reading->publish) {
-        cc26xx_web_demo_config.sensors_bitmap |= (1 << reading->type);
-      }
-    }
+    cc26xx_web_demo_config.sensors_bitmap = sensors_enabled;
 
     rv = ext_flash_write(CONFIG_FLASH_OFFSET, sizeof(cc26xx_web_demo_config_t),
                          (uint8_t *)&cc26xx_web_demo_config);
@@ -194,6 +301,7 @@ load_config()
   /* Read from flash into a temp buffer */
   cc26xx_web_demo_config_t tmp_cfg;
   cc26xx_web_demo_sensor_reading_t *reading = NULL;
+  int i;
   // printf("Entering load config\n");
   int rv = ext_flash_open();
   // printf("after flash open\n");
@@ -218,15 +326,49 @@ load_config()
     memcpy(&cc26xx_web_demo_config, &tmp_cfg, sizeof(cc26xx_web_demo_config));
   }
 
+  /* Saved by a build with different limits (e.g. the other MPU mode) */
+  if(cc26xx_web_demo_config.sample_rate < CC26XX_WEB_DEMO_SAMPLE_RATE_MIN ||
+     cc26xx_web_demo_config.sample_rate > CC26XX_WEB_DEMO_SAMPLE_RATE_MAX) {
+    cc26xx_web_demo_config.sample_rate = CC26XX_WEB_DEMO_DEFAULT_SAMPLE_RATE;
+  }
+
+  if(cc26xx_web_demo_config.rate_floor < CC26XX_WEB_DEMO_SAMPLE_RATE_MIN ||
+     cc26xx_web_demo_config.rate_floor > CC26XX_WEB_DEMO_SAMPLE_RATE_MAX) {
+    cc26xx_web_demo_config.rate_floor = CC26XX_WEB_DEMO_DEFAULT_RATE_FLOOR;
+  }
+
+  if(cc26xx_web_demo_config.rate_ceiling < CC26XX_WEB_DEMO_SAMPLE_RATE_MIN ||
+     cc26xx_web_demo_config.rate_ceiling > CC26XX_WEB_DEMO_SAMPLE_RATE_MAX) {
+    cc26xx_web_demo_config.rate_ceiling = CC26XX_WEB_DEMO_DEFAULT_RATE_CEILING;
+  }
+
+  for(i = 0; i < CC26XX_WEB_DEMO_SENSOR_COUNT; i++) {
+    if(cc26xx_web_demo_config.deadband[i] > CC26XX_WEB_DEMO_DEADBAND_MAX) {
+      cc26xx_web_demo_config.deadband[i] = CC26XX_WEB_DEMO_DEFAULT_DEADBAND;
+    }
+  }
+
+  if(cc26xx_web_demo_config.wom_threshold < CC26XX_WEB_DEMO_WOM_THRESHOLD_MIN ||
+     cc26xx_web_demo_config.wom_threshold > CC26XX_WEB_DEMO_WOM_THRESHOLD_MAX) {
+    cc26xx_web_demo_config.wom_threshold = CC26XX_WEB_DEMO_DEFAULT_WOM_THRESHOLD;
+  }
+
+  if(cc26xx_web_demo_config.wom_window < CC26XX_WEB_DEMO_WOM_WINDOW_MIN ||
+     cc26xx_web_demo_config.wom_window > CC26XX_WEB_DEMO_WOM_WINDOW_MAX) {
+    cc26xx_web_demo_config.wom_window = CC26XX_WEB_DEMO_DEFAULT_WOM_WINDOW;
+  }
+
+  if(cc26xx_web_demo_config.pretrigger_depth >
+     CC26XX_WEB_DEMO_PRETRIGGER_DEPTH_MAX) {
+    cc26xx_web_demo_config.pretrigger_depth =
+      CC26XX_WEB_DEMO_DEFAULT_PRETRIGGER_DEPTH;
+  }
+
   for(reading = list_head(sensor_list);
       reading != NULL;
       reading = list_item_next(reading)) {
-    if(cc26xx_web_demo_config.sensors_bitmap & (1 << reading->type)) {
-      reading->publish = 1;
-    } else {
-      reading->publish = 0;
-      snprintf(reading->converted, CC26XX_WEB_DEMO_CONVERTED_LEN, "\"N/A\"");
-    }
+    set_publish(reading,
+                (cc26xx_web_demo_config.sensors_bitmap >> reading->type) & 1);
   }
 }
 /*---------------------------------------------------------------------------*/
@@ -261,17 +403,21 @@ int cc26xx_web_demo_ipaddr_sprintf(char *buf, uint8_t buf_len,
 const cc26xx_web_demo_sensor_reading_t *
 cc26xx_web_demo_sensor_lookup(int sens_type)
 {
-  cc26xx_web_demo_sensor_reading_t *reading = NULL;
+  if(sens_type < 0 || sens_type >= CC26XX_WEB_DEMO_SENSOR_COUNT) {
+    return NULL;
+  }
 
-  for(reading = list_head(sensor_list);
-      reading != NULL;
-      reading = list_item_next(reading)) {
-    if(reading->type == sens_type) {
-      return reading;
-    }
+  return sensor_registry[sens_type];
+}
+/*---------------------------------------------------------------------------*/
+int
+cc26xx_web_demo_sensor_enabled(int sens_type)
+{
+  if(sens_type < 0 || sens_type >= CC26XX_WEB_DEMO_SENSOR_COUNT) {
+    return 0;
   }
 
-  return NULL;
+  return (sensors_enabled >> sens_type) & 1;
 }
 /*---------------------------------------------------------------------------*/
 const cc26xx_web_demo_sensor_reading_t *
@@ -290,9 +436,26 @@ cc26xx_web_demo_restore_defaults(void)
   for(reading = list_head(sensor_list);
       reading != NULL;
       reading = list_item_next(reading)) {
-    reading->publish = 1;
+    set_publish(reading, 1);
   }
 
+  cc26xx_web_demo_config.sample_rate = CC26XX_WEB_DEMO_DEFAULT_SAMPLE_RATE;
+  cc26xx_web_demo_config.rate_floor = CC26XX_WEB_DEMO_DEFAULT_RATE_FLOOR;
+  cc26xx_web_demo_config.rate_ceiling = CC26XX_WEB_DEMO_DEFAULT_RATE_CEILING;
+  cc26xx_web_demo_config.activity_threshold =
+    CC26XX_WEB_DEMO_DEFAULT_ACTIVITY_THRESHOLD;
+  reset_adaptive_rate();
+  reset_deadbands();
+
+  cc26xx_web_demo_config.wom_threshold = CC26XX_WEB_DEMO_DEFAULT_WOM_THRESHOLD;
+  cc26xx_web_demo_config.wom_window = CC26XX_WEB_DEMO_DEFAULT_WOM_WINDOW;
+  cc26xx_web_demo_config.pretrigger_depth =
+    CC26XX_WEB_DEMO_DEFAULT_PRETRIGGER_DEPTH;
+#if CC26XX_WEB_DEMO_WAKE_ON_MOTION
+  pretrigger_init(cc26xx_web_demo_config.pretrigger_depth);
+  rearm_wake_on_motion();
+#endif
+
 #if CC26XX_WEB_DEMO_MQTT_CLIENT
   process_post_synch(&mqtt_client_process,
                      cc26xx_web_demo_load_config_defaults, NULL);
@@ -332,11 +495,8 @@ sensor_readings_handler(char *key, int key_len, char *val, int val_len)
       rv = atoi(val);
 
       /* Be pedantic: only accept 0 and 1, not just any non-zero value */
-      if(rv == 0) {
-        reading->publish = 0;
-        snprintf(reading->converted, CC26XX_WEB_DEMO_CONVERTED_LEN, "\"N/A\"");
-      } else if(rv == 1) {
-        reading->publish = 1;
+      if(rv == 0 || rv == 1) {
+        set_publish(reading, rv);
       } else {
         return HTTPD_SIMPLE_POST_HANDLER_ERROR;
       }
@@ -348,6 +508,224 @@ sensor_readings_handler(char *key, int key_len, char *val, int val_len)
   return HTTPD_SIMPLE_POST_HANDLER_UNKNOWN;
 }
 /*---------------------------------------------------------------------------*/
+static int
+deadband_post_handler(char *key, int key_len, char *val, int val_len)
+{
+  cc26xx_web_demo_sensor_reading_t *reading = NULL;
+  int field_len;
+  long rv;
+
+  /* <form_field>_db */
+  for(reading = list_head(sensor_list);
+      reading != NULL;
+      reading = list_item_next(reading)) {
+    field_len = strlen(reading->form_field);
+    if(key_len == field_len + strlen("_db") &&
+       strncmp(reading->form_field, key, field_len) == 0 &&
+       strncasecmp(&key[field_len], "_db", strlen("_db")) == 0) {
+
+      rv = atol(val);
+
+      if(rv < CC26XX_WEB_DEMO_DEADBAND_MIN ||
+         rv > CC26XX_WEB_DEMO_DEADBAND_MAX) {
+        return HTTPD_SIMPLE_POST_HANDLER_ERROR;
+      }
+
+      cc26xx_web_demo_config.deadband[reading->type] = rv;
+
+      return HTTPD_SIMPLE_POST_HANDLER_OK;
+    }
+  }
+
+  return HTTPD_SIMPLE_POST_HANDLER_UNKNOWN;
+}
+/*---------------------------------------------------------------------------*/
+static int
+sample_rate_post_handler(char *key, int key_len, char *val, int val_len)
+{
+  int rv = 0;
+
+  if(key_len != strlen("sample_rate") ||
+     strncasecmp(key, "sample_rate", strlen("sample_rate")) != 0) {
+    /* Not ours */
+    return HTTPD_SIMPLE_POST_HANDLER_UNKNOWN;
+  }
+
+  rv = atoi(val);
+
+  if(rv < CC26XX_WEB_DEMO_SAMPLE_RATE_MIN ||
+     rv > CC26XX_WEB_DEMO_SAMPLE_RATE_MAX) {
+    return HTTPD_SIMPLE_POST_HANDLER_ERROR;
+  }
+
+  cc26xx_web_demo_config.sample_rate = rv;
+
+  /* Polled sampling picks the new rate up when it next reschedules */
+#if CC26XX_WEB_DEMO_MPU_FIFO
+  restart_mpu_fifo();
+#endif
+
+  return HTTPD_SIMPLE_POST_HANDLER_OK;
+}
+/*---------------------------------------------------------------------------*/
+static int
+rate_floor_post_handler(char *key, int key_len, char *val, int val_len)
+{
+  int rv = 0;
+
+  if(key_len != strlen("rate_floor") ||
+     strncasecmp(key, "rate_floor", strlen("rate_floor")) != 0) {
+    /* Not ours */
+    return HTTPD_SIMPLE_POST_HANDLER_UNKNOWN;
+  }
+
+  rv = atoi(val);
+
+  if(rv < CC26XX_WEB_DEMO_SAMPLE_RATE_MIN ||
+     rv > CC26XX_WEB_DEMO_SAMPLE_RATE_MAX) {
+    return HTTPD_SIMPLE_POST_HANDLER_ERROR;
+  }
+
+  if(cc26xx_web_demo_config.rate_floor != rv) {
+    cc26xx_web_demo_config.rate_floor = rv;
+    reset_adaptive_rate();
+  }
+
+  return HTTPD_SIMPLE_POST_HANDLER_OK;
+}
+/*---------------------------------------------------------------------------*/
+static int
+rate_ceiling_post_handler(char *key, int key_len, char *val, int val_len)
+{
+  int rv = 0;
+
+  if(key_len != strlen("rate_ceiling") ||
+     strncasecmp(key, "rate_ceiling", strlen("rate_ceiling")) != 0) {
+    /* Not ours */
+    return HTTPD_SIMPLE_POST_HANDLER_UNKNOWN;
+  }
+
+  rv = atoi(val);
+
+  if(rv < CC26XX_WEB_DEMO_SAMPLE_RATE_MIN ||
+     rv > CC26XX_WEB_DEMO_SAMPLE_RATE_MAX) {
+    return HTTPD_SIMPLE_POST_HANDLER_ERROR;
+  }
+
+  if(cc26xx_web_demo_config.rate_ceiling != rv) {
+    cc26xx_web_demo_config.rate_ceiling = rv;
+    reset_adaptive_rate();
+  }
+
+  return HTTPD_SIMPLE_POST_HANDLER_OK;
+}
+/*---------------------------------------------------------------------------*/
+static int
+activity_threshold_post_handler(char *key, int key_len, char *val,
+                                int val_len)
+{
+  long rv = 0;
+
+  if(key_len != strlen("activity_threshold") ||
+     strncasecmp(key, "activity_threshold",
+                 strlen("activity_threshold")) != 0) {
+    /* Not ours */
+    return HTTPD_SIMPLE_POST_HANDLER_UNKNOWN;
+  }
+
+  rv = atol(val);
+
+  if(rv < CC26XX_WEB_DEMO_ACTIVITY_THRESHOLD_MIN ||
+     rv > CC26XX_WEB_DEMO_ACTIVITY_THRESHOLD_MAX) {
+    return HTTPD_SIMPLE_POST_HANDLER_ERROR;
+  }
+
+  if(cc26xx_web_demo_config.activity_threshold != rv) {
+    cc26xx_web_demo_config.activity_threshold = rv;
+    reset_adaptive_rate();
+  }
+
+  return HTTPD_SIMPLE_POST_HANDLER_OK;
+}
+/*---------------------------------------------------------------------------*/
+#if CC26XX_WEB_DEMO_WAKE_ON_MOTION
+static int
+wom_threshold_post_handler(char *key, int key_len, char *val, int val_len)
+{
+  int rv = 0;
+
+  if(key_len != strlen("wom_threshold") ||
+     strncasecmp(key, "wom_threshold", strlen("wom_threshold")) != 0) {
+    /* Not ours */
+    return HTTPD_SIMPLE_POST_HANDLER_UNKNOWN;
+  }
+
+  rv = atoi(val);
+
+  if(rv < CC26XX_WEB_DEMO_WOM_THRESHOLD_MIN ||
+     rv > CC26XX_WEB_DEMO_WOM_THRESHOLD_MAX) {
+    return HTTPD_SIMPLE_POST_HANDLER_ERROR;
+  }
+
+  cc26xx_web_demo_config.wom_threshold = rv;
+  rearm_wake_on_motion();
+
+  return HTTPD_SIMPLE_POST_HANDLER_OK;
+}
+/*---------------------------------------------------------------------------*/
+static int
+wom_window_post_handler(char *key, int key_len, char *val, int val_len)
+{
+  int rv = 0;
+
+  if(key_len != strlen("wom_window") ||
+     strncasecmp(key, "wom_window", strlen("wom_window")) != 0) {
+    /* Not ours */
+    return HTTPD_SIMPLE_POST_HANDLER_UNKNOWN;
+  }
+
+  rv = atoi(val);
+
+  if(rv < CC26XX_WEB_DEMO_WOM_WINDOW_MIN ||
+     rv > CC26XX_WEB_DEMO_WOM_WINDOW_MAX) {
+    return HTTPD_SIMPLE_POST_HANDLER_ERROR;
+  }
+
+  /* Takes effect from the next window */
+  cc26xx_web_demo_config.wom_window = rv;
+
+  return HTTPD_SIMPLE_POST_HANDLER_OK;
+}
+/*---------------------------------------------------------------------------*/
+static int
+pretrigger_depth_post_handler(char *key, int key_len, char *val, int val_len)
+{
+  int rv = 0;
+
+  if(key_len != strlen("pretrigger_depth") ||
+     strncasecmp(key, "pretrigger_depth", strlen("pretrigger_depth")) != 0) {
+    /* Not ours */
+    return HTTPD_SIMPLE_POST_HANDLER_UNKNOWN;
+  }
+
+  rv = atoi(val);
+
+  if(rv < CC26XX_WEB_DEMO_PRETRIGGER_DEPTH_MIN ||
+     rv > CC26XX_WEB_DEMO_PRETRIGGER_DEPTH_MAX) {
+    return HTTPD_SIMPLE_POST_HANDLER_ERROR;
+  }
+
+  if(cc26xx_web_demo_config.pretrigger_depth != rv) {
+    cc26xx_web_demo_config.pretrigger_depth = rv;
+    pretrigger_init(rv);
+    /* The pre-trigger sampler may have to start or stop */
+    rearm_wake_on_motion();
+  }
+
+  return HTTPD_SIMPLE_POST_HANDLER_OK;
+}
+#endif
+/*---------------------------------------------------------------------------*/
 #if CC26XX_WEB_DEMO_READ_PARENT_RSSI
 static int
 ping_interval_post_handler(char *key, int key_len, char *val, int val_len)
@@ -375,6 +753,17 @@ ping_interval_post_handler(char *key, int key_len, char *val, int val_len)
 /*---------------------------------------------------------------------------*/
 HTTPD_SIMPLE_POST_HANDLER(sensor, sensor_readings_handler);
 HTTPD_SIMPLE_POST_HANDLER(defaults, defaults_post_handler);
+HTTPD_SIMPLE_POST_HANDLER(deadband, deadband_post_handler);
+HTTPD_SIMPLE_POST_HANDLER(sample_rate, sample_rate_post_handler);
+HTTPD_SIMPLE_POST_HANDLER(rate_floor, rate_floor_post_handler);
+HTTPD_SIMPLE_POST_HANDLER(rate_ceiling, rate_ceiling_post_handler);
+HTTPD_SIMPLE_POST_HANDLER(activity_threshold, activity_threshold_post_handler);
+
+#if CC26XX_WEB_DEMO_WAKE_ON_MOTION
+HTTPD_SIMPLE_POST_HANDLER(wom_threshold, wom_threshold_post_handler);
+HTTPD_SIMPLE_POST_HANDLER(wom_window, wom_window_post_handler);
+HTTPD_SIMPLE_POST_HANDLER(pretrigger_depth, pretrigger_depth_post_handler);
+#endif
 
 #if CC26XX_WEB_DEMO_READ_PARENT_RSSI
 HTTPD_SIMPLE_POST_HANDLER(ping_interval, ping_interval_post_handler);
@@ -400,6 +789,48 @@ ping_parent(void)
 }
 #endif
 /*---------------------------------------------------------------------------*/
+/*
+ * Flags a reading as changed once it has moved more than its deadband away
+ * from the last value we flagged. Drift below the deadband accumulates, so
+ * slow ramps still get reported
+ */
+static void
+compare_and_update(cc26xx_web_demo_sensor_reading_t *reading)
+{
+  int delta = reading->raw - reading->last;
+
+  if(delta < 0) {
+    delta = -delta;
+  }
+
+  if(delta == 0 || delta <= cc26xx_web_demo_config.deadband[reading->type]) {
+    reading->changed = 0;
+  } else {
+    reading->last = reading->raw;
+    reading->changed = 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Report by exception: a frame is worth keeping if any enabled axis moved
+ * past its deadband. Axes with no deadband keep every frame
+ */
+static uint8_t
+frame_changed(void)
+{
+  int i;
+
+  for(i = 0; i < MOTION_BUFFER_AXES; i++) {
+    if(mpu_readings[i]->publish &&
+       (mpu_readings[i]->changed ||
+        cc26xx_web_demo_config.deadband[mpu_readings[i]->type] == 0)) {
+      return 1;
+    }
+  }
+
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
 static void
 get_batmon_reading(void *data)
 {
@@ -413,6 +844,7 @@ get_batmon_reading(void *data)
     value = batmon_sensor.value(BATMON_SENSOR_TYPE_TEMP);
     if(value != CC26XX_SENSOR_READING_ERROR) {
       batmon_temp_reading.raw = value;
+      compare_and_update(&batmon_temp_reading);
 
       buf = batmon_temp_reading.converted;
       memset(buf, 0, CC26XX_WEB_DEMO_CONVERTED_LEN);
@@ -424,6 +856,7 @@ get_batmon_reading(void *data)
     value = batmon_sensor.value(BATMON_SENSOR_TYPE_VOLT);
     if(value != CC26XX_SENSOR_READING_ERROR) {
       batmon_volt_reading.raw = value;
+      compare_and_update(&batmon_volt_reading);
 
       buf = batmon_volt_reading.converted;
       memset(buf, 0, CC26XX_WEB_DEMO_CONVERTED_LEN);
@@ -436,17 +869,6 @@ get_batmon_reading(void *data)
 /*---------------------------------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
 static void
-compare_and_update(cc26xx_web_demo_sensor_reading_t *reading)
-{
-  if(reading->last == reading->raw) {
-    reading->changed = 0;
-  } else {
-    reading->last = reading->raw;
-    reading->changed = 1;
-  }
-}
-/*---------------------------------------------------------------------------*/
-static void
 print_mpu_reading(int reading, char *buf)
 {
   char *loc_buf = buf;
@@ -460,15 +882,68 @@ print_mpu_reading(int reading, char *buf)
   sprintf(loc_buf, "%d.%02d", reading / 100, reading % 100);
 }
 
+/*---------------------------------------------------------------------------*/
+#if CC26XX_WEB_DEMO_DOOR_EVENTS
+static void
+post_door_event(const door_detector_event_t *ev)
+{
+  door_last_event = *ev;
+  printf("Door %s, %d deg after %lu ms\n", door_detector_state_name(ev->state),
+         ev->angle, (unsigned long)ev->duration);
+  process_post(PROCESS_BROADCAST, door_event, &door_last_event);
+}
+/*---------------------------------------------------------------------------*/
+static uint8_t
+door_reed_closed(void)
+{
+  return reed_relay_sensor.value(0) == CC26XX_WEB_DEMO_DOOR_REED_CLOSED;
+}
+/*---------------------------------------------------------------------------*/
+static void
+door_reed_changed(void)
+{
+  door_detector_event_t ev;
+
+  if(door_detector_reed(door_reed_closed(), mpu_gyro_z_reading.publish, &ev)) {
+    post_door_event(&ev);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+door_track_frame(const motion_frame_t *frame)
+{
+  door_detector_event_t ev;
+
+  if(door_detector_frame(frame, &ev)) {
+    post_door_event(&ev);
+  }
+}
+#endif
+/*---------------------------------------------------------------------------*/
+/* Everything that looks at frames as they are sampled */
+static void
+frame_added(const motion_frame_t *frame)
+{
+  adaptive_rate_add(frame);
+#if CC26XX_WEB_DEMO_DOOR_EVENTS
+  door_track_frame(frame);
+#endif
+}
 /*---------------------------------------------------------------------------*/
 static void
 get_mpu_reading()
 {
   PRINTF("get_mpu_reading()\n");
-  // clock_time_t next = SENSOR_READING_PERIOD +
-  //   (random_rand() % SENSOR_READING_RANDOM);
-  clock_time_t next = SENSOR_READING_PERIOD;
+  clock_time_t next;
+  motion_frame_t frame;
+  uint32_t start;
   int raw;
+  int i;
+
+  CYCLE_STATS_START(start);
+
+  /* Stamp the frame when the sample is taken, not when it is stored */
+  frame.timestamp = MOTION_FRAME_NOW();
 
   if(mpu_gyro_x_reading.publish) {
     raw = mpu_9250_sensor.value(MPU_9250_SENSOR_TYPE_GYRO_X);
@@ -513,6 +988,7 @@ get_mpu_reading()
   }
 
   SENSORS_DEACTIVATE(mpu_9250_sensor);
+  ENERGEST_OFF(ENERGEST_TYPE_SENSORS);
 
   if(mpu_gyro_x_reading.publish) {
     compare_and_update(&mpu_gyro_x_reading);
@@ -550,6 +1026,24 @@ get_mpu_reading()
     print_mpu_reading(mpu_acc_z_reading.raw, mpu_acc_z_reading.converted);
   }
 
+  frame.flags = 0;
+  for(i = 0; i < MOTION_BUFFER_AXES; i++) {
+    frame.axis[i] = mpu_readings[i]->publish ? mpu_readings[i]->raw : 0;
+  }
+  frame_added(&frame);
+  if(frame_changed()) {
+    motion_buffer_push(&frame);
+    process_post(PROCESS_BROADCAST, append_motion_sensor_event, NULL);
+  }
+  CYCLE_STATS_STOP(CYCLE_STATS_SITE_MPU_READ, start);
+
+  /*
+   * The MPU gets powered up again before the next sample, so the effective
+   * rate is a little below the configured one. This frame may have changed
+   * the rate
+   */
+  next = SAMPLE_PERIOD(current_sample_rate());
+
   /* We only use the single timer */
   ctimer_set(&mpu_timer, next, init_mpu_reading, NULL);
 }
@@ -561,6 +1055,20 @@ init_mpu_reading(void *data)
   PRINTF("init_mpu_reading()\n");
   int readings_bitmap = 0;
 
+#if CC26XX_WEB_DEMO_MPU_FIFO
+  if(mpu_fifo_running) {
+    /* Already powered up and sampling */
+    return;
+  }
+#endif
+
+#if CC26XX_WEB_DEMO_WAKE_ON_MOTION
+  if(wom_state == WOM_STATE_ARMED) {
+    /* Already powered up, waiting for motion */
+    return;
+  }
+#endif
+
   if(mpu_acc_x_reading.publish || mpu_acc_y_reading.publish ||
      mpu_acc_z_reading.publish) {
     readings_bitmap |= MPU_9250_SENSOR_TYPE_ACC;
@@ -573,12 +1081,243 @@ init_mpu_reading(void *data)
 
   if(readings_bitmap) {
     // mpu_9250_sensor.configure(SENSORS_HW_INIT, readings_bitmap);
+    ENERGEST_ON(ENERGEST_TYPE_SENSORS);
     mpu_9250_sensor.configure(SENSORS_ACTIVE, readings_bitmap);
   } else {
     ctimer_set(&mpu_timer, CLOCK_SECOND, init_mpu_reading, NULL);
   }
 }
 /*---------------------------------------------------------------------------*/
+#if CC26XX_WEB_DEMO_MPU_FIFO
+static void
+mpu_fifo_frame_handler(motion_frame_t *frame, uint16_t index, uint16_t count)
+{
+  int i;
+
+  /* The newest frame was sampled roughly now, the rest at the actual rate */
+  frame->timestamp = mpu_fifo_drain_time -
+    ((uint32_t)(count - 1 - index) * MOTION_FRAME_SECOND) / mpu_fifo_rate;
+  frame->flags = 0;
+
+  frame_added(frame);
+
+  for(i = 0; i < MOTION_BUFFER_AXES; i++) {
+    if(mpu_readings[i]->publish) {
+      mpu_readings[i]->raw = frame->axis[i];
+      compare_and_update(mpu_readings[i]);
+    }
+  }
+
+  if(frame_changed()) {
+    motion_buffer_push(frame);
+    mpu_fifo_kept++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+read_mpu_fifo(void)
+{
+  uint32_t start;
+  int frames;
+  int i;
+
+  CYCLE_STATS_START(start);
+  mpu_fifo_drain_time = MOTION_FRAME_NOW();
+  mpu_fifo_kept = 0;
+  frames = MPU_FIFO_DRIVER.drain(mpu_fifo_frame_handler);
+
+  if(frames < 0) {
+    PRINTF("MPU FIFO overflow, samples lost\n");
+  } else if(frames > 0) {
+    /* Keep the cached readings fresh for the web pages */
+    for(i = 0; i < MOTION_BUFFER_AXES; i++) {
+      if(mpu_readings[i]->publish) {
+        memset(mpu_readings[i]->converted, 0, CC26XX_WEB_DEMO_CONVERTED_LEN);
+        print_mpu_reading(mpu_readings[i]->raw, mpu_readings[i]->converted);
+      }
+    }
+
+    if(mpu_fifo_kept > 0) {
+      process_post(PROCESS_BROADCAST, append_motion_sensor_event, NULL);
+    }
+  }
+  CYCLE_STATS_STOP(CYCLE_STATS_SITE_MPU_READ, start);
+}
+/*---------------------------------------------------------------------------*/
+static void
+drain_mpu_fifo(void *data)
+{
+  read_mpu_fifo();
+
+  if(mpu_fifo_asked != current_sample_rate()) {
+    /* The frames just read moved the adaptive rate */
+    restart_mpu_fifo();
+    return;
+  }
+
+  ctimer_set(&mpu_fifo_timer, MPU_FIFO_DRAIN_PERIOD(mpu_fifo_rate),
+             drain_mpu_fifo, NULL);
+}
+/*---------------------------------------------------------------------------*/
+static void
+start_mpu_fifo(void)
+{
+  /* The MPU has just powered up. Leave it on and sampling into its FIFO */
+  mpu_fifo_asked = current_sample_rate();
+  mpu_fifo_rate = MPU_FIFO_DRIVER.start(mpu_fifo_asked);
+  if(mpu_fifo_rate > 0) {
+    mpu_fifo_running = 1;
+    ctimer_set(&mpu_fifo_timer, MPU_FIFO_DRAIN_PERIOD(mpu_fifo_rate),
+               drain_mpu_fifo, NULL);
+  } else {
+    /* Fall back to reading one sample at a time */
+    printf("Could not start the MPU FIFO (%s)\n", MPU_FIFO_DRIVER.name);
+    get_mpu_reading();
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+restart_mpu_fifo(void)
+{
+  if(!mpu_fifo_running || mpu_fifo_asked == current_sample_rate()) {
+    return;
+  }
+
+  /* Flush what was sampled at the old rate, then carry on at the new one */
+  read_mpu_fifo();
+  ctimer_stop(&mpu_fifo_timer);
+  MPU_FIFO_DRIVER.stop();
+  mpu_fifo_running = 0;
+  start_mpu_fifo();
+}
+#endif
+/*---------------------------------------------------------------------------*/
+/* Called once the MPU has powered up */
+static void
+start_mpu_sampling(void)
+{
+#if CC26XX_WEB_DEMO_MPU_FIFO
+  start_mpu_fifo();
+#else
+  get_mpu_reading();
+#endif
+}
+/*---------------------------------------------------------------------------*/
+#if CC26XX_WEB_DEMO_WAKE_ON_MOTION
+static void close_motion_window(void *data);
+/*---------------------------------------------------------------------------*/
+/* Runs in interrupt context on the SensorTag */
+static void
+motion_detected(void)
+{
+  process_poll(&cc26xx_web_demo_process);
+}
+/*---------------------------------------------------------------------------*/
+static void
+open_motion_window(void)
+{
+  wom_state = WOM_STATE_SAMPLING;
+  ctimer_set(&wom_window_timer,
+             (clock_time_t)cc26xx_web_demo_config.wom_window * CLOCK_SECOND,
+             close_motion_window, NULL);
+  start_mpu_sampling();
+}
+/*---------------------------------------------------------------------------*/
+/* Keeps the last few low-rate frames while waiting for motion */
+static void
+sample_pretrigger(void *data)
+{
+  motion_frame_t frame;
+
+  if(wom_state != WOM_STATE_ARMED || pretrigger_depth() == 0) {
+    return;
+  }
+
+  if(MPU_WOM_DRIVER.read(&frame)) {
+    frame.timestamp = MOTION_FRAME_NOW();
+    frame.flags = 0;
+    pretrigger_push(&frame);
+  }
+
+  ctimer_set(&pretrigger_timer, SAMPLE_PERIOD(CC26XX_WEB_DEMO_PRETRIGGER_RATE),
+             sample_pretrigger, NULL);
+}
+/*---------------------------------------------------------------------------*/
+/* The MPU must be powered up */
+static void
+arm_wake_on_motion(void)
+{
+  if(MPU_WOM_DRIVER.arm(cc26xx_web_demo_config.wom_threshold,
+                        motion_detected)) {
+    wom_state = WOM_STATE_ARMED;
+    /* Cycle mode only draws a few uA. Don't account for it as sensing */
+    ENERGEST_OFF(ENERGEST_TYPE_SENSORS);
+    sample_pretrigger(NULL);
+  } else {
+    /* Sample anyway. We try again when the window closes */
+    printf("Could not arm wake-on-motion (%s)\n", MPU_WOM_DRIVER.name);
+    open_motion_window();
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+rearm_wake_on_motion(void)
+{
+  /* Pick up new settings now. Otherwise they apply at the next arm */
+  if(wom_state == WOM_STATE_ARMED) {
+    arm_wake_on_motion();
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+motion_started(void)
+{
+  if(wom_state != WOM_STATE_ARMED) {
+    return;
+  }
+
+  PRINTF("Motion detected\n");
+  MPU_WOM_DRIVER.disarm();
+  ENERGEST_ON(ENERGEST_TYPE_SENSORS);
+
+  /* Freeze the pre-trigger frames and put them ahead of the window */
+  ctimer_stop(&pretrigger_timer);
+  if(pretrigger_release() > 0) {
+    process_post(PROCESS_BROADCAST, append_motion_sensor_event, NULL);
+  }
+
+  open_motion_window();
+}
+/*---------------------------------------------------------------------------*/
+static void
+close_motion_window(void *data)
+{
+  wom_state = WOM_STATE_ARMING;
+
+#if CC26XX_WEB_DEMO_MPU_FIFO
+  if(mpu_fifo_running) {
+    /* Keep the tail of the window. The MPU stays powered, arm it right away */
+    read_mpu_fifo();
+    ctimer_stop(&mpu_fifo_timer);
+    MPU_FIFO_DRIVER.stop();
+    mpu_fifo_running = 0;
+    arm_wake_on_motion();
+  } else
+#endif
+  if(!ctimer_expired(&mpu_timer)) {
+    /*
+     * Polled sampling powers the MPU down between samples. Power it up now,
+     * the ready event arms it. If it was already powering up, just wait
+     */
+    ctimer_stop(&mpu_timer);
+    init_mpu_reading(NULL);
+  }
+
+  /* Have what's left of the window published */
+  process_post(PROCESS_BROADCAST, motion_window_end_event, NULL);
+}
+#endif
+/*---------------------------------------------------------------------------*/
 static void
 init_sensor_readings(void)
 {
@@ -594,32 +1333,50 @@ init_sensor_readings(void)
   return;
 }
 /*---------------------------------------------------------------------------*/
+/*
+ * The platform seeds the generator with a constant, so every node would draw
+ * the same numbers, e.g. the same reconnect jitter after a shared outage.
+ * Seed it from the link-layer address instead
+ */
+static void
+seed_random(void)
+{
+  unsigned short seed = 0;
+  uint8_t i;
+
+  for(i = 0; i < LINKADDR_SIZE; i++) {
+    seed = (seed << 5) + (seed >> 11) + linkaddr_node_addr.u8[i];
+  }
+
+  random_init(seed);
+}
+/*---------------------------------------------------------------------------*/
 static void
 init_sensors(void)
 {
   PRINTF("init_sensors()\n");
 
-  list_add(sensor_list, &batmon_temp_reading);
-  list_add(sensor_list, &batmon_volt_reading);
+  register_sensor(&batmon_temp_reading);
+  register_sensor(&batmon_volt_reading);
   SENSORS_ACTIVATE(batmon_sensor);
 
-  // list_add(sensor_list, &bmp_pres_reading);
-  // list_add(sensor_list, &bmp_temp_reading);
+  // register_sensor(&bmp_pres_reading);
+  // register_sensor(&bmp_temp_reading);
 
-  // list_add(sensor_list, &tmp_obj_reading);
-  // list_add(sensor_list, &tmp_amb_reading);
+  // register_sensor(&tmp_obj_reading);
+  // register_sensor(&tmp_amb_reading);
 
-  // list_add(sensor_list, &opt_reading);
+  // register_sensor(&opt_reading);
 
-  // list_add(sensor_list, &hdc_hum_reading);
-  // list_add(sensor_list, &hdc_temp_reading);
+  // register_sensor(&hdc_hum_reading);
+  // register_sensor(&hdc_temp_reading);
 
-  list_add(sensor_list, &mpu_acc_x_reading);
-  list_add(sensor_list, &mpu_acc_y_reading);
-  list_add(sensor_list, &mpu_acc_z_reading);
-  list_add(sensor_list, &mpu_gyro_x_reading);
-  list_add(sensor_list, &mpu_gyro_y_reading);
-  list_add(sensor_list, &mpu_gyro_z_reading);
+  register_sensor(&mpu_acc_x_reading);
+  register_sensor(&mpu_acc_y_reading);
+  register_sensor(&mpu_acc_z_reading);
+  register_sensor(&mpu_gyro_x_reading);
+  register_sensor(&mpu_gyro_y_reading);
+  register_sensor(&mpu_gyro_z_reading);
 
   SENSORS_ACTIVATE(reed_relay_sensor);
 }
@@ -630,6 +1387,9 @@ PROCESS_THREAD(cc26xx_web_demo_process, ev, data)
 
   printf("CC26XX Web Demo Process\n");
 
+  seed_random();
+  cycle_stats_init();
+  energy_stats_init();
   init_sensors();
 
   cc26xx_web_demo_publish_event = process_alloc_event(); // this event is 142
@@ -639,6 +1399,8 @@ PROCESS_THREAD(cc26xx_web_demo_process, ev, data)
   cc26xx_web_demo_load_config_defaults = process_alloc_event();
   // printf("publish event is %d\n", cc26xx_web_demo_load_config_defaults);
   append_motion_sensor_event = process_alloc_event();
+  motion_window_end_event = process_alloc_event();
+  door_event = process_alloc_event();
 
   /* Start all other (enabled) processes first */
   process_start(&httpd_simple_process, NULL);
@@ -647,6 +1409,10 @@ PROCESS_THREAD(cc26xx_web_demo_process, ev, data)
   process_start(&cetic_6lbr_client_process, NULL);
 #endif
 
+#if CC26XX_WEB_DEMO_SNTP_CLIENT
+  process_start(&sntp_client_process, NULL);
+#endif
+
 #if CC26XX_WEB_DEMO_MQTT_CLIENT
   process_start(&mqtt_client_process, NULL);
 #endif
@@ -658,7 +1424,26 @@ PROCESS_THREAD(cc26xx_web_demo_process, ev, data)
   cc26xx_web_demo_config.sensors_bitmap = 0xFFFFFFFF; /* all on by default */
   cc26xx_web_demo_config.def_rt_ping_interval =
       CC26XX_WEB_DEMO_DEFAULT_RSSI_MEAS_INTERVAL;
+  cc26xx_web_demo_config.sample_rate = CC26XX_WEB_DEMO_DEFAULT_SAMPLE_RATE;
+  cc26xx_web_demo_config.rate_floor = CC26XX_WEB_DEMO_DEFAULT_RATE_FLOOR;
+  cc26xx_web_demo_config.rate_ceiling = CC26XX_WEB_DEMO_DEFAULT_RATE_CEILING;
+  cc26xx_web_demo_config.activity_threshold =
+    CC26XX_WEB_DEMO_DEFAULT_ACTIVITY_THRESHOLD;
+  reset_deadbands();
+  cc26xx_web_demo_config.wom_threshold = CC26XX_WEB_DEMO_DEFAULT_WOM_THRESHOLD;
+  cc26xx_web_demo_config.wom_window = CC26XX_WEB_DEMO_DEFAULT_WOM_WINDOW;
+  cc26xx_web_demo_config.pretrigger_depth =
+    CC26XX_WEB_DEMO_DEFAULT_PRETRIGGER_DEPTH;
   load_config();
+  adaptive_rate_init(cc26xx_web_demo_config.rate_floor,
+                     cc26xx_web_demo_config.rate_ceiling,
+                     cc26xx_web_demo_config.activity_threshold);
+#if CC26XX_WEB_DEMO_WAKE_ON_MOTION
+  pretrigger_init(cc26xx_web_demo_config.pretrigger_depth);
+#endif
+#if CC26XX_WEB_DEMO_DOOR_EVENTS
+  door_detector_init(door_reed_closed());
+#endif
 
   /*
    * Notify all other processes (basically the ones in this demo) that the
@@ -671,6 +1456,16 @@ PROCESS_THREAD(cc26xx_web_demo_process, ev, data)
 
   httpd_simple_register_post_handler(&sensor_handler);
   httpd_simple_register_post_handler(&defaults_handler);
+  httpd_simple_register_post_handler(&deadband_handler);
+  httpd_simple_register_post_handler(&sample_rate_handler);
+  httpd_simple_register_post_handler(&rate_floor_handler);
+  httpd_simple_register_post_handler(&rate_ceiling_handler);
+  httpd_simple_register_post_handler(&activity_threshold_handler);
+#if CC26XX_WEB_DEMO_WAKE_ON_MOTION
+  httpd_simple_register_post_handler(&wom_threshold_handler);
+  httpd_simple_register_post_handler(&wom_window_handler);
+  httpd_simple_register_post_handler(&pretrigger_depth_handler);
+#endif
 
 #if CC26XX_WEB_DEMO_READ_PARENT_RSSI
   httpd_simple_register_post_handler(&ping_interval_handler);
@@ -720,9 +1515,32 @@ PROCESS_THREAD(cc26xx_web_demo_process, ev, data)
     } else if(ev == httpd_simple_event_new_config) {
       save_config();
     } else if(ev == sensors_event && data == &mpu_9250_sensor) {
-      get_mpu_reading();
+#if CC26XX_WEB_DEMO_WAKE_ON_MOTION
+      /* Outside of a window, a freshly powered MPU waits for motion */
+      if(wom_state != WOM_STATE_SAMPLING) {
+        arm_wake_on_motion();
+      } else {
+        start_mpu_sampling();
+      }
+#else
+      start_mpu_sampling();
+#endif
+#if CC26XX_WEB_DEMO_WAKE_ON_MOTION
+    } else if(ev == PROCESS_EVENT_POLL ||
+              (ev == sensors_event &&
+               data == CC26XX_WEB_DEMO_MQTT_PUBLISH_TRIGGER)) {
+      /* Polled by the motion interrupt. The publish trigger works too */
+      motion_started();
+#endif
     }
 
+#if CC26XX_WEB_DEMO_DOOR_EVENTS
+    /* Also seen above when the reed relay is the publish trigger */
+    if(ev == sensors_event && data == &reed_relay_sensor) {
+      door_reed_changed();
+    }
+#endif
+
     PROCESS_YIELD();
   }
 
@@ -52,6 +52,7 @@
 #include "dev/leds.h"
 #include "sys/process.h"
 #include "mqtt-client.h"
+#include "pretrigger.h"
 
 #include <stdint.h>
 /*---------------------------------------------------------------------------*/
@@ -67,6 +68,75 @@
 #define CC26XX_WEB_DEMO_6LBR_CLIENT 1
 #endif
 
+/*
+ * Keep the rtimer in step with UTC over SNTP, for wall-clock timestamps.
+ * Needs an SNTP server on the border router or at a configured address
+ */
+#ifdef CC26XX_WEB_DEMO_CONF_SNTP_CLIENT
+#define CC26XX_WEB_DEMO_SNTP_CLIENT CC26XX_WEB_DEMO_CONF_SNTP_CLIENT
+#else
+#define CC26XX_WEB_DEMO_SNTP_CLIENT 0
+#endif
+
+/*
+ * MQTT-SN over UDP as an alternative transport for the MQTT client. Costs
+ * the RAM of a packet buffer and a topic table. See mqtt-sn.h
+ */
+#ifdef CC26XX_WEB_DEMO_CONF_MQTT_SN
+#define CC26XX_WEB_DEMO_MQTT_SN CC26XX_WEB_DEMO_CONF_MQTT_SN
+#else
+#define CC26XX_WEB_DEMO_MQTT_SN 0
+#endif
+
+/*
+ * MPU acquisition mode. 0: power the MPU up, read and power down for every
+ * sample. 1: leave the MPU sampling into its FIFO and drain it in bursts
+ */
+#ifdef CC26XX_WEB_DEMO_CONF_MPU_FIFO
+#define CC26XX_WEB_DEMO_MPU_FIFO CC26XX_WEB_DEMO_CONF_MPU_FIFO
+#else
+#define CC26XX_WEB_DEMO_MPU_FIFO 0
+#endif
+
+/*
+ * Wake-on-motion. Between events the MPU sits in low-power accelerometer
+ * cycle mode. Motion raises its interrupt, which starts a window of
+ * full-rate sampling. Nothing gets published while the node is still
+ */
+#ifdef CC26XX_WEB_DEMO_CONF_WAKE_ON_MOTION
+#define CC26XX_WEB_DEMO_WAKE_ON_MOTION CC26XX_WEB_DEMO_CONF_WAKE_ON_MOTION
+#else
+#define CC26XX_WEB_DEMO_WAKE_ON_MOTION 0
+#endif
+
+/*
+ * Door events. The reed relay and the gyro Z integral are fused on the node
+ * into open / close / ajar events, which are published as soon as they
+ * happen. Motion windows are then only published on request
+ */
+#ifdef CC26XX_WEB_DEMO_CONF_DOOR_EVENTS
+#define CC26XX_WEB_DEMO_DOOR_EVENTS CC26XX_WEB_DEMO_CONF_DOOR_EVENTS
+#else
+#define CC26XX_WEB_DEMO_DOOR_EVENTS 0
+#endif
+
+/* The reed relay reading when the magnet is in place, i.e. the door is shut */
+#ifdef CC26XX_WEB_DEMO_CONF_DOOR_REED_CLOSED
+#define CC26XX_WEB_DEMO_DOOR_REED_CLOSED CC26XX_WEB_DEMO_CONF_DOOR_REED_CLOSED
+#else
+#define CC26XX_WEB_DEMO_DOOR_REED_CLOSED 1
+#endif
+
+/*
+ * Spool motion publishes to external flash while the broker is unreachable
+ * and replay them once it is back. Takes over 64 KB of the external flash
+ */
+#ifdef CC26XX_WEB_DEMO_CONF_PUBLISH_SPOOL
+#define CC26XX_WEB_DEMO_PUBLISH_SPOOL CC26XX_WEB_DEMO_CONF_PUBLISH_SPOOL
+#else
+#define CC26XX_WEB_DEMO_PUBLISH_SPOOL 0
+#endif
+
 /*---------------------------------------------------------------------------*/
 /* Active probing of RSSI from our preferred parent */
 #if (CC26XX_WEB_DEMO_COAP_SERVER || CC26XX_WEB_DEMO_MQTT_CLIENT)
@@ -77,6 +147,44 @@
 
 #define CC26XX_WEB_DEMO_RSSI_MEASURE_INTERVAL_MAX 86400 /* secs: 1 day */
 #define CC26XX_WEB_DEMO_RSSI_MEASURE_INTERVAL_MIN     5 /* secs */
+
+/* Motion sample rate limits, in Hz */
+#if CC26XX_WEB_DEMO_MPU_FIFO
+#define CC26XX_WEB_DEMO_SAMPLE_RATE_MIN               4 /* MPU rate divider */
+#define CC26XX_WEB_DEMO_SAMPLE_RATE_MAX            1000
+#else
+/* Polled samples power-cycle the MPU each time, so they can't go fast */
+#define CC26XX_WEB_DEMO_SAMPLE_RATE_MIN               1
+#define CC26XX_WEB_DEMO_SAMPLE_RATE_MAX              25
+#endif
+
+/*
+ * Adaptive sample rate: the activity threshold in hundredths of a G squared
+ * (0 keeps the rate fixed). The rate bounds use the sample rate limits
+ */
+#define CC26XX_WEB_DEMO_ACTIVITY_THRESHOLD_MIN        0
+#define CC26XX_WEB_DEMO_ACTIVITY_THRESHOLD_MAX    65535
+
+/*
+ * Report by exception: per-sensor deadband, in the raw units of the reading
+ * (hundredths of a G or deg/s for the MPU). 0 reports every sample
+ */
+#define CC26XX_WEB_DEMO_DEADBAND_MIN                  0
+#define CC26XX_WEB_DEMO_DEADBAND_MAX              10000
+
+/* Wake-on-motion threshold (mg, 4 mg steps) and post-trigger window (secs) */
+#define CC26XX_WEB_DEMO_WOM_THRESHOLD_MIN             4
+#define CC26XX_WEB_DEMO_WOM_THRESHOLD_MAX          1020
+#define CC26XX_WEB_DEMO_WOM_WINDOW_MIN                1
+#define CC26XX_WEB_DEMO_WOM_WINDOW_MAX              600
+
+/*
+ * Pre-trigger depth limits in frames, and the rate at which the pre-trigger
+ * ring is filled while waiting for motion (about the MPU low-power rate)
+ */
+#define CC26XX_WEB_DEMO_PRETRIGGER_DEPTH_MIN          0
+#define CC26XX_WEB_DEMO_PRETRIGGER_DEPTH_MAX PRETRIGGER_MAX_DEPTH
+#define CC26XX_WEB_DEMO_PRETRIGGER_RATE               8 /* Hz */
 /*---------------------------------------------------------------------------*/
 /* User configuration */
 /* Take a sensor reading on button press */
@@ -108,8 +216,26 @@
 #define CC26XX_WEB_DEMO_DEFAULT_SUBSCRIBE_CMD_TYPE  "+" 
 #define CC26XX_WEB_DEMO_DEFAULT_BROKER_PORT         1883
 #define CC26XX_WEB_DEMO_DEFAULT_PUBLISH_INTERVAL    (10 * CLOCK_SECOND)
+#define CC26XX_WEB_DEMO_DEFAULT_PAYLOAD_FORMAT      MQTT_CLIENT_PAYLOAD_FORMAT_JSON
+#define CC26XX_WEB_DEMO_DEFAULT_QOS                 0
+#define CC26XX_WEB_DEMO_DEFAULT_TRANSPORT           MQTT_CLIENT_TRANSPORT_TCP
+#define CC26XX_WEB_DEMO_DEFAULT_PUBLISH_MODE        MQTT_CLIENT_PUBLISH_MODE_RAW
 #define CC26XX_WEB_DEMO_DEFAULT_KEEP_ALIVE_TIMER    60
 #define CC26XX_WEB_DEMO_DEFAULT_RSSI_MEAS_INTERVAL  (CLOCK_SECOND * 30)
+#define CC26XX_WEB_DEMO_DEFAULT_BATCH_SIZE          15 /* frames per publish */
+#if CC26XX_WEB_DEMO_MPU_FIFO
+#define CC26XX_WEB_DEMO_DEFAULT_SAMPLE_RATE         10 /* Hz */
+#define CC26XX_WEB_DEMO_DEFAULT_RATE_CEILING       100 /* Hz */
+#else
+#define CC26XX_WEB_DEMO_DEFAULT_SAMPLE_RATE          2 /* Hz */
+#define CC26XX_WEB_DEMO_DEFAULT_RATE_CEILING        10 /* Hz */
+#endif
+#define CC26XX_WEB_DEMO_DEFAULT_RATE_FLOOR   CC26XX_WEB_DEMO_SAMPLE_RATE_MIN
+#define CC26XX_WEB_DEMO_DEFAULT_ACTIVITY_THRESHOLD   0 /* Off */
+#define CC26XX_WEB_DEMO_DEFAULT_DEADBAND             0 /* Report everything */
+#define CC26XX_WEB_DEMO_DEFAULT_WOM_THRESHOLD      100 /* mg */
+#define CC26XX_WEB_DEMO_DEFAULT_WOM_WINDOW          10 /* secs */
+#define CC26XX_WEB_DEMO_DEFAULT_PRETRIGGER_DEPTH     8 /* frames */
 #define cc26XX_WEB_DEMO_DEFAULT_AUTH_TOKEN          "-aFwa5nvKl0d@w_JcZ"
 /*---------------------------------------------------------------------------*/
 /*
@@ -133,10 +259,20 @@
 #define CC26XX_WEB_DEMO_SENSOR_MPU_GYRO_X    12
 #define CC26XX_WEB_DEMO_SENSOR_MPU_GYRO_Y    13
 #define CC26XX_WEB_DEMO_SENSOR_MPU_GYRO_Z    14
+#define CC26XX_WEB_DEMO_SENSOR_COUNT         15
 /*---------------------------------------------------------------------------*/
 extern process_event_t cc26xx_web_demo_publish_event;
 extern process_event_t cc26xx_web_demo_config_loaded_event;
 extern process_event_t cc26xx_web_demo_load_config_defaults;
+
+/* Posted when new frames have been added to the motion buffer */
+extern process_event_t append_motion_sensor_event;
+
+/* Posted when a wake-on-motion sampling window has closed */
+extern process_event_t motion_window_end_event;
+
+/* Posted with a door_detector_event_t when the door changes state */
+extern process_event_t door_event;
 /*---------------------------------------------------------------------------*/
 #define CC26XX_WEB_DEMO_UNIT_TEMP     "C"
 #define CC26XX_WEB_DEMO_UNIT_VOLT     "mV"
@@ -148,9 +284,6 @@ extern process_event_t cc26xx_web_demo_load_config_defaults;
 /*---------------------------------------------------------------------------*/
 
 #define CC26XX_WEB_DEMO_CONVERTED_LEN        12
-#define DATA_RES                             10 //numbers of char needed for each sensor reading
-#define NUM_DATA_PER_PUB                     15 //number of readings for each MQTT publish
-
 
 /* A data type for sensor readings, internally stored in a linked list */
 typedef struct cc26xx_web_demo_sensor_reading {
@@ -173,23 +306,19 @@ typedef struct cc26xx_web_demo_config_s {
   int len;
   uint32_t sensors_bitmap;
   int def_rt_ping_interval;
+  uint16_t sample_rate;
+  uint16_t rate_floor;
+  uint16_t rate_ceiling;
+  uint16_t activity_threshold;
+  uint16_t deadband[CC26XX_WEB_DEMO_SENSOR_COUNT];
+  uint16_t wom_threshold;
+  uint16_t wom_window;
+  uint16_t pretrigger_depth;
   mqtt_client_config_t mqtt_config;
   // net_uart_config_t net_uart;
 } cc26xx_web_demo_config_t;
 
-typedef struct motion_sensor_data{
-  char acc_x[NUM_DATA_PER_PUB][DATA_RES];
-  char acc_y[NUM_DATA_PER_PUB][DATA_RES];
-  char acc_z[NUM_DATA_PER_PUB][DATA_RES];
-  char gyro_x[NUM_DATA_PER_PUB][DATA_RES];
-  char gyro_y[NUM_DATA_PER_PUB][DATA_RES];
-  char gyro_z[NUM_DATA_PER_PUB][DATA_RES];
-  int size; 
-} motion_sensor_data_t;
-
 extern cc26xx_web_demo_config_t cc26xx_web_demo_config;
-extern motion_sensor_data_t motion_sensor_arr;
-extern const motion_sensor_data_t empty_motion_arr;
 /*---------------------------------------------------------------------------*/
 /**
  * \brief Performs a lookup for a reading of a specific type of sensor
@@ -198,6 +327,13 @@ extern const motion_sensor_data_t empty_motion_arr;
  */
 const cc26xx_web_demo_sensor_reading_t *cc26xx_web_demo_sensor_lookup(int sens_type);
 
+/**
+ * \brief Tells whether a sensor is present and its reading gets published
+ * \param sens_type CC26XX_WEB_DEMO_SENSOR_BATMON_TEMP...
+ * \return 1 if so, 0 otherwise
+ */
+int cc26xx_web_demo_sensor_enabled(int sens_type);
+
 /**
  * \brief Returns the first available sensor reading
  * \return A pointer to the reading data structure or NULL
@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \addtogroup cc26xx-web-demo
+ * @{
+ *
+ * \file
+ *   Hot-path timing statistics, based on the Cortex-M DWT cycle counter or on
+ *   the rtimer
+ */
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+#include "cycle-stats.h"
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+#if CYCLE_STATS_DWT
+/* Cortex-M debug registers. The cycle counter needs trace enabled */
+#define DEMCR        (*(volatile uint32_t *)0xE000EDFC)
+#define DEMCR_TRCENA (1UL << 24)
+#define DWT_CTRL     (*(volatile uint32_t *)0xE0001000)
+#define DWT_CYCCNT   (*(volatile uint32_t *)0xE0001004)
+#define DWT_CYCCNTENA (1UL << 0)
+#endif
+/*---------------------------------------------------------------------------*/
+static cycle_stats_site_t sites[CYCLE_STATS_SITES];
+
+static const char *const site_names[CYCLE_STATS_SITES] = {
+  "mpu", "ser", "pub", "http", "fft",
+};
+/*---------------------------------------------------------------------------*/
+void
+cycle_stats_init(void)
+{
+#if CYCLE_STATS_DWT
+  DEMCR |= DEMCR_TRCENA;
+  DWT_CYCCNT = 0;
+  DWT_CTRL |= DWT_CYCCNTENA;
+#endif
+
+  cycle_stats_reset();
+}
+/*---------------------------------------------------------------------------*/
+uint32_t
+cycle_stats_now(void)
+{
+#if CYCLE_STATS_DWT
+  return DWT_CYCCNT;
+#else
+  return (uint32_t)RTIMER_NOW();
+#endif
+}
+/*---------------------------------------------------------------------------*/
+void
+cycle_stats_record(uint8_t site, uint32_t elapsed)
+{
+  cycle_stats_site_t *s;
+  uint32_t limit = 1UL << CYCLE_STATS_BUCKET_SHIFT;
+  uint8_t b;
+
+  if(site >= CYCLE_STATS_SITES) {
+    return;
+  }
+
+  s = &sites[site];
+
+  if(s->count == 0 || elapsed < s->min) {
+    s->min = elapsed;
+  }
+  if(elapsed > s->max) {
+    s->max = elapsed;
+  }
+  s->sum += elapsed;
+  s->count++;
+
+  for(b = 0; b < CYCLE_STATS_BUCKETS - 1 && elapsed >= limit; b++) {
+    limit <<= 2;
+  }
+
+  if(s->buckets[b] < 0xFFFF) {
+    s->buckets[b]++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+const cycle_stats_site_t *
+cycle_stats_get(uint8_t site)
+{
+  if(site >= CYCLE_STATS_SITES) {
+    return NULL;
+  }
+
+  return &sites[site];
+}
+/*---------------------------------------------------------------------------*/
+uint32_t
+cycle_stats_mean(uint8_t site)
+{
+  if(site >= CYCLE_STATS_SITES || sites[site].count == 0) {
+    return 0;
+  }
+
+  return (uint32_t)(sites[site].sum / sites[site].count);
+}
+/*---------------------------------------------------------------------------*/
+const char *
+cycle_stats_name(uint8_t site)
+{
+  if(site >= CYCLE_STATS_SITES) {
+    return "?";
+  }
+
+  return site_names[site];
+}
+/*---------------------------------------------------------------------------*/
+void
+cycle_stats_reset(void)
+{
+  memset(sites, 0, sizeof(sites));
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * @}
+ */
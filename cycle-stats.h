@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \addtogroup cc26xx-web-demo
+ * @{
+ *
+ * \file
+ *   Header file for the hot-path timing statistics of the CC26XX web demo.
+ *
+ *   Instrumented code sections (sites) record how long each run took, in CPU
+ *   cycles as counted by the Cortex-M DWT, or in rtimer ticks on native
+ *   builds. Each site keeps its run count, min, max, mean and a coarse
+ *   histogram.
+ */
+/*---------------------------------------------------------------------------*/
+#ifndef CYCLE_STATS_H_
+#define CYCLE_STATS_H_
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+
+#include <stdint.h>
+/*---------------------------------------------------------------------------*/
+#ifdef CYCLE_STATS_CONF_ENABLED
+#define CYCLE_STATS_ENABLED CYCLE_STATS_CONF_ENABLED
+#else
+#define CYCLE_STATS_ENABLED 1
+#endif
+
+/* Time source: the DWT cycle counter unless told otherwise */
+#ifdef CYCLE_STATS_CONF_DWT
+#define CYCLE_STATS_DWT CYCLE_STATS_CONF_DWT
+#elif CONTIKI_TARGET_NATIVE
+#define CYCLE_STATS_DWT 0
+#else
+#define CYCLE_STATS_DWT 1
+#endif
+
+#if CYCLE_STATS_DWT
+#define CYCLE_STATS_UNIT "cycles"
+#else
+#define CYCLE_STATS_UNIT "rtimer ticks"
+#endif
+/*---------------------------------------------------------------------------*/
+/* Instrumented sites */
+#define CYCLE_STATS_SITE_MPU_READ     0 /* One MPU poll or FIFO drain */
+#define CYCLE_STATS_SITE_SERIALIZE    1 /* Encoding one motion window */
+#define CYCLE_STATS_SITE_PUBLISH      2 /* publishAccReadings(), all of it */
+#define CYCLE_STATS_SITE_HTTPD_PAGE   3 /* One resumption of a page generator */
+#define CYCLE_STATS_SITE_FFT          4 /* The FFT of one axis */
+#define CYCLE_STATS_SITES             5
+
+/*
+ * Histogram buckets. Bucket 0 counts runs shorter than
+ * 1 << CYCLE_STATS_BUCKET_SHIFT, each following bucket covers a range
+ * four times wider and the last one takes everything above
+ */
+#define CYCLE_STATS_BUCKETS           8
+#define CYCLE_STATS_BUCKET_SHIFT      8
+/*---------------------------------------------------------------------------*/
+typedef struct cycle_stats_site {
+  uint64_t sum;
+  uint32_t count;
+  uint32_t min;
+  uint32_t max;
+  uint16_t buckets[CYCLE_STATS_BUCKETS]; /* Saturate at 0xFFFF */
+} cycle_stats_site_t;
+/*---------------------------------------------------------------------------*/
+#if CYCLE_STATS_ENABLED
+/**
+ * \brief Starts timing a site
+ * \param t A uint32_t that holds the start time until CYCLE_STATS_STOP
+ */
+#define CYCLE_STATS_START(t) (t) = cycle_stats_now()
+
+/**
+ * \brief Stops timing a site and records the run
+ * \param site CYCLE_STATS_SITE_MPU_READ...
+ * \param t The variable passed to CYCLE_STATS_START
+ */
+#define CYCLE_STATS_STOP(site, t) \
+  cycle_stats_record((site), cycle_stats_now() - (t))
+#else
+#define CYCLE_STATS_START(t) ((t) = 0)
+#define CYCLE_STATS_STOP(site, t) ((void)(t))
+#endif
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief Starts the time source and clears all statistics
+ */
+void cycle_stats_init(void);
+
+/**
+ * \brief Returns the current value of the time source
+ *
+ * Differences between two values are valid across a single wrap
+ */
+uint32_t cycle_stats_now(void);
+
+/**
+ * \brief Adds a run to a site's statistics
+ * \param site CYCLE_STATS_SITE_MPU_READ...
+ * \param elapsed The duration of the run in CYCLE_STATS_UNIT
+ */
+void cycle_stats_record(uint8_t site, uint32_t elapsed);
+
+/**
+ * \brief Returns the statistics of a site
+ * \param site CYCLE_STATS_SITE_MPU_READ...
+ * \return A pointer to the statistics or NULL if site is out of range
+ */
+const cycle_stats_site_t *cycle_stats_get(uint8_t site);
+
+/**
+ * \brief Returns the mean run time of a site, 0 if it never ran
+ */
+uint32_t cycle_stats_mean(uint8_t site);
+
+/**
+ * \brief Returns the short name of a site (e.g. "mpu")
+ */
+const char *cycle_stats_name(uint8_t site);
+
+/**
+ * \brief Clears the statistics of all sites
+ */
+void cycle_stats_reset(void);
+/*---------------------------------------------------------------------------*/
+#endif /* CYCLE_STATS_H_ */
+/*---------------------------------------------------------------------------*/
+/**
+ * @}
+ */
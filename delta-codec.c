@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \addtogroup cc26xx-web-demo
+ * @{
+ *
+ * \file
+ *   Delta + zigzag varint encoder for motion axis windows
+ */
+/*---------------------------------------------------------------------------*/
+#include "delta-codec.h"
+
+#include <stdint.h>
+/*---------------------------------------------------------------------------*/
+void
+delta_codec_init(delta_codec_t *c, uint8_t *buf, uint16_t size)
+{
+  c->buf = buf;
+  c->size = size;
+  c->pos = 0;
+  c->prev = 0;
+  c->overflow = 0;
+}
+/*---------------------------------------------------------------------------*/
+void
+delta_codec_put(delta_codec_t *c, int16_t value)
+{
+  int32_t delta = (int32_t)value - c->prev;
+  uint32_t zz = ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31);
+
+  c->prev = value;
+
+  do {
+    if(c->pos >= c->size) {
+      c->overflow = 1;
+      return;
+    }
+    c->buf[c->pos++] = (zz & 0x7F) | (zz > 0x7F ? 0x80 : 0);
+    zz >>= 7;
+  } while(zz != 0);
+}
+/*---------------------------------------------------------------------------*/
+int
+delta_codec_len(const delta_codec_t *c)
+{
+  return c->overflow ? -1 : c->pos;
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * @}
+ */
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \addtogroup cc26xx-web-demo
+ * @{
+ *
+ * \file
+ *   Header file for the delta + zigzag varint codec used to compress motion
+ *   axis windows.
+ *
+ *   Each value is encoded as the difference from the previous one (the first
+ *   against 0). Differences are zigzag-mapped so that small negative numbers
+ *   stay small (0, -1, 1, -2... become 0, 1, 2, 3...) and then written as
+ *   little-endian base-128 varints, 7 bits per byte, MSB set on all but the
+ *   last byte. A still sensor therefore costs one byte per sample.
+ */
+/*---------------------------------------------------------------------------*/
+#ifndef DELTA_CODEC_H_
+#define DELTA_CODEC_H_
+/*---------------------------------------------------------------------------*/
+#include <stdint.h>
+/*---------------------------------------------------------------------------*/
+/* Worst case: a 17-bit zigzagged int16 delta takes 3 varint bytes */
+#define DELTA_CODEC_MAX_BYTES_PER_VALUE 3
+/*---------------------------------------------------------------------------*/
+typedef struct delta_codec {
+  uint8_t *buf;
+  uint16_t size;
+  uint16_t pos;
+  int16_t prev;
+  uint8_t overflow;
+} delta_codec_t;
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief Prepares an encoder to output into buf
+ * \param c A pointer to the encoder
+ * \param buf The output buffer
+ * \param size The size of buf in bytes
+ */
+void delta_codec_init(delta_codec_t *c, uint8_t *buf, uint16_t size);
+
+/**
+ * \brief Encodes the next value of the sequence
+ * \param c A pointer to the encoder
+ * \param value The value
+ */
+void delta_codec_put(delta_codec_t *c, int16_t value);
+
+/**
+ * \brief Returns the number of bytes written so far
+ * \return The length, or -1 if the buffer overflowed
+ */
+int delta_codec_len(const delta_codec_t *c);
+/*---------------------------------------------------------------------------*/
+#endif /* DELTA_CODEC_H_ */
+/*---------------------------------------------------------------------------*/
+/**
+ * @}
+ */
@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \addtogroup cc26xx-web-demo
+ * @{
+ *
+ * \file
+ *   Door state detector: reed relay edges fused with the gyro Z integral
+ */
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+#include "door-detector.h"
+#include "motion-buffer.h"
+
+#include <stdint.h>
+/*---------------------------------------------------------------------------*/
+/*
+ * The angle is kept in hundredths of a deg/s times ms, i.e. 1e-5 degrees.
+ * That leaves room for a few thousand degrees of drift
+ */
+#define ANGLE_SCALE          100000L
+#define OPEN_SWING           ((int32_t)DOOR_DETECTOR_OPEN_ANGLE * ANGLE_SCALE)
+
+/* Longest gap between two frames that still counts as continuous rotation */
+#define MAX_STEP_MS          1000
+
+/* DOOR_DETECTOR_AJAR_TIME in frame timestamp ticks */
+#define AJAR_TICKS \
+  ((uint32_t)((uint64_t)DOOR_DETECTOR_AJAR_TIME * MOTION_FRAME_SECOND / \
+              CLOCK_SECOND))
+/*---------------------------------------------------------------------------*/
+/* Times are frame timestamps, so that reed edges and frames compare */
+static uint8_t state;
+static uint32_t unlatched;  /* When the reed relay opened */
+static uint32_t last_frame; /* Timestamp of the last integrated frame */
+static int32_t swing;           /* Signed angle since unlatching */
+static int32_t peak;            /* Largest |swing| since unlatching */
+
+static const char *const state_names[] = {
+  "close", "open", "ajar", "unlatched",
+};
+/*---------------------------------------------------------------------------*/
+static int
+report(uint8_t new_state, uint32_t now, door_detector_event_t *ev)
+{
+  state = new_state;
+
+  ev->state = new_state;
+  ev->timestamp = now;
+  ev->duration = (uint32_t)((uint64_t)(now - unlatched) * 1000 /
+                            MOTION_FRAME_SECOND);
+  ev->angle = (int16_t)(peak / ANGLE_SCALE);
+
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+void
+door_detector_init(uint8_t closed)
+{
+  /* An open door at boot is as good as classified. Wait for it to close */
+  state = closed ? DOOR_DETECTOR_CLOSED : DOOR_DETECTOR_OPEN;
+  unlatched = MOTION_FRAME_NOW();
+  last_frame = unlatched;
+  swing = 0;
+  peak = 0;
+}
+/*---------------------------------------------------------------------------*/
+int
+door_detector_reed(uint8_t closed, uint8_t gyro, door_detector_event_t *ev)
+{
+  uint32_t now = MOTION_FRAME_NOW();
+
+  if(closed) {
+    if(state == DOOR_DETECTOR_CLOSED) {
+      return 0;
+    }
+    return report(DOOR_DETECTOR_CLOSED, now, ev);
+  }
+
+  if(state != DOOR_DETECTOR_CLOSED) {
+    /* Contact bounce */
+    return 0;
+  }
+
+  unlatched = now;
+  last_frame = now;
+  swing = 0;
+  peak = 0;
+
+  if(!gyro) {
+    /* Nothing to tell open from ajar. Don't keep the door waiting */
+    return report(DOOR_DETECTOR_OPEN, now, ev);
+  }
+
+  state = DOOR_DETECTOR_UNLATCHED;
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+int
+door_detector_frame(const motion_frame_t *frame, door_detector_event_t *ev)
+{
+  int32_t rate = frame->axis[MOTION_BUFFER_AXIS_GYRO_Z];
+  uint32_t step;
+
+  if(state == DOOR_DETECTOR_CLOSED ||
+     (int32_t)(frame->timestamp - last_frame) < 0) {
+    /* Nothing to track, or sampled before the last frame */
+    return 0;
+  }
+
+  step = (uint32_t)((uint64_t)(frame->timestamp - last_frame) * 1000 /
+                    MOTION_FRAME_SECOND);
+  if(step > MAX_STEP_MS) {
+    step = MAX_STEP_MS;
+  }
+  last_frame = frame->timestamp;
+
+  if(rate > DOOR_DETECTOR_GYRO_DEADBAND || rate < -DOOR_DETECTOR_GYRO_DEADBAND) {
+    swing += rate * (int32_t)step;
+  }
+
+  if(swing > peak) {
+    peak = swing;
+  } else if(-swing > peak) {
+    peak = -swing;
+  }
+
+  /* An open door keeps being tracked, so that closing reports the peak */
+  if(state == DOOR_DETECTOR_OPEN) {
+    return 0;
+  }
+
+  if(peak >= OPEN_SWING) {
+    return report(DOOR_DETECTOR_OPEN, frame->timestamp, ev);
+  }
+
+  if(state == DOOR_DETECTOR_UNLATCHED &&
+     frame->timestamp - unlatched >= AJAR_TICKS) {
+    return report(DOOR_DETECTOR_AJAR, frame->timestamp, ev);
+  }
+
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+uint8_t
+door_detector_state(void)
+{
+  return state;
+}
+/*---------------------------------------------------------------------------*/
+const char *
+door_detector_state_name(uint8_t s)
+{
+  if(s >= sizeof(state_names) / sizeof(state_names[0])) {
+    return "?";
+  }
+
+  return state_names[s];
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * @}
+ */
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \addtogroup cc26xx-web-demo
+ * @{
+ *
+ * \file
+ *   Header file for the door state detector.
+ *
+ *   The reed relay says whether the door is shut. While it is not, the gyro
+ *   Z rate is integrated into the swing angle of the door, which tells a door
+ *   that was opened from one that was merely left ajar. The detector is fed
+ *   reed edges and motion frames and returns an event when the state of the
+ *   door changes.
+ */
+/*---------------------------------------------------------------------------*/
+#ifndef DOOR_DETECTOR_H_
+#define DOOR_DETECTOR_H_
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+#include "motion-buffer.h"
+
+#include <stdint.h>
+/*---------------------------------------------------------------------------*/
+/* A swing of this many degrees means the door is open, not ajar */
+#ifdef DOOR_DETECTOR_CONF_OPEN_ANGLE
+#define DOOR_DETECTOR_OPEN_ANGLE DOOR_DETECTOR_CONF_OPEN_ANGLE
+#else
+#define DOOR_DETECTOR_OPEN_ANGLE          30
+#endif
+
+/* A door that hasn't swung open this long after unlatching is ajar */
+#ifdef DOOR_DETECTOR_CONF_AJAR_TIME
+#define DOOR_DETECTOR_AJAR_TIME DOOR_DETECTOR_CONF_AJAR_TIME
+#else
+#define DOOR_DETECTOR_AJAR_TIME           (CLOCK_SECOND * 2)
+#endif
+
+/* Gyro Z rates below this, in hundredths of a deg/s, are taken as bias */
+#ifdef DOOR_DETECTOR_CONF_GYRO_DEADBAND
+#define DOOR_DETECTOR_GYRO_DEADBAND DOOR_DETECTOR_CONF_GYRO_DEADBAND
+#else
+#define DOOR_DETECTOR_GYRO_DEADBAND       200
+#endif
+/*---------------------------------------------------------------------------*/
+/* Door states, which are also the event types */
+#define DOOR_DETECTOR_CLOSED              0
+#define DOOR_DETECTOR_OPEN                1
+#define DOOR_DETECTOR_AJAR                2
+#define DOOR_DETECTOR_UNLATCHED           3 /* Not classified yet. No event */
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief A change in the state of the door
+ */
+typedef struct door_detector_event {
+  uint32_t timestamp; /* MOTION_FRAME_NOW() at the change */
+  uint32_t duration; /* ms since the door unlatched */
+  int16_t angle;     /* Largest swing so far since unlatching, in degrees */
+  uint8_t state;     /* DOOR_DETECTOR_CLOSED, _OPEN or _AJAR */
+} door_detector_event_t;
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief Resets the detector
+ * \param closed The current state of the reed relay
+ */
+void door_detector_init(uint8_t closed);
+
+/**
+ * \brief Feeds an edge of the reed relay
+ * \param closed The new state of the reed relay
+ * \param gyro Whether gyro Z frames will follow. Without them, an opening
+ *        door is reported as open straight away
+ * \param ev Receives the event, if any
+ * \return 1 if ev was filled in
+ */
+int door_detector_reed(uint8_t closed, uint8_t gyro, door_detector_event_t *ev);
+
+/**
+ * \brief Feeds a motion frame
+ * \param frame The frame. Frames older than the last one are ignored
+ * \param ev Receives the event, if any
+ * \return 1 if ev was filled in
+ */
+int door_detector_frame(const motion_frame_t *frame, door_detector_event_t *ev);
+
+/**
+ * \brief Returns the current state of the door, DOOR_DETECTOR_xyz
+ */
+uint8_t door_detector_state(void);
+
+/**
+ * \brief Returns the name of a door state
+ */
+const char *door_detector_state_name(uint8_t state);
+/*---------------------------------------------------------------------------*/
+#endif /* DOOR_DETECTOR_H_ */
+/*---------------------------------------------------------------------------*/
+/**
+ * @}
+ */
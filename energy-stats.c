@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \addtogroup cc26xx-web-demo
+ * @{
+ *
+ * \file
+ *   Per-period energy accounting based on energest
+ */
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+#include "sys/energest.h"
+#include "energy-stats.h"
+
+#include <stdint.h>
+/*---------------------------------------------------------------------------*/
+#if ENERGY_STATS_ENABLED
+/* Energest counter behind each accounted state */
+static const uint8_t energest_types[ENERGY_STATS_TYPES] = {
+  ENERGEST_TYPE_CPU, ENERGEST_TYPE_LPM, ENERGEST_TYPE_TRANSMIT,
+  ENERGEST_TYPE_LISTEN, ENERGEST_TYPE_SENSORS,
+};
+
+static unsigned long last[ENERGY_STATS_TYPES];
+#endif
+
+static uint32_t period_ms[ENERGY_STATS_TYPES];
+static uint32_t length_ms;
+static clock_time_t started;
+
+static const char *const names[ENERGY_STATS_TYPES] = {
+  "cpu", "lpm", "tx", "rx", "mpu",
+};
+/*---------------------------------------------------------------------------*/
+void
+energy_stats_init(void)
+{
+#if ENERGY_STATS_ENABLED
+  uint8_t i;
+
+  energest_flush();
+  for(i = 0; i < ENERGY_STATS_TYPES; i++) {
+    last[i] = energest_type_time(energest_types[i]);
+  }
+#endif
+
+  started = clock_time();
+}
+/*---------------------------------------------------------------------------*/
+void
+energy_stats_update(void)
+{
+#if ENERGY_STATS_ENABLED
+  unsigned long now;
+  uint8_t i;
+
+  /* Bring the counters of the states we are in up to date */
+  energest_flush();
+
+  for(i = 0; i < ENERGY_STATS_TYPES; i++) {
+    now = energest_type_time(energest_types[i]);
+    /* Counters wrap, but a period is much shorter than a wrap */
+    period_ms[i] = ((uint64_t)(now - last[i]) * 1000) / RTIMER_SECOND;
+    last[i] = now;
+  }
+#endif
+
+  length_ms = ((uint64_t)(clock_time() - started) * 1000) / CLOCK_SECOND;
+  started = clock_time();
+}
+/*---------------------------------------------------------------------------*/
+uint32_t
+energy_stats_period(void)
+{
+  return length_ms;
+}
+/*---------------------------------------------------------------------------*/
+uint32_t
+energy_stats_get(uint8_t type)
+{
+  if(type >= ENERGY_STATS_TYPES) {
+    return 0;
+  }
+
+  return period_ms[type];
+}
+/*---------------------------------------------------------------------------*/
+const char *
+energy_stats_name(uint8_t type)
+{
+  if(type >= ENERGY_STATS_TYPES) {
+    return "?";
+  }
+
+  return names[type];
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * @}
+ */
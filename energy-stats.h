@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \addtogroup cc26xx-web-demo
+ * @{
+ *
+ * \file
+ *   Header file for the energy accounting of the CC26XX web demo.
+ *
+ *   Turns the cumulative Contiki energest counters into the time spent in
+ *   each state (CPU active, LPM, radio TX and RX, MPU powered) during the last
+ *   reporting period. Needs ENERGEST_CONF_ON.
+ */
+/*---------------------------------------------------------------------------*/
+#ifndef ENERGY_STATS_H_
+#define ENERGY_STATS_H_
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+
+#include <stdint.h>
+/*---------------------------------------------------------------------------*/
+#if ENERGEST_CONF_ON
+#define ENERGY_STATS_ENABLED 1
+#else
+#define ENERGY_STATS_ENABLED 0
+#endif
+/*---------------------------------------------------------------------------*/
+/* Accounted states */
+#define ENERGY_STATS_CPU    0
+#define ENERGY_STATS_LPM    1
+#define ENERGY_STATS_TX     2
+#define ENERGY_STATS_RX     3
+#define ENERGY_STATS_MPU    4
+#define ENERGY_STATS_TYPES  5
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief Starts the first reporting period
+ */
+void energy_stats_init(void);
+
+/**
+ * \brief Closes the current reporting period and starts a new one
+ *
+ * The figures returned by energy_stats_period() and energy_stats_get() are
+ * those of the period closed by the last call
+ */
+void energy_stats_update(void);
+
+/**
+ * \brief Returns the length of the last reporting period in ms
+ */
+uint32_t energy_stats_period(void);
+
+/**
+ * \brief Returns the time spent in a state during the last period, in ms
+ * \param type ENERGY_STATS_CPU...
+ */
+uint32_t energy_stats_get(uint8_t type);
+
+/**
+ * \brief Returns the short name of a state (e.g. "cpu")
+ */
+const char *energy_stats_name(uint8_t type);
+/*---------------------------------------------------------------------------*/
+#endif /* ENERGY_STATS_H_ */
+/*---------------------------------------------------------------------------*/
+/**
+ * @}
+ */
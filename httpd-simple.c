@@ -44,6 +44,8 @@
 #include "lib/list.h"
 #include "cc26xx-web-demo.h"
 #include "mqtt-client.h"
+#include "cycle-stats.h"
+#include "energy-stats.h"
 
 #include <stdint.h>
 #include <string.h>
@@ -96,6 +98,20 @@ static int state;
 #define RSSI_INT_MIN STRINGIFY(CC26XX_WEB_DEMO_RSSI_MEASURE_INTERVAL_MIN)
 #define PUB_INT_MAX  STRINGIFY(MQTT_CLIENT_PUBLISH_INTERVAL_MAX)
 #define PUB_INT_MIN  STRINGIFY(MQTT_CLIENT_PUBLISH_INTERVAL_MIN)
+#define BATCH_MAX    STRINGIFY(MQTT_CLIENT_BATCH_SIZE_MAX)
+#define BATCH_MIN    STRINGIFY(MQTT_CLIENT_BATCH_SIZE_MIN)
+#define RATE_MAX     STRINGIFY(CC26XX_WEB_DEMO_SAMPLE_RATE_MAX)
+#define RATE_MIN     STRINGIFY(CC26XX_WEB_DEMO_SAMPLE_RATE_MIN)
+#define ACT_THR_MAX  STRINGIFY(CC26XX_WEB_DEMO_ACTIVITY_THRESHOLD_MAX)
+#define ACT_THR_MIN  STRINGIFY(CC26XX_WEB_DEMO_ACTIVITY_THRESHOLD_MIN)
+#define DEADBAND_MAX STRINGIFY(CC26XX_WEB_DEMO_DEADBAND_MAX)
+#define DEADBAND_MIN STRINGIFY(CC26XX_WEB_DEMO_DEADBAND_MIN)
+#define WOM_THR_MAX  STRINGIFY(CC26XX_WEB_DEMO_WOM_THRESHOLD_MAX)
+#define WOM_THR_MIN  STRINGIFY(CC26XX_WEB_DEMO_WOM_THRESHOLD_MIN)
+#define WOM_WIN_MAX  STRINGIFY(CC26XX_WEB_DEMO_WOM_WINDOW_MAX)
+#define WOM_WIN_MIN  STRINGIFY(CC26XX_WEB_DEMO_WOM_WINDOW_MIN)
+#define PRETRIG_MAX  STRINGIFY(CC26XX_WEB_DEMO_PRETRIGGER_DEPTH_MAX)
+#define PRETRIG_MIN  STRINGIFY(CC26XX_WEB_DEMO_PRETRIGGER_DEPTH_MIN)
 /*---------------------------------------------------------------------------*/
 /*
  * We can only handle a single POST request at a time. Since a second POST
@@ -236,6 +252,17 @@ static page_t http_mqtt_cfg_page = {
   generate_mqtt_config,
 };
 #endif
+
+#if CYCLE_STATS_ENABLED
+static char generate_stats(struct httpd_state *s);
+
+static page_t http_stats_page = {
+  NULL,
+  "stats.html",
+  "Stats",
+  generate_stats,
+};
+#endif
 /*---------------------------------------------------------------------------*/
 #define IBM_QUICKSTART_LINK_LEN 128
 static char http_mqtt_a[IBM_QUICKSTART_LINK_LEN];
@@ -258,6 +285,7 @@ struct httpd_state {
   const char **ptr;
   const cc26xx_web_demo_sensor_reading_t *reading;
   const page_t *page;
+  uint8_t site;
   uip_ds6_route_t *r;
   uip_ds6_nbr_t *nbr;
   httpd_simple_script_t script;
@@ -420,6 +448,14 @@ PT_THREAD(generate_top_matter(struct httpd_state *s, const char *title,
   PT_END(&s->top_matter_pt);
 }
 /*---------------------------------------------------------------------------*/
+#if ENERGY_STATS_ENABLED
+/* Share of the last energy reporting period spent in a state, in 1/1000 */
+#define ENERGY_PERMILLE(t) \
+  (energy_stats_period() ? \
+   (unsigned long)(((uint64_t)energy_stats_get(t) * 1000) / \
+                   energy_stats_period()) : 0UL)
+#endif
+
 static
 PT_THREAD(generate_index(struct httpd_state *s))
 {
@@ -508,6 +544,27 @@ PT_THREAD(generate_index(struct httpd_state *s))
   PT_WAIT_THREAD(&s->generate_pt,
                  enqueue_chunk(s, 0, CONTENT_CLOSE SECTION_CLOSE));
 
+#if ENERGY_STATS_ENABLED
+  /* Energy, over the last reporting period */
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, SECTION_OPEN "Energy" CONTENT_OPEN));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "Period = %lu ms",
+                               (unsigned long)energy_stats_period()));
+
+  for(s->site = 0; s->site < ENERGY_STATS_TYPES; s->site++) {
+    PT_WAIT_THREAD(&s->generate_pt,
+                   enqueue_chunk(s, 0, "\n%s = %lu ms (%lu.%lu%%)",
+                                 energy_stats_name(s->site),
+                                 (unsigned long)energy_stats_get(s->site),
+                                 ENERGY_PERMILLE(s->site) / 10,
+                                 ENERGY_PERMILLE(s->site) % 10));
+  }
+
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, CONTENT_CLOSE SECTION_CLOSE));
+#endif
+
   /* Footer */
   PT_WAIT_THREAD(&s->generate_pt, enqueue_chunk(s, 0, SECTION_OPEN));
   PT_WAIT_THREAD(&s->generate_pt, enqueue_chunk(s, 0, "Page hits: %u<br>",
@@ -562,12 +619,159 @@ PT_THREAD(generate_config(struct httpd_state *s))
     PT_WAIT_THREAD(&s->generate_pt,
                    enqueue_chunk(s, 0, "<input type=\"radio\" value=\"0\" "));
     PT_WAIT_THREAD(&s->generate_pt,
-                   enqueue_chunk(s, 0, "title=\"Off\" name=\"%s\"%s>%s",
+                   enqueue_chunk(s, 0, "title=\"Off\" name=\"%s\"%s>",
                                  s->reading->form_field,
-                                 s->reading->publish ? "" : " Checked",
-                                 config_div_close));
+                                 s->reading->publish ? "" : " Checked"));
+
+    /* Report by exception: changes within the deadband are not reported */
+    PT_WAIT_THREAD(&s->generate_pt,
+                   enqueue_chunk(s, 0, " Deadband <input type=\"number\" "));
+    PT_WAIT_THREAD(&s->generate_pt,
+                   enqueue_chunk(s, 0, "value=\"%u\" ",
+                                 cc26xx_web_demo_config.deadband[s->reading->type]));
+    PT_WAIT_THREAD(&s->generate_pt,
+                   enqueue_chunk(s, 0,
+                                 "min=\"" DEADBAND_MIN "\" "
+                                 "max=\"" DEADBAND_MAX "\" "
+                                 "name=\"%s_db\">%s",
+                                 s->reading->form_field, config_div_close));
   }
 
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0,
+                               "<input type=\"submit\" value=\"Submit\">"));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "</form>"));
+
+  /* Motion sampling */
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "<h1>Motion Sampling</h1>"));
+
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0,
+                               "<form name=\"input\" action=\"%s\" ",
+                               http_dev_cfg_page.filename));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "method=\"post\" enctype=\""));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "application/x-www-form-urlencoded\" "));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "accept-charset=\"UTF-8\">"));
+
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "%sRate (Hz):%s",
+                               config_div_left, config_div_close));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "%s<input type=\"number\" ",
+                               config_div_right));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "value=\"%u\" ",
+                               cc26xx_web_demo_config.sample_rate));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0,
+                               "min=\"" RATE_MIN "\" "
+                               "max=\"" RATE_MAX "\" "
+                               "name=\"sample_rate\">%s",
+                               config_div_close));
+
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "%sActivity (0.0001 G^2):%s",
+                               config_div_left, config_div_close));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "%s<input type=\"number\" ",
+                               config_div_right));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "value=\"%u\" ",
+                               cc26xx_web_demo_config.activity_threshold));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0,
+                               "min=\"" ACT_THR_MIN "\" "
+                               "max=\"" ACT_THR_MAX "\" "
+                               "name=\"activity_threshold\">%s",
+                               config_div_close));
+
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "%sRate Floor (Hz):%s",
+                               config_div_left, config_div_close));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "%s<input type=\"number\" ",
+                               config_div_right));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "value=\"%u\" ",
+                               cc26xx_web_demo_config.rate_floor));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0,
+                               "min=\"" RATE_MIN "\" "
+                               "max=\"" RATE_MAX "\" "
+                               "name=\"rate_floor\">%s",
+                               config_div_close));
+
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "%sRate Ceiling (Hz):%s",
+                               config_div_left, config_div_close));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "%s<input type=\"number\" ",
+                               config_div_right));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "value=\"%u\" ",
+                               cc26xx_web_demo_config.rate_ceiling));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0,
+                               "min=\"" RATE_MIN "\" "
+                               "max=\"" RATE_MAX "\" "
+                               "name=\"rate_ceiling\">%s",
+                               config_div_close));
+
+#if CC26XX_WEB_DEMO_WAKE_ON_MOTION
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "%sWake Threshold (mg):%s",
+                               config_div_left, config_div_close));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "%s<input type=\"number\" ",
+                               config_div_right));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "value=\"%u\" ",
+                               cc26xx_web_demo_config.wom_threshold));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0,
+                               "min=\"" WOM_THR_MIN "\" "
+                               "max=\"" WOM_THR_MAX "\" "
+                               "name=\"wom_threshold\">%s",
+                               config_div_close));
+
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "%sWindow (sec):%s",
+                               config_div_left, config_div_close));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "%s<input type=\"number\" ",
+                               config_div_right));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "value=\"%u\" ",
+                               cc26xx_web_demo_config.wom_window));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0,
+                               "min=\"" WOM_WIN_MIN "\" "
+                               "max=\"" WOM_WIN_MAX "\" "
+                               "name=\"wom_window\">%s",
+                               config_div_close));
+
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "%sPre-trigger (samples):%s",
+                               config_div_left, config_div_close));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "%s<input type=\"number\" ",
+                               config_div_right));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "value=\"%u\" ",
+                               cc26xx_web_demo_config.pretrigger_depth));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0,
+                               "min=\"" PRETRIG_MIN "\" "
+                               "max=\"" PRETRIG_MAX "\" "
+                               "name=\"pretrigger_depth\">%s",
+                               config_div_close));
+#endif
+
   PT_WAIT_THREAD(&s->generate_pt,
                  enqueue_chunk(s, 0,
                                "<input type=\"submit\" value=\"Submit\">"));
@@ -746,6 +950,133 @@ PT_THREAD(generate_mqtt_config(struct httpd_state *s))
                                "name=\"interval\">%s",
                                config_div_close));
 
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "%sBatch Size (samples):%s",
+                               config_div_left, config_div_close));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "%s<input type=\"number\" ",
+                               config_div_right));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "value=\"%u\" ",
+                               cc26xx_web_demo_config.mqtt_config.batch_size));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0,
+                               "min=\"" BATCH_MIN "\" "
+                               "max=\"" BATCH_MAX "\" "
+                               "name=\"batch_size\">%s",
+                               config_div_close));
+
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "%sQoS:%s%s", config_div_left,
+                               config_div_close, config_div_right));
+#if CC26XX_WEB_DEMO_MQTT_SN
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "<input type=\"radio\" value=\"-1\" "));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "title=\"-1 (MQTT-SN only)\" "
+                                     "name=\"qos\"%s>-1 ",
+                               cc26xx_web_demo_config.mqtt_config.qos < 0 ?
+                               " Checked" : ""));
+#endif
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "<input type=\"radio\" value=\"0\" "));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "title=\"0\" name=\"qos\"%s>0 ",
+                               cc26xx_web_demo_config.mqtt_config.qos == 0 ?
+                               " Checked" : ""));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "<input type=\"radio\" value=\"1\" "));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "title=\"1\" name=\"qos\"%s>1%s",
+                               cc26xx_web_demo_config.mqtt_config.qos > 0 ?
+                               " Checked" : "", config_div_close));
+
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "%sPayload Format:%s%s", config_div_left,
+                               config_div_close, config_div_right));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "<input type=\"radio\" value=\"%d\" ",
+                               MQTT_CLIENT_PAYLOAD_FORMAT_JSON));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "title=\"JSON\" name=\"payload_format\""
+                                     "%s>JSON ",
+                               cc26xx_web_demo_config.mqtt_config.payload_format
+                               == MQTT_CLIENT_PAYLOAD_FORMAT_JSON ?
+                               " Checked" : ""));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "<input type=\"radio\" value=\"%d\" ",
+                               MQTT_CLIENT_PAYLOAD_FORMAT_CBOR));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "title=\"CBOR\" name=\"payload_format\""
+                                     "%s>CBOR ",
+                               cc26xx_web_demo_config.mqtt_config.payload_format
+                               == MQTT_CLIENT_PAYLOAD_FORMAT_CBOR ?
+                               " Checked" : ""));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "<input type=\"radio\" value=\"%d\" ",
+                               MQTT_CLIENT_PAYLOAD_FORMAT_CBOR_DELTA));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "title=\"CBOR + Delta\" "
+                                     "name=\"payload_format\"%s>CBOR + Delta%s",
+                               cc26xx_web_demo_config.mqtt_config.payload_format
+                               == MQTT_CLIENT_PAYLOAD_FORMAT_CBOR_DELTA ?
+                               " Checked" : "", config_div_close));
+
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "%sPublish:%s%s", config_div_left,
+                               config_div_close, config_div_right));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "<input type=\"radio\" value=\"%d\" ",
+                               MQTT_CLIENT_PUBLISH_MODE_RAW));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "title=\"Samples\" name=\"publish_mode\""
+                                     "%s>Samples ",
+                               cc26xx_web_demo_config.mqtt_config.publish_mode
+                               == MQTT_CLIENT_PUBLISH_MODE_RAW ?
+                               " Checked" : ""));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "<input type=\"radio\" value=\"%d\" ",
+                               MQTT_CLIENT_PUBLISH_MODE_FEATURES));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "title=\"Features\" "
+                                     "name=\"publish_mode\"%s>Features ",
+                               cc26xx_web_demo_config.mqtt_config.publish_mode
+                               == MQTT_CLIENT_PUBLISH_MODE_FEATURES ?
+                               " Checked" : ""));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "<input type=\"radio\" value=\"%d\" ",
+                               MQTT_CLIENT_PUBLISH_MODE_SPECTRUM));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "title=\"Spectrum\" "
+                                     "name=\"publish_mode\"%s>Spectrum%s",
+                               cc26xx_web_demo_config.mqtt_config.publish_mode
+                               == MQTT_CLIENT_PUBLISH_MODE_SPECTRUM ?
+                               " Checked" : "", config_div_close));
+
+#if CC26XX_WEB_DEMO_MQTT_SN
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "%sTransport:%s%s", config_div_left,
+                               config_div_close, config_div_right));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "<input type=\"radio\" value=\"%d\" ",
+                               MQTT_CLIENT_TRANSPORT_TCP));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "title=\"MQTT over TCP\" "
+                                     "name=\"transport\"%s>TCP ",
+                               cc26xx_web_demo_config.mqtt_config.transport
+                               == MQTT_CLIENT_TRANSPORT_TCP ?
+                               " Checked" : ""));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "<input type=\"radio\" value=\"%d\" ",
+                               MQTT_CLIENT_TRANSPORT_MQTT_SN));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "title=\"MQTT-SN over UDP\" "
+                                     "name=\"transport\"%s>MQTT-SN%s",
+                               cc26xx_web_demo_config.mqtt_config.transport
+                               == MQTT_CLIENT_TRANSPORT_MQTT_SN ?
+                               " Checked" : "", config_div_close));
+#endif
+
   PT_WAIT_THREAD(&s->generate_pt,
                  enqueue_chunk(s, 0, "%sBroker IP:%s", config_div_left,
                                config_div_close));
@@ -802,6 +1133,134 @@ PT_THREAD(generate_mqtt_config(struct httpd_state *s))
 }
 #endif
 /*---------------------------------------------------------------------------*/
+#if CYCLE_STATS_ENABLED
+/*
+ * Locals don't survive a protothread yield and arguments get evaluated again
+ * on resumption, so always go through s->site
+ */
+#define STATS_SITE(s) cycle_stats_get((s)->site)
+
+#define LINK_STATS mqtt_client_link_stats()
+#define LINK_STATS_MEAN(n) \
+  (LINK_STATS->publishes ? \
+   (unsigned long)(((uint64_t)(n) * 100) / LINK_STATS->publishes) : 0UL)
+#define RECONNECT_STATS mqtt_client_reconnect_stats()
+
+static
+PT_THREAD(generate_stats(struct httpd_state *s))
+{
+  PT_BEGIN(&s->generate_pt);
+
+  /* Generate top matter (doctype, title, nav links etc) */
+  PT_WAIT_THREAD(&s->generate_pt,
+                 generate_top_matter(s, http_stats_page.title, NULL));
+
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, SECTION_OPEN "Run Times ("
+                               CYCLE_STATS_UNIT ")" CONTENT_OPEN));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "%-5s %8s %8s %8s %8s", "Site", "Runs",
+                               "Min", "Mean", "Max"));
+
+  for(s->site = 0; s->site < CYCLE_STATS_SITES; s->site++) {
+    PT_WAIT_THREAD(&s->generate_pt,
+                   enqueue_chunk(s, 0, "\n%-5s %8lu %8lu %8lu %8lu",
+                                 cycle_stats_name(s->site),
+                                 (unsigned long)STATS_SITE(s)->count,
+                                 (unsigned long)STATS_SITE(s)->min,
+                                 (unsigned long)cycle_stats_mean(s->site),
+                                 (unsigned long)STATS_SITE(s)->max));
+  }
+
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, CONTENT_CLOSE SECTION_CLOSE));
+
+  /* Histograms. Bucket limits grow by a factor of 4 */
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, SECTION_OPEN "Histograms" CONTENT_OPEN));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "%-5s %6s %6s %6s %6s %6s %6s %6s %6s",
+                               "Site", "<256", "<1K", "<4K", "<16K", "<64K",
+                               "<256K", "<1M", ">=1M"));
+
+  for(s->site = 0; s->site < CYCLE_STATS_SITES; s->site++) {
+    PT_WAIT_THREAD(&s->generate_pt,
+                   enqueue_chunk(s, 0, "\n%-5s %6u %6u %6u %6u %6u %6u %6u %6u",
+                                 cycle_stats_name(s->site),
+                                 STATS_SITE(s)->buckets[0],
+                                 STATS_SITE(s)->buckets[1],
+                                 STATS_SITE(s)->buckets[2],
+                                 STATS_SITE(s)->buckets[3],
+                                 STATS_SITE(s)->buckets[4],
+                                 STATS_SITE(s)->buckets[5],
+                                 STATS_SITE(s)->buckets[6],
+                                 STATS_SITE(s)->buckets[7]));
+  }
+
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, CONTENT_CLOSE SECTION_CLOSE));
+
+#if CC26XX_WEB_DEMO_MQTT_CLIENT
+  /* Estimates from the header sizes. Means are in hundredths */
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, SECTION_OPEN "Publish Frames"
+                               CONTENT_OPEN));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "Segment size: %u bytes%s\n",
+                               LINK_STATS->segment_size,
+                               LINK_STATS->segment_size ? "" :
+                               " (MQTT-SN, one datagram per publish)"));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "%-8s %8s %8s %8s", "", "Publish",
+                               "Segments", "Frames"));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "\n%-8s %8s %8u %8u", "Last", "",
+                               LINK_STATS->last_segments,
+                               LINK_STATS->last_frames));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "\n%-8s %8lu %8lu %8lu", "Total",
+                               (unsigned long)LINK_STATS->publishes,
+                               (unsigned long)LINK_STATS->segments,
+                               (unsigned long)LINK_STATS->frames));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "\n%-8s %8s %8lu %8lu", "Mean x100",
+                               "",
+                               LINK_STATS_MEAN(LINK_STATS->segments),
+                               LINK_STATS_MEAN(LINK_STATS->frames)));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, CONTENT_CLOSE SECTION_CLOSE));
+
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, SECTION_OPEN "Reconnects"
+                               CONTENT_OPEN));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "Attempts: %lu, connected: %lu, "
+                               "failed: %lu\n",
+                               (unsigned long)RECONNECT_STATS->attempts,
+                               (unsigned long)RECONNECT_STATS->connects,
+                               (unsigned long)RECONNECT_STATS->failures));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "Failures in a row: %u of %u%s\n",
+                               RECONNECT_STATS->failed,
+                               MQTT_CLIENT_RECONNECT_BUDGET,
+                               RECONNECT_STATS->failed >
+                               MQTT_CLIENT_RECONNECT_BUDGET ?
+                               " (cooling down)" : ""));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, "Budget spent: %u times, "
+                               "last backoff: %lu ms",
+                               RECONNECT_STATS->cooldowns,
+                               (unsigned long)RECONNECT_STATS->last_backoff));
+  PT_WAIT_THREAD(&s->generate_pt,
+                 enqueue_chunk(s, 0, CONTENT_CLOSE SECTION_CLOSE));
+#endif
+
+  PT_WAIT_THREAD(&s->generate_pt, enqueue_chunk(s, 1, http_bottom));
+
+  PT_END(&s->generate_pt);
+}
+#endif
+/*---------------------------------------------------------------------------*/
 #if CC26XX_WEB_DEMO_NET_UART
 static
 PT_THREAD(generate_net_uart_config(struct httpd_state *s))
@@ -1063,6 +1522,20 @@ PT_THREAD(send_headers(struct httpd_state *s, const char *statushdr,
   PT_END(&s->generate_pt);
 }
 /*---------------------------------------------------------------------------*/
+/* Runs the page generator until it blocks, and times it */
+static char
+run_script(struct httpd_state *s)
+{
+  uint32_t start;
+  char rv;
+
+  CYCLE_STATS_START(start);
+  rv = s->script(s);
+  CYCLE_STATS_STOP(CYCLE_STATS_SITE_HTTPD_PAGE, start);
+
+  return rv;
+}
+/*---------------------------------------------------------------------------*/
 static
 PT_THREAD(handle_output(struct httpd_state *s))
 {
@@ -1121,7 +1594,7 @@ PT_THREAD(handle_output(struct httpd_state *s))
                                                 http_content_type_html,
                                                 NULL,
                                                 http_header_con_close));
-      PT_WAIT_THREAD(&s->outputpt, s->script(s));
+      PT_WAIT_THREAD(&s->outputpt, run_script(s));
     }
   }
   s->script = NULL;
@@ -1318,6 +1791,10 @@ init(void)
 #if CC26XX_WEB_DEMO_MQTT_CLIENT
   list_add(pages_list, &http_mqtt_cfg_page);
 #endif
+
+#if CYCLE_STATS_ENABLED
+  list_add(pages_list, &http_stats_page);
+#endif
 }
 /*---------------------------------------------------------------------------*/
 PROCESS_THREAD(httpd_simple_process, ev, data)
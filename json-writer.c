@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \addtogroup cc26xx-web-demo
+ * @{
+ *
+ * \file
+ *   A small streaming JSON writer with append-only cursor semantics
+ */
+/*---------------------------------------------------------------------------*/
+#include "json-writer.h"
+
+#include <stdint.h>
+/*---------------------------------------------------------------------------*/
+/* Enough for "4294967295" */
+#define UINT32_DIGITS 10
+/*---------------------------------------------------------------------------*/
+static void
+put(json_writer_t *w, char c)
+{
+  if(w->pos < w->size) {
+    w->buf[w->pos++] = c;
+  } else {
+    w->overflow = 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+separator(json_writer_t *w)
+{
+  if(w->separate) {
+    put(w, ',');
+  }
+  w->separate = 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+put_uint(json_writer_t *w, uint32_t value)
+{
+  char digits[UINT32_DIGITS];
+  uint8_t n = 0;
+
+  /* Generate digits in reverse, then copy them out in order */
+  do {
+    digits[n++] = '0' + (value % 10);
+    value /= 10;
+  } while(value != 0);
+
+  while(n > 0) {
+    put(w, digits[--n]);
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+json_writer_init(json_writer_t *w, char *buf, uint16_t size)
+{
+  w->buf = buf;
+  w->size = size;
+  w->pos = 0;
+  w->overflow = 0;
+  w->separate = 0;
+}
+/*---------------------------------------------------------------------------*/
+void
+json_writer_open(json_writer_t *w, char c)
+{
+  separator(w);
+  put(w, c);
+  w->separate = 0;
+}
+/*---------------------------------------------------------------------------*/
+void
+json_writer_close(json_writer_t *w, char c)
+{
+  put(w, c);
+  w->separate = 1;
+}
+/*---------------------------------------------------------------------------*/
+void
+json_writer_key(json_writer_t *w, const char *key)
+{
+  json_writer_string(w, key);
+  put(w, ':');
+  w->separate = 0;
+}
+/*---------------------------------------------------------------------------*/
+void
+json_writer_string(json_writer_t *w, const char *str)
+{
+  separator(w);
+  put(w, '"');
+  for(; *str != '\0'; str++) {
+    if(*str == '"' || *str == '\\') {
+      put(w, '\\');
+    }
+    put(w, *str);
+  }
+  put(w, '"');
+}
+/*---------------------------------------------------------------------------*/
+void
+json_writer_hex(json_writer_t *w, const uint8_t *data, uint8_t len)
+{
+  static const char hex[] = "0123456789abcdef";
+
+  separator(w);
+  put(w, '"');
+  for(; len > 0; len--, data++) {
+    put(w, hex[*data >> 4]);
+    put(w, hex[*data & 0x0F]);
+  }
+  put(w, '"');
+}
+/*---------------------------------------------------------------------------*/
+void
+json_writer_int(json_writer_t *w, int32_t value)
+{
+  separator(w);
+  if(value < 0) {
+    put(w, '-');
+    put_uint(w, -(uint32_t)value);
+  } else {
+    put_uint(w, value);
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+json_writer_uint(json_writer_t *w, uint32_t value)
+{
+  separator(w);
+  put_uint(w, value);
+}
+/*---------------------------------------------------------------------------*/
+void
+json_writer_uint64(json_writer_t *w, uint64_t value)
+{
+  uint32_t low;
+  uint32_t div;
+
+  if(value <= UINT32_MAX) {
+    json_writer_uint(w, (uint32_t)value);
+    return;
+  }
+
+  /* Split so that only one 64-bit division is needed */
+  low = (uint32_t)(value % 1000000000);
+  json_writer_uint(w, (uint32_t)(value / 1000000000));
+  for(div = 100000000; div > 0; div /= 10) {
+    put(w, '0' + (low / div) % 10);
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+json_writer_fixed2(json_writer_t *w, int32_t value)
+{
+  uint32_t abs_value;
+  uint8_t frac;
+
+  separator(w);
+  if(value < 0) {
+    put(w, '-');
+    abs_value = -(uint32_t)value;
+  } else {
+    abs_value = value;
+  }
+
+  frac = abs_value % 100;
+  put_uint(w, abs_value / 100);
+  put(w, '.');
+  put(w, '0' + frac / 10);
+  put(w, '0' + frac % 10);
+}
+/*---------------------------------------------------------------------------*/
+int
+json_writer_len(const json_writer_t *w)
+{
+  return w->overflow ? -1 : w->pos;
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * @}
+ */
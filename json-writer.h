@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \addtogroup cc26xx-web-demo
+ * @{
+ *
+ * \file
+ *   Header file for a small streaming JSON writer.
+ *
+ *   Output is appended to a caller-supplied buffer through a cursor, in a
+ *   single pass. Separators are inserted automatically. Integers are
+ *   converted without going through the printf machinery. If the buffer runs
+ *   out, the writer latches an overflow flag and ignores further output.
+ */
+/*---------------------------------------------------------------------------*/
+#ifndef JSON_WRITER_H_
+#define JSON_WRITER_H_
+/*---------------------------------------------------------------------------*/
+#include <stdint.h>
+/*---------------------------------------------------------------------------*/
+typedef struct json_writer {
+  char *buf;
+  uint16_t size;
+  uint16_t pos;
+  uint8_t overflow;
+  uint8_t separate; /* Next member / element needs a leading comma */
+} json_writer_t;
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief Prepares a writer to output into buf
+ * \param w A pointer to the writer
+ * \param buf The output buffer
+ * \param size The size of buf in bytes
+ */
+void json_writer_init(json_writer_t *w, char *buf, uint16_t size);
+
+/**
+ * \brief Opens an object or an array
+ * \param c '{' or '['
+ */
+void json_writer_open(json_writer_t *w, char c);
+
+/**
+ * \brief Closes an object or an array
+ * \param c '}' or ']'
+ */
+void json_writer_close(json_writer_t *w, char c);
+
+/**
+ * \brief Writes an object member name. The next call must write its value
+ */
+void json_writer_key(json_writer_t *w, const char *key);
+
+/** \brief Writes a string value */
+void json_writer_string(json_writer_t *w, const char *str);
+
+/** \brief Writes a string value holding the hex representation of data */
+void json_writer_hex(json_writer_t *w, const uint8_t *data, uint8_t len);
+
+/** \brief Writes a signed integer value */
+void json_writer_int(json_writer_t *w, int32_t value);
+
+/** \brief Writes an unsigned integer value */
+void json_writer_uint(json_writer_t *w, uint32_t value);
+
+/** \brief Writes an unsigned 64-bit integer value, e.g. a time in ms */
+void json_writer_uint64(json_writer_t *w, uint64_t value);
+
+/**
+ * \brief Writes a fixed-point value with two decimals
+ * \param value The value in hundredths, e.g. -105 is written as -1.05
+ */
+void json_writer_fixed2(json_writer_t *w, int32_t value);
+
+/**
+ * \brief Returns the number of bytes written so far
+ * \return The length, or -1 if the buffer overflowed
+ */
+int json_writer_len(const json_writer_t *w);
+/*---------------------------------------------------------------------------*/
+#endif /* JSON_WRITER_H_ */
+/*---------------------------------------------------------------------------*/
+/**
+ * @}
+ */
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \addtogroup cc26xx-web-demo
+ * @{
+ *
+ * \file
+ *   A runtime-sized ring buffer of binary motion samples
+ */
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+#include "motion-buffer.h"
+
+#include <stdint.h>
+#include <stddef.h>
+/*---------------------------------------------------------------------------*/
+static motion_frame_t frames[MOTION_BUFFER_MAX_CAPACITY];
+static uint16_t capacity = MOTION_BUFFER_MAX_CAPACITY;
+static uint16_t head; /* Index of the oldest frame */
+static uint16_t count;
+static uint16_t overruns;
+static uint32_t total;
+/*---------------------------------------------------------------------------*/
+void
+motion_buffer_init(uint16_t cap)
+{
+  if(cap == 0) {
+    cap = 1;
+  } else if(cap > MOTION_BUFFER_MAX_CAPACITY) {
+    cap = MOTION_BUFFER_MAX_CAPACITY;
+  }
+
+  capacity = cap;
+  head = 0;
+  count = 0;
+  overruns = 0;
+  total = 0;
+}
+/*---------------------------------------------------------------------------*/
+void
+motion_buffer_push(const motion_frame_t *frame)
+{
+  uint16_t tail = head + count;
+
+  if(tail >= capacity) {
+    tail -= capacity;
+  }
+
+  frames[tail] = *frame;
+  total++;
+
+  if(count < capacity) {
+    count++;
+  } else {
+    /* Full: we just overwrote the oldest frame */
+    head = head + 1 < capacity ? head + 1 : 0;
+    overruns++;
+  }
+}
+/*---------------------------------------------------------------------------*/
+const motion_frame_t *
+motion_buffer_get(uint16_t i)
+{
+  uint16_t pos;
+
+  if(i >= count) {
+    return NULL;
+  }
+
+  pos = head + i;
+  if(pos >= capacity) {
+    pos -= capacity;
+  }
+
+  return &frames[pos];
+}
+/*---------------------------------------------------------------------------*/
+void
+motion_buffer_drop(uint16_t n)
+{
+  if(n > count) {
+    n = count;
+  }
+
+  head += n;
+  if(head >= capacity) {
+    head -= capacity;
+  }
+  count -= n;
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+motion_buffer_count(void)
+{
+  return count;
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+motion_buffer_capacity(void)
+{
+  return capacity;
+}
+/*---------------------------------------------------------------------------*/
+uint32_t
+motion_buffer_total(void)
+{
+  return total;
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+motion_buffer_overruns(void)
+{
+  return overruns;
+}
+/*---------------------------------------------------------------------------*/
+uint32_t
+motion_frame_ms(uint32_t timestamp)
+{
+  uint64_t now = (uint64_t)clock_time() * 1000 / CLOCK_SECOND;
+  uint64_t age;
+
+  age = (uint64_t)(MOTION_FRAME_NOW() - timestamp) * 1000 / MOTION_FRAME_SECOND;
+
+  return age < now ? (uint32_t)(now - age) : 0;
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * @}
+ */
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \addtogroup cc26xx-web-demo
+ * @{
+ *
+ * \file
+ *   Header file for the motion sample store of the CC26XX web demo.
+ *
+ *   Accelerometer and gyro samples are kept in binary form in a ring buffer of
+ *   frames. The ring lives in a static arena and its capacity is chosen at
+ *   runtime, up to the size of the arena. Converting samples to text only
+ *   happens when a window gets published.
+ */
+/*---------------------------------------------------------------------------*/
+#ifndef MOTION_BUFFER_H_
+#define MOTION_BUFFER_H_
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+#include "mqtt-client.h"
+
+#include <stdint.h>
+/*---------------------------------------------------------------------------*/
+/*
+ * Frame timestamps are rtimer ticks, fine enough to tell the real spacing of
+ * samples apart at any sample rate. They wrap, so only compare them by
+ * difference
+ */
+#define MOTION_FRAME_SECOND           RTIMER_SECOND
+#define MOTION_FRAME_NOW()            ((uint32_t)RTIMER_NOW())
+/*---------------------------------------------------------------------------*/
+/* Axis indices within a frame. Same order as the MPU sensor types */
+#define MOTION_BUFFER_AXIS_ACC_X      0
+#define MOTION_BUFFER_AXIS_ACC_Y      1
+#define MOTION_BUFFER_AXIS_ACC_Z      2
+#define MOTION_BUFFER_AXIS_GYRO_X     3
+#define MOTION_BUFFER_AXIS_GYRO_Y     4
+#define MOTION_BUFFER_AXIS_GYRO_Z     5
+#define MOTION_BUFFER_AXES            6
+/*---------------------------------------------------------------------------*/
+/*
+ * Size of the static arena in frames, i.e. the largest possible capacity. It
+ * is allocated in full, whatever capacity is set at runtime. By default, it
+ * holds two batches of the largest size the MQTT client allows. To save RAM,
+ * lower MQTT_CLIENT_CONF_BATCH_SIZE_MAX rather than this
+ */
+#ifdef MOTION_BUFFER_CONF_MAX_CAPACITY
+#define MOTION_BUFFER_MAX_CAPACITY MOTION_BUFFER_CONF_MAX_CAPACITY
+#else
+#define MOTION_BUFFER_MAX_CAPACITY (MQTT_CLIENT_BATCH_SIZE_MAX * 2)
+#endif
+/*---------------------------------------------------------------------------*/
+/* Frame flags */
+#define MOTION_FRAME_FLAG_PRETRIGGER  0x01 /* Sampled before its trigger */
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief A single motion sample: all six axes taken at the same time
+ *
+ * Axis values are stored as returned by the MPU driver (hundredths of a G or
+ * hundredths of a deg/sec)
+ */
+typedef struct motion_frame {
+  uint32_t timestamp; /* MOTION_FRAME_NOW() when sampled */
+  int16_t axis[MOTION_BUFFER_AXES];
+  uint8_t flags;
+} motion_frame_t;
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief Empties the buffer and sets its capacity
+ * \param capacity The number of frames the buffer can hold before it starts
+ *        overwriting. Clipped to 1 - MOTION_BUFFER_MAX_CAPACITY
+ *
+ * Until this is first called, the capacity is MOTION_BUFFER_MAX_CAPACITY
+ */
+void motion_buffer_init(uint16_t capacity);
+
+/**
+ * \brief Appends a frame to the buffer
+ * \param frame A pointer to the frame to be copied in
+ *
+ * If the buffer is full, the oldest frame gets overwritten
+ */
+void motion_buffer_push(const motion_frame_t *frame);
+
+/**
+ * \brief Returns a frame from the buffer
+ * \param i The frame index, 0 being the oldest frame in the buffer
+ * \return A pointer to the frame or NULL if i is out of range
+ */
+const motion_frame_t *motion_buffer_get(uint16_t i);
+
+/**
+ * \brief Discards the oldest frames from the buffer
+ * \param count The number of frames to discard
+ */
+void motion_buffer_drop(uint16_t count);
+
+/**
+ * \brief Returns the number of frames currently held in the buffer
+ */
+uint16_t motion_buffer_count(void);
+
+/**
+ * \brief Returns the number of frames the buffer can hold
+ */
+uint16_t motion_buffer_capacity(void);
+
+/**
+ * \brief Returns the number of frames pushed since init
+ *
+ * Consumers can compare this against a value they saved earlier to tell how
+ * many new frames have arrived. It is allowed to wrap
+ */
+uint32_t motion_buffer_total(void);
+
+/**
+ * \brief Returns the number of frames lost to overwrites since init
+ */
+uint16_t motion_buffer_overruns(void);
+
+/**
+ * \brief Converts a frame timestamp to milliseconds since boot
+ * \param timestamp The frame timestamp, sampled less than a wrap of the rtimer
+ *        ago
+ */
+uint32_t motion_frame_ms(uint32_t timestamp);
+/*---------------------------------------------------------------------------*/
+#endif /* MOTION_BUFFER_H_ */
+/*---------------------------------------------------------------------------*/
+/**
+ * @}
+ */
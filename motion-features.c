@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \addtogroup cc26xx-web-demo
+ * @{
+ *
+ * \file
+ *   Incremental, integer-only motion features
+ */
+/*---------------------------------------------------------------------------*/
+#include "motion-features.h"
+#include "motion-buffer.h"
+
+#include <stdint.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+/*
+ * Running sums per axis. With at most 2^32 frames of 16-bit samples, the sum
+ * needs 48 bits and the sum of squares 62
+ */
+typedef struct axis_sums {
+  int16_t min;
+  int16_t max;
+  int64_t sum;
+  uint64_t sum_sq;
+} axis_sums_t;
+
+static axis_sums_t sums[MOTION_BUFFER_AXES];
+static uint32_t count;
+static uint32_t start;
+/*---------------------------------------------------------------------------*/
+static uint32_t
+isqrt(uint32_t x)
+{
+  uint32_t root = 0;
+  uint32_t bit = 1UL << 30;
+
+  while(bit > x) {
+    bit >>= 2;
+  }
+
+  while(bit != 0) {
+    if(x >= root + bit) {
+      x -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+
+  return root;
+}
+/*---------------------------------------------------------------------------*/
+void
+motion_features_reset(void)
+{
+  memset(sums, 0, sizeof(sums));
+  count = 0;
+  start = 0;
+}
+/*---------------------------------------------------------------------------*/
+void
+motion_features_add(const motion_frame_t *frame)
+{
+  axis_sums_t *s;
+  int16_t v;
+  int axis;
+
+  if(count == UINT32_MAX) {
+    return;
+  }
+
+  if(count == 0) {
+    start = frame->timestamp;
+  }
+
+  for(axis = 0; axis < MOTION_BUFFER_AXES; axis++) {
+    s = &sums[axis];
+    v = frame->axis[axis];
+
+    if(count == 0 || v < s->min) {
+      s->min = v;
+    }
+    if(count == 0 || v > s->max) {
+      s->max = v;
+    }
+    s->sum += v;
+    s->sum_sq += (uint32_t)((int32_t)v * v);
+  }
+
+  count++;
+}
+/*---------------------------------------------------------------------------*/
+uint32_t
+motion_features_count(void)
+{
+  return count;
+}
+/*---------------------------------------------------------------------------*/
+uint32_t
+motion_features_start(void)
+{
+  return start;
+}
+/*---------------------------------------------------------------------------*/
+void
+motion_features_get(int axis, motion_features_t *f)
+{
+  const axis_sums_t *s;
+  int64_t q;
+  int64_t r;
+  uint64_t dev_sq;
+
+  memset(f, 0, sizeof(*f));
+
+  if(count == 0 || axis < 0 || axis >= MOTION_BUFFER_AXES) {
+    return;
+  }
+
+  s = &sums[axis];
+
+  /*
+   * With sum = q * n + r, the sum of squared deviations from the mean is
+   * sum_sq - sum^2 / n = sum_sq - q^2 * n - 2 * q * r - r^2 / n. Unlike
+   * sum^2, none of these terms can overflow
+   */
+  q = s->sum / (int64_t)count;
+  r = s->sum - q * (int64_t)count;
+  dev_sq = s->sum_sq - (uint64_t)(q * q) * count - (uint64_t)(2 * q * r) -
+    ((uint64_t)(r < 0 ? -r : r) * (uint64_t)(r < 0 ? -r : r)) / count;
+
+  f->min = s->min;
+  f->max = s->max;
+  f->mean = (int16_t)q;
+  f->rms = (uint16_t)isqrt((uint32_t)(s->sum_sq / count));
+  f->variance = (uint32_t)(dev_sq / count);
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * @}
+ */
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \addtogroup cc26xx-web-demo
+ * @{
+ *
+ * \file
+ *   Header file for per-window motion features.
+ *
+ *   Summary statistics of each axis (min, max, mean, RMS and variance) are
+ *   accumulated one frame at a time, so a window can be any number of frames
+ *   long without the frames being kept. Only integer arithmetic is used.
+ */
+/*---------------------------------------------------------------------------*/
+#ifndef MOTION_FEATURES_H_
+#define MOTION_FEATURES_H_
+/*---------------------------------------------------------------------------*/
+#include "motion-buffer.h"
+
+#include <stdint.h>
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief The features of one axis over a window
+ *
+ * min, max, mean and rms are in the units of the samples (hundredths of a G
+ * or of a deg/sec), the variance in the square of those units. The mean
+ * is rounded towards zero, the others down
+ */
+typedef struct motion_features {
+  int16_t min;
+  int16_t max;
+  int16_t mean;
+  uint16_t rms;
+  uint32_t variance;
+} motion_features_t;
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief Starts a new window
+ */
+void motion_features_reset(void);
+
+/**
+ * \brief Folds a frame into the current window
+ * \param frame The frame
+ */
+void motion_features_add(const motion_frame_t *frame);
+
+/**
+ * \brief Returns the number of frames in the current window
+ */
+uint32_t motion_features_count(void);
+
+/**
+ * \brief Returns the timestamp of the first frame in the current window
+ */
+uint32_t motion_features_start(void);
+
+/**
+ * \brief Computes the features of an axis over the current window
+ * \param axis MOTION_BUFFER_AXIS_ACC_X...
+ * \param f Receives the features. All zero if the window is empty
+ */
+void motion_features_get(int axis, motion_features_t *f);
+/*---------------------------------------------------------------------------*/
+#endif /* MOTION_FEATURES_H_ */
+/*---------------------------------------------------------------------------*/
+/**
+ * @}
+ */
@@ -0,0 +1,294 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \addtogroup cc26xx-web-demo
+ * @{
+ *
+ * \file
+ *   Fixed-point FFT of motion samples
+ */
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+#include "motion-fft.h"
+#include "motion-buffer.h"
+#include "cycle-stats.h"
+
+#include <stdint.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+/* sin(2 * pi * k / MOTION_FFT_MAX_SIZE) in Q15, for the first quarter wave */
+#define QUARTER (MOTION_FFT_MAX_SIZE / 4)
+
+static const int16_t sine[QUARTER + 1] = {
+      0,  3212,  6393,  9512, 12540, 15447, 18205, 20788,
+  23170, 25330, 27246, 28899, 30274, 31357, 32138, 32610,
+  32767,
+};
+
+/* Normalized samples stay below this, so the FFT cannot overflow */
+#define INPUT_MAX                 0x3FFF
+/*---------------------------------------------------------------------------*/
+static int16_t re[MOTION_FFT_MAX_SIZE];
+static int16_t im[MOTION_FFT_MAX_SIZE];
+static int32_t x[MOTION_FFT_MAX_SIZE];
+/*---------------------------------------------------------------------------*/
+/* sin(2 * pi * k / MOTION_FFT_MAX_SIZE) */
+static int16_t
+sin_q15(uint16_t k)
+{
+  k &= MOTION_FFT_MAX_SIZE - 1;
+
+  if(k <= QUARTER) {
+    return sine[k];
+  } else if(k <= 2 * QUARTER) {
+    return sine[2 * QUARTER - k];
+  } else if(k <= 3 * QUARTER) {
+    return -sine[k - 2 * QUARTER];
+  }
+
+  return -sine[4 * QUARTER - k];
+}
+/*---------------------------------------------------------------------------*/
+static int16_t
+cos_q15(uint16_t k)
+{
+  return sin_q15(k + QUARTER);
+}
+/*---------------------------------------------------------------------------*/
+static uint32_t
+isqrt(uint32_t v)
+{
+  uint32_t root = 0;
+  uint32_t bit = 1UL << 30;
+
+  while(bit > v) {
+    bit >>= 2;
+  }
+
+  while(bit != 0) {
+    if(v >= root + bit) {
+      v -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+
+  return root;
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * In-place radix-2 decimation in time. Every stage halves its outputs, so the
+ * result is the DFT divided by n and the magnitudes never grow
+ */
+static void
+fft(uint16_t n)
+{
+  uint16_t i, j, bit;
+  uint16_t len, half, step;
+  int32_t wr, wi, tr, ti;
+  int16_t tmp;
+
+  /* Bit-reversal permutation */
+  for(i = 1, j = 0; i < n; i++) {
+    for(bit = n >> 1; j & bit; bit >>= 1) {
+      j ^= bit;
+    }
+    j |= bit;
+
+    if(i < j) {
+      tmp = re[i];
+      re[i] = re[j];
+      re[j] = tmp;
+      tmp = im[i];
+      im[i] = im[j];
+      im[j] = tmp;
+    }
+  }
+
+  for(len = 2; len <= n; len <<= 1) {
+    half = len >> 1;
+    step = MOTION_FFT_MAX_SIZE / len;
+
+    for(i = 0; i < n; i += len) {
+      for(j = 0; j < half; j++) {
+        uint16_t a = i + j;
+        uint16_t b = a + half;
+
+        wr = cos_q15(j * step);
+        wi = -sin_q15(j * step);
+
+        tr = (wr * re[b] - wi * im[b]) >> 15;
+        ti = (wr * im[b] + wi * re[b]) >> 15;
+
+        re[b] = (int16_t)((re[a] - tr) >> 1);
+        im[b] = (int16_t)((im[a] - ti) >> 1);
+        re[a] = (int16_t)((re[a] + tr) >> 1);
+        im[a] = (int16_t)((im[a] + ti) >> 1);
+      }
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+motion_fft_size(uint16_t frames)
+{
+  uint16_t n;
+
+  if(frames < MOTION_FFT_MIN_SIZE) {
+    return 0;
+  }
+
+  for(n = MOTION_FFT_MAX_SIZE; n > frames; n >>= 1);
+
+  return n;
+}
+/*---------------------------------------------------------------------------*/
+int
+motion_fft_peaks(int axis, uint16_t first, uint16_t n,
+                 motion_fft_peak_t *peaks)
+{
+  uint32_t power[MOTION_FFT_PEAKS];
+  uint16_t bins[MOTION_FFT_PEAKS];
+  uint32_t span;
+  uint32_t p;
+  uint32_t maxabs = 0;
+  int32_t mean = 0;
+  int found = 0;
+  int shift = 0;
+  uint32_t start;
+  uint16_t i;
+  int k;
+
+  if(n < MOTION_FFT_MIN_SIZE || n > MOTION_FFT_MAX_SIZE || (n & (n - 1)) ||
+     first + n > motion_buffer_count()) {
+    return -1;
+  }
+
+  CYCLE_STATS_START(start);
+
+  for(i = 0; i < n; i++) {
+    x[i] = motion_buffer_get(first + i)->axis[axis];
+    mean += x[i];
+  }
+  mean /= n;
+
+  /* Remove DC and apply a Hann window, 0.5 - 0.5 cos(2 pi i / n) */
+  for(i = 0; i < n; i++) {
+    x[i] = ((x[i] - mean) *
+            ((32768 - cos_q15(i * (MOTION_FFT_MAX_SIZE / n))) >> 1)) >> 15;
+    p = x[i] < 0 ? -x[i] : x[i];
+    if(p > maxabs) {
+      maxabs = p;
+    }
+  }
+
+  /* Scale into the top of the Q15 range to keep precision through the FFT */
+  if(maxabs > 0) {
+    while((maxabs << (shift + 1)) <= INPUT_MAX) {
+      shift++;
+    }
+    while((maxabs >> -shift) > INPUT_MAX) {
+      shift--;
+    }
+  }
+
+  for(i = 0; i < n; i++) {
+    re[i] = (int16_t)(shift >= 0 ? x[i] << shift : x[i] >> -shift);
+    im[i] = 0;
+  }
+
+  fft(n);
+
+  for(i = 0; i <= n / 2; i++) {
+    x[i] = (int32_t)re[i] * re[i] + (int32_t)im[i] * im[i];
+  }
+
+  /*
+   * Keep the strongest local maxima, DC excluded, strongest first. The Hann
+   * main lobe spreads a tone over three bins, so plain top-K would report
+   * the same tone more than once
+   */
+  for(i = 1; i <= n / 2; i++) {
+    p = (uint32_t)x[i];
+    if(p == 0 || p < (uint32_t)x[i - 1] ||
+       (i < n / 2 && p <= (uint32_t)x[i + 1])) {
+      continue;
+    }
+
+    for(k = found; k > 0 && power[k - 1] < p; k--) {
+      if(k < MOTION_FFT_PEAKS) {
+        power[k] = power[k - 1];
+        bins[k] = bins[k - 1];
+      }
+    }
+
+    if(k < MOTION_FFT_PEAKS) {
+      power[k] = p;
+      bins[k] = i;
+      if(found < MOTION_FFT_PEAKS) {
+        found++;
+      }
+    }
+  }
+
+  /* n frames span n - 1 sample periods */
+  span = motion_buffer_get(first + n - 1)->timestamp -
+    motion_buffer_get(first)->timestamp;
+
+  for(k = 0, i = 0; k < found; k++) {
+    /*
+     * A sine of amplitude A shows up as A / 2 in each of its two bins, and
+     * the Hann window halves that again
+     */
+    p = isqrt(power[k]) << 2;
+    p = shift >= 0 ? p >> shift : p << -shift;
+
+    /* Rounding noise from the normalization */
+    if(p == 0) {
+      break;
+    }
+
+    peaks[i].amplitude = p > 0xFFFF ? 0xFFFF : (uint16_t)p;
+    peaks[i].freq = span ? (uint32_t)(((uint64_t)bins[k] * 100 *
+                                       MOTION_FRAME_SECOND *
+                                       (n - 1)) / ((uint64_t)n * span)) : 0;
+    i++;
+  }
+
+  CYCLE_STATS_STOP(CYCLE_STATS_SITE_FFT, start);
+
+  return i;
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * @}
+ */
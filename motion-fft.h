@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \addtogroup cc26xx-web-demo
+ * @{
+ *
+ * \file
+ *   Header file for the spectral analysis of motion samples.
+ *
+ *   A power-of-two run of frames is taken from the motion buffer, one axis
+ *   at a time, and goes through a Hann window and an in-place radix-2 Q15
+ *   FFT. The strongest bins are reported as frequency / amplitude peaks.
+ *   All working memory is static.
+ */
+/*---------------------------------------------------------------------------*/
+#ifndef MOTION_FFT_H_
+#define MOTION_FFT_H_
+/*---------------------------------------------------------------------------*/
+#include <stdint.h>
+/*---------------------------------------------------------------------------*/
+/* Window sizes in frames. The maximum is also the size of the twiddle table */
+#define MOTION_FFT_MIN_SIZE            8
+#define MOTION_FFT_MAX_SIZE           64
+
+/* The number of peaks reported per axis */
+#ifdef MOTION_FFT_CONF_PEAKS
+#define MOTION_FFT_PEAKS MOTION_FFT_CONF_PEAKS
+#else
+#define MOTION_FFT_PEAKS               3
+#endif
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief A spectral peak
+ */
+typedef struct motion_fft_peak {
+  uint32_t freq;      /* Centre frequency of the bin, in hundredths of a Hz */
+  uint16_t amplitude; /* Sine amplitude, in the units of the samples */
+} motion_fft_peak_t;
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief Returns the largest usable window size for a number of frames
+ * \param frames The number of frames available
+ * \return A power of two between MOTION_FFT_MIN_SIZE and MOTION_FFT_MAX_SIZE,
+ *         or 0 if there are too few frames
+ */
+uint16_t motion_fft_size(uint16_t frames);
+
+/**
+ * \brief Finds the strongest frequencies of an axis
+ * \param axis MOTION_BUFFER_AXIS_ACC_X...
+ * \param first Index of the first frame in the motion buffer
+ * \param n The number of frames, as returned by motion_fft_size()
+ * \param peaks Receives up to MOTION_FFT_PEAKS peaks, strongest first
+ * \return The number of peaks found, or -1 if the window is invalid
+ *
+ * The mean is removed first, so DC is never reported. The sample rate is
+ * worked out from the frame timestamps
+ */
+int motion_fft_peaks(int axis, uint16_t first, uint16_t n,
+                     motion_fft_peak_t *peaks);
+/*---------------------------------------------------------------------------*/
+#endif /* MOTION_FFT_H_ */
+/*---------------------------------------------------------------------------*/
+/**
+ * @}
+ */
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \addtogroup cc26xx-web-demo
+ * @{
+ *
+ * \file
+ *   A mock MPU FIFO driver. Produces synthetic frames at the requested rate
+ *   without touching any hardware, so that the acquisition path can be
+ *   exercised off-target.
+ */
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+#include "mpu-fifo.h"
+
+#include <stdint.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+static uint16_t rate;
+static clock_time_t started;
+static uint32_t produced;
+static uint8_t running;
+/*---------------------------------------------------------------------------*/
+static uint16_t
+start(uint16_t r)
+{
+  /* Round like the real MPU does, so that timestamps get the same test */
+  if(r < MPU_FIFO_RATE_MIN) {
+    r = MPU_FIFO_RATE_MIN;
+  } else if(r > MPU_FIFO_RATE_MAX) {
+    r = MPU_FIFO_RATE_MAX;
+  }
+
+  rate = MPU_FIFO_ACTUAL_RATE(r);
+  started = clock_time();
+  produced = 0;
+  running = 1;
+
+  return rate;
+}
+/*---------------------------------------------------------------------------*/
+static void
+stop(void)
+{
+  running = 0;
+}
+/*---------------------------------------------------------------------------*/
+/* A triangle wave with a period of 64 samples */
+static int16_t
+triangle(uint32_t n, int16_t amplitude)
+{
+  int16_t phase = n & 0x3F;
+
+  phase = phase < 32 ? phase : 64 - phase;
+
+  return (int16_t)((phase - 16) * amplitude / 16);
+}
+/*---------------------------------------------------------------------------*/
+static int
+drain(mpu_fifo_frame_callback_t cb)
+{
+  motion_frame_t frame;
+  uint32_t due;
+  uint16_t count;
+  uint16_t i;
+
+  if(!running) {
+    return 0;
+  }
+
+  due = ((uint32_t)(clock_time() - started) * rate) / CLOCK_SECOND;
+
+  if(due - produced > MPU_FIFO_MAX_FRAMES) {
+    /* We'd have overflowed a real FIFO */
+    produced = due;
+    return -1;
+  }
+
+  count = due - produced;
+
+  for(i = 0; i < count; i++, produced++) {
+    memset(&frame, 0, sizeof(frame));
+    frame.axis[MOTION_BUFFER_AXIS_ACC_X] = triangle(produced, 10);
+    frame.axis[MOTION_BUFFER_AXIS_ACC_Z] = 100;
+    frame.axis[MOTION_BUFFER_AXIS_GYRO_Z] = triangle(produced, 3000);
+    cb(&frame, i, count);
+  }
+
+  return count;
+}
+/*---------------------------------------------------------------------------*/
+const mpu_fifo_driver_t mpu_fifo_mock_driver = {
+  "MPU-9250 mock",
+  start,
+  stop,
+  drain,
+};
+/*---------------------------------------------------------------------------*/
+/**
+ * @}
+ */
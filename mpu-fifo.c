@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \addtogroup cc26xx-web-demo
+ * @{
+ *
+ * \file
+ *   MPU-9250 FIFO driver for the SensorTag. Talks to the MPU directly over
+ *   I2C. Powering the chip up and down is still left to the Contiki
+ *   mpu_9250_sensor driver.
+ */
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+#include "board-i2c.h"
+#include "sensor-common.h"
+#include "mpu-fifo.h"
+
+#include <stdint.h>
+#include <stdio.h>
+/*---------------------------------------------------------------------------*/
+#define DEBUG 0
+#if DEBUG
+#define PRINTF(...) printf(__VA_ARGS__)
+#else
+#define PRINTF(...)
+#endif
+/*---------------------------------------------------------------------------*/
+#define SENSOR_I2C_ADDRESS            0x68
+#define SENSOR_SELECT()   board_i2c_select(BOARD_I2C_INTERFACE_1, SENSOR_I2C_ADDRESS)
+#define SENSOR_DESELECT() board_i2c_deselect()
+/*---------------------------------------------------------------------------*/
+/* Registers */
+#define SMPLRT_DIV                    0x19
+#define CONFIG                        0x1A
+#define FIFO_EN                       0x23
+#define INT_STATUS                    0x3A
+#define USER_CTRL                     0x6A
+#define FIFO_COUNT_H                  0x72
+#define FIFO_R_W                      0x74
+
+/* CONFIG: Stop writing when full so that frames stay aligned. DLPF 184 Hz */
+#define CONFIG_FIFO_MODE_STOP         0x40
+#define CONFIG_DLPF_184               0x01
+
+/* FIFO_EN: accel xyz first, then gyro xyz */
+#define FIFO_EN_GYRO_X                0x40
+#define FIFO_EN_GYRO_Y                0x20
+#define FIFO_EN_GYRO_Z                0x10
+#define FIFO_EN_ACCEL                 0x08
+#define FIFO_EN_MOTION (FIFO_EN_ACCEL | FIFO_EN_GYRO_X | FIFO_EN_GYRO_Y | \
+                        FIFO_EN_GYRO_Z)
+
+#define USER_CTRL_FIFO_EN             0x40
+#define USER_CTRL_FIFO_RST            0x04
+
+#define INT_STATUS_FIFO_OFLOW         0x10
+
+/*---------------------------------------------------------------------------*/
+/* Full-scale ranges, must match what the mpu_9250_sensor driver configures */
+#ifdef MPU_FIFO_CONF_ACC_RANGE_G
+#define ACC_RANGE_G MPU_FIFO_CONF_ACC_RANGE_G
+#else
+#define ACC_RANGE_G                      2
+#endif
+
+#ifdef MPU_FIFO_CONF_GYRO_RANGE_DPS
+#define GYRO_RANGE_DPS MPU_FIFO_CONF_GYRO_RANGE_DPS
+#else
+#define GYRO_RANGE_DPS                 250
+#endif
+/*---------------------------------------------------------------------------*/
+/* Largest I2C burst we can do (the length argument is a uint8_t) */
+#define BURST_FRAMES (255 / MPU_FIFO_FRAME_LEN)
+
+static uint8_t burst[BURST_FRAMES * MPU_FIFO_FRAME_LEN];
+/*---------------------------------------------------------------------------*/
+/*
+ * Convert raw readings to the units used by mpu_9250_sensor.value():
+ * hundredths of a G and hundredths of a deg/sec
+ */
+static int16_t
+acc_convert(int16_t raw)
+{
+  return (int16_t)(((int32_t)raw * (ACC_RANGE_G * 100)) / 32768);
+}
+/*---------------------------------------------------------------------------*/
+static int16_t
+gyro_convert(int16_t raw)
+{
+  return (int16_t)(((int32_t)raw * (GYRO_RANGE_DPS * 100)) / 32768);
+}
+/*---------------------------------------------------------------------------*/
+static int
+write_reg(uint8_t reg, uint8_t val)
+{
+  return sensor_common_write_reg(reg, &val, 1);
+}
+/*---------------------------------------------------------------------------*/
+static int
+fifo_reset(void)
+{
+  int rv;
+
+  rv = write_reg(USER_CTRL, USER_CTRL_FIFO_RST);
+  rv = rv && write_reg(USER_CTRL, USER_CTRL_FIFO_EN);
+
+  return rv;
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+start(uint16_t rate)
+{
+  int rv;
+
+  if(rate < MPU_FIFO_RATE_MIN) {
+    rate = MPU_FIFO_RATE_MIN;
+  } else if(rate > MPU_FIFO_RATE_MAX) {
+    rate = MPU_FIFO_RATE_MAX;
+  }
+
+  SENSOR_SELECT();
+
+  rv = write_reg(CONFIG, CONFIG_FIFO_MODE_STOP | CONFIG_DLPF_184);
+  /* MPU_FIFO_INTERNAL_RATE is the rate with the DLPF on */
+  rv = rv && write_reg(SMPLRT_DIV, MPU_FIFO_DIVIDER(rate) - 1);
+  rv = rv && write_reg(FIFO_EN, FIFO_EN_MOTION);
+  rv = rv && fifo_reset();
+
+  SENSOR_DESELECT();
+
+  PRINTF("MPU FIFO: start at %u Hz (%u asked), rv=%d\n",
+         MPU_FIFO_ACTUAL_RATE(rate), rate, rv);
+
+  return rv ? MPU_FIFO_ACTUAL_RATE(rate) : 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+stop(void)
+{
+  SENSOR_SELECT();
+  write_reg(FIFO_EN, 0);
+  write_reg(USER_CTRL, 0);
+  SENSOR_DESELECT();
+}
+/*---------------------------------------------------------------------------*/
+static int
+drain(mpu_fifo_frame_callback_t cb)
+{
+  motion_frame_t frame;
+  uint8_t buf[2];
+  uint16_t count;
+  uint16_t index;
+  uint16_t chunk;
+  uint16_t i;
+  uint8_t *p;
+  int axis;
+
+  SENSOR_SELECT();
+
+  if(!sensor_common_read_reg(INT_STATUS, buf, 1)) {
+    SENSOR_DESELECT();
+    return 0;
+  }
+
+  if(buf[0] & INT_STATUS_FIFO_OFLOW) {
+    PRINTF("MPU FIFO: overflow\n");
+    fifo_reset();
+    SENSOR_DESELECT();
+    return -1;
+  }
+
+  if(!sensor_common_read_reg(FIFO_COUNT_H, buf, 2)) {
+    SENSOR_DESELECT();
+    return 0;
+  }
+
+  count = ((buf[0] << 8) | buf[1]) / MPU_FIFO_FRAME_LEN;
+
+  for(index = 0; index < count; index += chunk) {
+    chunk = count - index < BURST_FRAMES ? count - index : BURST_FRAMES;
+
+    if(!sensor_common_read_reg(FIFO_R_W, burst, chunk * MPU_FIFO_FRAME_LEN)) {
+      /* We may have lost alignment. Start over */
+      fifo_reset();
+      SENSOR_DESELECT();
+      return -1;
+    }
+
+    for(i = 0, p = burst; i < chunk; i++) {
+      for(axis = 0; axis < MOTION_BUFFER_AXES; axis++, p += 2) {
+        if(axis < MOTION_BUFFER_AXIS_GYRO_X) {
+          frame.axis[axis] = acc_convert((int16_t)((p[0] << 8) | p[1]));
+        } else {
+          frame.axis[axis] = gyro_convert((int16_t)((p[0] << 8) | p[1]));
+        }
+      }
+      cb(&frame, index + i, count);
+    }
+  }
+
+  SENSOR_DESELECT();
+
+  return count;
+}
+/*---------------------------------------------------------------------------*/
+const mpu_fifo_driver_t mpu_fifo_i2c_driver = {
+  "MPU-9250 I2C",
+  start,
+  stop,
+  drain,
+};
+/*---------------------------------------------------------------------------*/
+/**
+ * @}
+ */
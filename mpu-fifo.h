@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \addtogroup cc26xx-web-demo
+ * @{
+ *
+ * \file
+ *   Header file for FIFO-backed MPU-9250 acquisition.
+ *
+ *   Instead of powering the MPU up and down for every sample, the sensor is
+ *   left sampling at its own output data rate into its hardware FIFO. The
+ *   FIFO is then drained periodically, many frames per I2C burst.
+ *
+ *   The hardware is accessed through a driver structure so that a mock
+ *   driver can stand in for the real sensor.
+ */
+/*---------------------------------------------------------------------------*/
+#ifndef MPU_FIFO_H_
+#define MPU_FIFO_H_
+/*---------------------------------------------------------------------------*/
+#include "motion-buffer.h"
+
+#include <stdint.h>
+/*---------------------------------------------------------------------------*/
+/* Driver used to access the FIFO */
+#ifdef MPU_FIFO_CONF_DRIVER
+#define MPU_FIFO_DRIVER MPU_FIFO_CONF_DRIVER
+#else
+#define MPU_FIFO_DRIVER mpu_fifo_i2c_driver
+#endif
+
+/* Output data rates in Hz accepted by the MPU */
+#define MPU_FIFO_RATE_MIN             4
+#define MPU_FIFO_RATE_MAX          1000
+
+/*
+ * The MPU divides its internal rate by a whole number (SMPLRT_DIV + 1), so
+ * most rates can only be approximated. The divider closest to a rate, and
+ * the rate in Hz that it gives
+ */
+#define MPU_FIFO_INTERNAL_RATE     1000
+#define MPU_FIFO_DIVIDER(rate) \
+  ((MPU_FIFO_INTERNAL_RATE + (rate) / 2) / (rate))
+#define MPU_FIFO_ACTUAL_RATE(rate) \
+  ((MPU_FIFO_INTERNAL_RATE + MPU_FIFO_DIVIDER(rate) / 2) / \
+   MPU_FIFO_DIVIDER(rate))
+/*---------------------------------------------------------------------------*/
+/* FIFO geometry: 6 x 16-bit big-endian words per frame (accel, then gyro) */
+#define MPU_FIFO_SIZE               512
+#define MPU_FIFO_FRAME_LEN           12
+#define MPU_FIFO_MAX_FRAMES (MPU_FIFO_SIZE / MPU_FIFO_FRAME_LEN)
+
+/*
+ * Drain the FIFO when it's about half full, so that a late timer does not
+ * overflow it
+ */
+#define MPU_FIFO_DRAIN_PERIOD(rate) \
+  ((clock_time_t)((MPU_FIFO_MAX_FRAMES / 2) * CLOCK_SECOND / (rate)) ? \
+   (clock_time_t)((MPU_FIFO_MAX_FRAMES / 2) * CLOCK_SECOND / (rate)) : 1)
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief Called once for each frame pulled out of the FIFO
+ * \param frame The frame, with all six axes converted. The callback owns the
+ *        timestamp and flags fields
+ * \param index The position of the frame within this drain, 0 being oldest
+ * \param count The total number of frames in this drain
+ */
+typedef void (*mpu_fifo_frame_callback_t)(motion_frame_t *frame,
+                                          uint16_t index, uint16_t count);
+
+/**
+ * \brief The structure of a driver giving access to the MPU FIFO
+ */
+typedef struct mpu_fifo_driver {
+  char *name;
+
+  /**
+   * \brief Start sampling into the FIFO. The sensor must already be powered
+   * \param rate The requested output data rate in Hz
+   * \return The rate the FIFO actually fills at, see MPU_FIFO_ACTUAL_RATE(),
+   *         or 0 on error
+   */
+  uint16_t (*start)(uint16_t rate);
+
+  /** \brief Stop filling the FIFO */
+  void (*stop)(void);
+
+  /**
+   * \brief Pull all complete frames out of the FIFO
+   * \param cb A callback invoked once per frame, oldest first
+   * \return The number of frames drained, or -1 if the FIFO had overflowed
+   *         and has been reset
+   */
+  int (*drain)(mpu_fifo_frame_callback_t cb);
+} mpu_fifo_driver_t;
+/*---------------------------------------------------------------------------*/
+extern const mpu_fifo_driver_t mpu_fifo_i2c_driver;
+extern const mpu_fifo_driver_t mpu_fifo_mock_driver;
+/*---------------------------------------------------------------------------*/
+#endif /* MPU_FIFO_H_ */
+/*---------------------------------------------------------------------------*/
+/**
+ * @}
+ */
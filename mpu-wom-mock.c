@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \addtogroup cc26xx-web-demo
+ * @{
+ *
+ * \file
+ *   A mock MPU wake-on-motion driver. Reports motion a while after being
+ *   armed, without touching any hardware, so that the event-driven path can
+ *   be exercised off-target.
+ */
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+#include "mpu-wom.h"
+
+#include <stdint.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+/* How long the mock door stays still once armed */
+#ifdef MPU_WOM_MOCK_CONF_IDLE_TIME
+#define IDLE_TIME MPU_WOM_MOCK_CONF_IDLE_TIME
+#else
+#define IDLE_TIME (CLOCK_SECOND * 30)
+#endif
+/*---------------------------------------------------------------------------*/
+static struct ctimer motion_timer;
+static mpu_wom_callback_t callback;
+/*---------------------------------------------------------------------------*/
+static void
+motion(void *data)
+{
+  mpu_wom_callback_t cb = callback;
+
+  callback = NULL;
+
+  if(cb != NULL) {
+    cb();
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+arm(uint16_t threshold, mpu_wom_callback_t cb)
+{
+  callback = cb;
+  ctimer_set(&motion_timer, IDLE_TIME, motion, NULL);
+
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+disarm(void)
+{
+  callback = NULL;
+  ctimer_stop(&motion_timer);
+}
+/*---------------------------------------------------------------------------*/
+static int
+read_accel(motion_frame_t *frame)
+{
+  /* A door at rest */
+  memset(frame->axis, 0, sizeof(frame->axis));
+  frame->axis[MOTION_BUFFER_AXIS_ACC_Z] = 100;
+
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+const mpu_wom_driver_t mpu_wom_mock_driver = {
+  "MPU-9250 mock",
+  arm,
+  disarm,
+  read_accel,
+};
+/*---------------------------------------------------------------------------*/
+/**
+ * @}
+ */
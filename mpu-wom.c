@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \addtogroup cc26xx-web-demo
+ * @{
+ *
+ * \file
+ *   MPU-9250 wake-on-motion driver for the SensorTag. Talks to the MPU
+ *   directly over I2C and takes the MPU interrupt line. Powering the chip up
+ *   and down is still left to the Contiki mpu_9250_sensor driver.
+ */
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+#include "board-i2c.h"
+#include "sensor-common.h"
+#include "gpio-interrupt.h"
+#include "ti-lib.h"
+#include "mpu-wom.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+#define DEBUG 0
+#if DEBUG
+#define PRINTF(...) printf(__VA_ARGS__)
+#else
+#define PRINTF(...)
+#endif
+/*---------------------------------------------------------------------------*/
+#define SENSOR_I2C_ADDRESS            0x68
+#define SENSOR_SELECT()   board_i2c_select(BOARD_I2C_INTERFACE_1, SENSOR_I2C_ADDRESS)
+#define SENSOR_DESELECT() board_i2c_deselect()
+/*---------------------------------------------------------------------------*/
+/* Registers */
+#define ACCEL_CONFIG_2                0x1D
+#define LP_ACCEL_ODR                  0x1E
+#define WOM_THR                       0x1F
+#define INT_PIN_CFG                   0x37
+#define INT_ENABLE                    0x38
+#define INT_STATUS                    0x3A
+#define ACCEL_XOUT_H                  0x3B
+#define MOT_DETECT_CTRL               0x69
+#define PWR_MGMT_1                    0x6B
+#define PWR_MGMT_2                    0x6C
+
+/* ACCEL_CONFIG_2: bypass the accel DLPF, as low-power mode requires */
+#define ACCEL_CONFIG_2_LP             0x09
+#define ACCEL_CONFIG_2_DEFAULT        0x00
+
+/* INT_PIN_CFG: active high, push-pull, 50 us pulse */
+#define INT_PIN_CFG_PULSE             0x00
+
+#define INT_ENABLE_WOM                0x40
+
+/* MOT_DETECT_CTRL: compare each sample against the previous one */
+#define MOT_DETECT_CTRL_WOM           0xC0
+
+#define PWR_MGMT_1_CYCLE              0x20
+#define PWR_MGMT_2_GYRO_OFF           0x07
+
+/* WOM_THR has a 4 mg LSB */
+#define WOM_THR_LSB_MG                   4
+/*---------------------------------------------------------------------------*/
+/*
+ * How often the MPU wakes up to compare samples while armed, as an
+ * LP_ACCEL_ODR code: 0 is 0.24 Hz, each step doubles it up to 11 (500 Hz).
+ * Higher rates catch shorter movements for a few more uA
+ */
+#ifdef MPU_WOM_CONF_LP_ODR
+#define LP_ODR MPU_WOM_CONF_LP_ODR
+#else
+#define LP_ODR                           5 /* 7.81 Hz */
+#endif
+
+/* Full-scale range, must match what the mpu_9250_sensor driver configures */
+#ifdef MPU_WOM_CONF_ACC_RANGE_G
+#define ACC_RANGE_G MPU_WOM_CONF_ACC_RANGE_G
+#else
+#define ACC_RANGE_G                      2
+#endif
+/*---------------------------------------------------------------------------*/
+static mpu_wom_callback_t callback;
+/*---------------------------------------------------------------------------*/
+static int
+write_reg(uint8_t reg, uint8_t val)
+{
+  return sensor_common_write_reg(reg, &val, 1);
+}
+/*---------------------------------------------------------------------------*/
+static void
+interrupt_handler(uint8_t ioid)
+{
+  mpu_wom_callback_t cb = callback;
+
+  /* One callback per arm() */
+  callback = NULL;
+  ti_lib_ioc_int_disable(BOARD_IOID_MPU_INT);
+
+  if(cb != NULL) {
+    cb();
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+arm(uint16_t threshold, mpu_wom_callback_t cb)
+{
+  uint16_t thr = threshold / WOM_THR_LSB_MG;
+  int rv;
+
+  if(thr == 0) {
+    thr = 1;
+  } else if(thr > 0xFF) {
+    thr = 0xFF;
+  }
+
+  SENSOR_SELECT();
+
+  rv = write_reg(PWR_MGMT_1, 0);
+  rv = rv && write_reg(PWR_MGMT_2, PWR_MGMT_2_GYRO_OFF);
+  rv = rv && write_reg(ACCEL_CONFIG_2, ACCEL_CONFIG_2_LP);
+  rv = rv && write_reg(INT_PIN_CFG, INT_PIN_CFG_PULSE);
+  rv = rv && write_reg(INT_ENABLE, INT_ENABLE_WOM);
+  rv = rv && write_reg(MOT_DETECT_CTRL, MOT_DETECT_CTRL_WOM);
+  rv = rv && write_reg(WOM_THR, thr);
+  rv = rv && write_reg(LP_ACCEL_ODR, LP_ODR);
+  rv = rv && write_reg(PWR_MGMT_1, PWR_MGMT_1_CYCLE);
+
+  SENSOR_DESELECT();
+
+  PRINTF("MPU WOM: arm at %u mg, rv=%d\n", thr * WOM_THR_LSB_MG, rv);
+
+  if(!rv) {
+    return 0;
+  }
+
+  callback = cb;
+
+  gpio_interrupt_register_handler(BOARD_IOID_MPU_INT, interrupt_handler);
+  ti_lib_ioc_port_configure_set(BOARD_IOID_MPU_INT, IOC_PORT_GPIO,
+                                IOC_STD_INPUT | IOC_RISING_EDGE |
+                                IOC_INT_ENABLE);
+  ti_lib_gpio_clear_event_dio(BOARD_IOID_MPU_INT);
+  ti_lib_ioc_int_enable(BOARD_IOID_MPU_INT);
+
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+disarm(void)
+{
+  uint8_t status;
+
+  ti_lib_ioc_int_disable(BOARD_IOID_MPU_INT);
+  callback = NULL;
+
+  SENSOR_SELECT();
+  write_reg(INT_ENABLE, 0);
+  write_reg(MOT_DETECT_CTRL, 0);
+  write_reg(PWR_MGMT_1, 0);
+  write_reg(PWR_MGMT_2, 0);
+  write_reg(ACCEL_CONFIG_2, ACCEL_CONFIG_2_DEFAULT);
+
+  /* Reading clears any motion flag raised meanwhile */
+  sensor_common_read_reg(INT_STATUS, &status, 1);
+  SENSOR_DESELECT();
+}
+/*---------------------------------------------------------------------------*/
+static int
+read_accel(motion_frame_t *frame)
+{
+  uint8_t buf[6];
+  int axis;
+  int rv;
+
+  SENSOR_SELECT();
+  rv = sensor_common_read_reg(ACCEL_XOUT_H, buf, sizeof(buf));
+  SENSOR_DESELECT();
+
+  if(!rv) {
+    return 0;
+  }
+
+  memset(frame->axis, 0, sizeof(frame->axis));
+  for(axis = MOTION_BUFFER_AXIS_ACC_X; axis <= MOTION_BUFFER_AXIS_ACC_Z;
+      axis++) {
+    /* Hundredths of a G, like mpu_9250_sensor.value() */
+    frame->axis[axis] = (int16_t)
+      (((int32_t)(int16_t)((buf[axis * 2] << 8) | buf[axis * 2 + 1]) *
+        (ACC_RANGE_G * 100)) / 32768);
+  }
+
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+const mpu_wom_driver_t mpu_wom_i2c_driver = {
+  "MPU-9250 I2C",
+  arm,
+  disarm,
+  read_accel,
+};
+/*---------------------------------------------------------------------------*/
+/**
+ * @}
+ */
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \addtogroup cc26xx-web-demo
+ * @{
+ *
+ * \file
+ *   Header file for MPU-9250 wake-on-motion.
+ *
+ *   While armed, the MPU runs its accelerometer alone in low-power cycle
+ *   mode and compares each sample against the previous one. A change above
+ *   the threshold on any axis raises the MPU interrupt line.
+ *
+ *   As with the FIFO, the hardware is accessed through a driver structure so
+ *   that a mock driver can stand in for the real sensor.
+ */
+/*---------------------------------------------------------------------------*/
+#ifndef MPU_WOM_H_
+#define MPU_WOM_H_
+/*---------------------------------------------------------------------------*/
+#include "motion-buffer.h"
+
+#include <stdint.h>
+/*---------------------------------------------------------------------------*/
+/* Driver used for wake-on-motion */
+#ifdef MPU_WOM_CONF_DRIVER
+#define MPU_WOM_DRIVER MPU_WOM_CONF_DRIVER
+#else
+#define MPU_WOM_DRIVER mpu_wom_i2c_driver
+#endif
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief Called when motion has been detected. May run in interrupt context,
+ *        so it should do little more than poll a process
+ */
+typedef void (*mpu_wom_callback_t)(void);
+
+/**
+ * \brief The structure of a driver giving access to MPU wake-on-motion
+ */
+typedef struct mpu_wom_driver {
+  char *name;
+
+  /**
+   * \brief Put the MPU in low-power cycle mode and enable its motion
+   *        interrupt. The sensor must already be powered
+   * \param threshold The threshold in mg. It gets rounded to 4 mg steps
+   * \param cb Called once motion has been detected
+   * \return 1 on success, 0 on error
+   *
+   * The driver calls back at most once per arm() call
+   */
+  int (*arm)(uint16_t threshold, mpu_wom_callback_t cb);
+
+  /**
+   * \brief Disable the motion interrupt and return the MPU to full power,
+   *        with accelerometer and gyro on
+   */
+  void (*disarm)(void);
+
+  /**
+   * \brief Read the accelerometer while armed, without disarming
+   * \param frame Receives the accelerometer axes. Gyro axes are zeroed, the
+   *        caller owns the timestamp and flags fields
+   * \return 1 on success, 0 on error
+   *
+   * Readings only change at the low-power sample rate
+   */
+  int (*read)(motion_frame_t *frame);
+} mpu_wom_driver_t;
+/*---------------------------------------------------------------------------*/
+extern const mpu_wom_driver_t mpu_wom_i2c_driver;
+extern const mpu_wom_driver_t mpu_wom_mock_driver;
+/*---------------------------------------------------------------------------*/
+#endif /* MPU_WOM_H_ */
+/*---------------------------------------------------------------------------*/
+/**
+ * @}
+ */
@@ -38,6 +38,7 @@
 #include "contiki-conf.h"
 #include "rpl/rpl-private.h"
 #include "mqtt.h"
+#include "mqtt-sn.h"
 #include "net/rpl/rpl.h"
 #include "net/ip/uip.h"
 #include "net/ipv6/uip-icmp6.h"
@@ -48,10 +49,24 @@
 #include "board-peripherals.h"
 #include "cc26xx-web-demo.h"
 #include "dev/leds.h"
+#include "lib/random.h"
 #include "mqtt-client.h"
 #include "httpd-simple.h"
 #include "batmon-sensor.h"
-
+#include "motion-buffer.h"
+#include "motion-features.h"
+#include "motion-fft.h"
+#include "door-detector.h"
+#include "sntp-client.h"
+#include "json-writer.h"
+#include "cbor-writer.h"
+#include "delta-codec.h"
+#include "publish-spool.h"
+#include "cycle-stats.h"
+#include "energy-stats.h"
+
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 // #include <strings.h>
 /*---------------------------------------------------------------------------*/
@@ -65,7 +80,18 @@
  */
  //the follow address is for quickstart only 
 //static const char *broker_ip = "0064:ff9b:0000:0000:0000:0000:b8ac:7cbd";
+#ifdef MQTT_CLIENT_CONF_BROKER_IP_ADDR
+static const char *broker_ip = MQTT_CLIENT_CONF_BROKER_IP_ADDR;
+#else
 static const char *broker_ip = "0064:ff9b:0000:0000:0000:0000:17f6:e8d2";
+#endif
+/*---------------------------------------------------------------------------*/
+/* One line per window and per PUBACK, to be picked up by benchmark scripts */
+#if MQTT_CLIENT_BENCH
+#define BENCH(...) printf("bench: " __VA_ARGS__)
+#else
+#define BENCH(...)
+#endif
 /*---------------------------------------------------------------------------*/
 /*
  * A timeout used when waiting for something to happen (e.g. to connect or to
@@ -81,18 +107,23 @@ static const char *broker_ip = "0064:ff9b:0000:0000:0000:0000:17f6:e8d2";
 #define PUBLISH_LED_ON_DURATION    (CLOCK_SECOND)
 /*---------------------------------------------------------------------------*/
 /* Connections and reconnections */
-#define RETRY_FOREVER              0xFF
-#define RECONNECT_INTERVAL         (CLOCK_SECOND * 2)
+#define CONNECTION_STABLE_TIME     (CLOCK_SECOND * 5)
+#define NEW_CONFIG_WAIT_INTERVAL   (CLOCK_SECOND * 20)
 
 /*
- * Number of times to try reconnecting to the broker.
- * Can be a limited number (e.g. 3, 10 etc) or can be set to RETRY_FOREVER
+ * The MQTT engine tells us when it is done with a publish, but not when TCP
+ * has had its last segment acknowledged. Meanwhile, check at this pace
  */
-#define RECONNECT_ATTEMPTS         5
-#define CONNECTION_STABLE_TIME     (CLOCK_SECOND * 5)
-#define NEW_CONFIG_WAIT_INTERVAL   (CLOCK_SECOND * 20)
+#define DRAIN_CHECK_INTERVAL       (CLOCK_SECOND >> 2)
+
+/* Pace at which spooled payloads get replayed once the broker is back */
+#define SPOOL_REPLAY_INTERVAL      (CLOCK_SECOND)
 static struct timer connection_life;
 static uint8_t connect_attempt;
+
+/* No connection attempts until this expires */
+static struct timer reconnect_wait;
+static mqtt_client_reconnect_stats_t reconnect_stats;
 /*---------------------------------------------------------------------------*/
 /* Various states */
 static uint8_t state;
@@ -106,8 +137,42 @@ static uint8_t state;
 #define MQTT_CLIENT_STATE_CONFIG_ERROR 0xFE
 #define MQTT_CLIENT_STATE_ERROR        0xFF
 /*---------------------------------------------------------------------------*/
-/* Maximum TCP segment size for outgoing segments of our socket */
+/*
+ * The transport of the current connection. A new one only takes over once
+ * the old connection is down
+ */
+static uint8_t transport = MQTT_CLIENT_TRANSPORT_TCP;
+/*---------------------------------------------------------------------------*/
+/*
+ * Maximum TCP segment size for outgoing segments of our socket. The floor of
+ * the frame-aware size
+ */
 #define MQTT_CLIENT_MAX_SEGMENT_SIZE    32
+
+/* The 802.15.4 PHY payload, and what the MAC leaves of it for 6LoWPAN */
+#define FRAME_MAX_LEN                  127
+#define FRAME_PAYLOAD_LEN \
+  (FRAME_MAX_LEN - MQTT_CLIENT_FRAME_MAC_OVERHEAD)
+
+/* IPHC dispatch and encoding bytes, plus the inline next header */
+#define FRAME_IPHC_BASE_LEN              3
+
+/* Contiki carries RPL's hop-by-hop option uncompressed */
+#if UIP_CONF_IPV6_RPL
+#define FRAME_RPL_OPTION_LEN             8
+#else
+#define FRAME_RPL_OPTION_LEN             0
+#endif
+
+/* 6LoWPAN fragment headers. Fragments carry multiples of 8 bytes */
+#define FRAME_FRAG1_LEN                  4
+#define FRAME_FRAGN_LEN                  5
+#define FRAME_FRAGN_PAYLOAD \
+  ((FRAME_PAYLOAD_LEN - FRAME_FRAGN_LEN) & ~7)
+
+/* Compressed IPv6 header and extension bytes towards the broker */
+static uint8_t link_header_len;
+static mqtt_client_link_stats_t link_stats;
 /*---------------------------------------------------------------------------*/
 /*
  * Buffers for Client ID and Topic.
@@ -121,28 +186,131 @@ static uint8_t state;
 static char client_id[BUFFER_SIZE];
 static char pub_topic[BUFFER_SIZE];
 static char sub_topic[BUFFER_SIZE];
+static char alt_topic[BUFFER_SIZE]; /* For payloads of a previous format */
+static char status_topic[BUFFER_SIZE];
+#if CC26XX_WEB_DEMO_DOOR_EVENTS
+static char door_topic[BUFFER_SIZE];
+#endif
+
+/* Event type of the status message */
+#define STATUS_EVENT_TYPE "stats"
+
+/* Event type of door events */
+#define DOOR_EVENT_TYPE "door"
 /*---------------------------------------------------------------------------*/
 /*
  * The main MQTT buffers.
  * We will need to increase if we start publishing more data.
+ *
+ * Payloads are sent straight from these, so a buffer stays busy until the
+ * MQTT engine has sent it and, with QoS 1, until the broker has acknowledged
+ * it. Over MQTT-SN, the number of buffers is also the QoS 1 in-flight window.
+ * Over TCP, the engine keeps out_queue_full set until the PUBACK, so only one
+ * QoS 1 publish is ever in flight there and the rest stay pending.
+ *
+ * While the engine is still busy with a previous packet, the next window gets
+ * serialized into a spare buffer and waits there as pending.
  */
 #define APP_BUFFER_SIZE 1024
 static struct mqtt_connection conn;
-static char app_buffer[APP_BUFFER_SIZE];
+
+#define PUBLISH_SLOT_FREE      0
+#define PUBLISH_SLOT_SENDING   1 /* QoS 0: until the engine has sent it */
+#define PUBLISH_SLOT_UNACKED   2 /* QoS 1: until the PUBACK */
+#define PUBLISH_SLOT_PENDING   3 /* Serialized, waiting for the engine */
+
+#define PUBLISH_KIND_MOTION    0
+#define PUBLISH_KIND_STATUS    1
+#define PUBLISH_KIND_DOOR      2 /* Jumps the queue of pending payloads */
+
+typedef struct publish_slot {
+  clock_time_t sent; /* When sent or, if pending, when queued */
+  uint16_t mid;
+  uint16_t len;
+  uint8_t state;
+  uint8_t kind;
+  uint8_t format;
+  uint8_t retries;
+  uint8_t spooled; /* The payload came from the spool */
+  char buf[APP_BUFFER_SIZE];
+} publish_slot_t;
+
+static publish_slot_t slots[MQTT_CLIENT_INFLIGHT_MAX];
+
+/* QoS 1 retransmissions */
+#define PUBACK_TIMEOUT             (CLOCK_SECOND * 5)
+#define PUBLISH_MAX_RETRIES        3
+
+/* Scratch space for one delta-encoded axis, before it is copied into CBOR */
+#define DELTA_BUFFER_SIZE \
+  (MQTT_CLIENT_BATCH_SIZE_MAX * DELTA_CODEC_MAX_BYTES_PER_VALUE)
+static uint8_t delta_buffer[DELTA_BUFFER_SIZE];
 /*---------------------------------------------------------------------------*/
 #define QUICKSTART "quickstart"
 /*---------------------------------------------------------------------------*/
+/* Bytes of the link-layer address used as the node ID in publishes */
+#define MQTT_CLIENT_NODE_ID_LEN 6
+
+/* Integer map keys of the CBOR motion payload. See README.md */
+#define CBOR_PAYLOAD_VERSION    1
+#define CBOR_KEY_VERSION        0
+#define CBOR_KEY_NODE_ID        1
+#define CBOR_KEY_SEQ            2
+#define CBOR_KEY_ALIVE          3
+#define CBOR_KEY_START          4
+#define CBOR_KEY_PUB_INTERVAL   5
+#define CBOR_KEY_BATT_VOLT      6
+#define CBOR_KEY_PRETRIGGER     7
+#define CBOR_KEY_SAMPLES        8
+#define CBOR_KEY_FFT_SIZE       9
+#define CBOR_KEY_HEARTBEAT     10
+#define CBOR_KEY_TIME_DELTAS   11
+#define CBOR_KEY_UTC           12
+#define CBOR_KEY_AXIS_BASE     16 /* + MOTION_BUFFER_AXIS_xyz */
+#define CBOR_KEY_FEATURES_BASE 32 /* + MOTION_BUFFER_AXIS_xyz */
+#define CBOR_KEY_SPECTRUM_BASE 48 /* + MOTION_BUFFER_AXIS_ACC_xyz */
+
+/* Number of map entries that are always present (keys 0 to 5) */
+#define CBOR_KEY_FIXED_ENTRIES  6
+/*---------------------------------------------------------------------------*/
 static struct mqtt_message *msg_ptr = 0;
 static struct etimer publish_periodic_timer;
-static struct etimer append_periodic_timer;
+static struct etimer batch_timer; /* Publish a partial batch on expiry */
+static struct etimer inflight_timer;
+static struct etimer drain_timer;
+static struct etimer status_timer;
+#if CC26XX_WEB_DEMO_PUBLISH_SPOOL
+static struct etimer spool_timer;
+
+/* Serializes batches for the spool. The slots may all be taken by then */
+static char spool_buf[APP_BUFFER_SIZE];
+#endif
 static struct ctimer ct;
-static char *buf_ptr;
 static uint16_t seq_nr_value = 0;
 
-static uint32_t start_time = 0;
-static uint32_t stop_time = 0;
-static uint32_t start_time_send = 0;
-static uint32_t stop_time_send = 0;
+/* Number of samples taken towards the current batch */
+static uint16_t window_fill = 0;
+static uint32_t window_seen = 0;
+
+/*
+ * Report by exception: the battery voltage goes out when it has moved past
+ * its deadband since we last sent it. Decided once per message
+ */
+static int batt_volt_sent = CC26XX_SENSOR_READING_ERROR;
+static uint8_t batt_volt_due;
+
+#if CC26XX_WEB_DEMO_DOOR_EVENTS
+/*
+ * The latest door event, while it waits for a free buffer. A newer event
+ * replaces it: only the current state of the door matters
+ */
+static door_detector_event_t door_queued_event;
+static uint8_t door_queued;
+static uint16_t door_seq_nr;
+
+/* Motion windows are published on request only. See the rawd command */
+static uint8_t raw_requested;
+#endif
 /*---------------------------------------------------------------------------*/
 static uip_ip6addr_t def_route;
 /*---------------------------------------------------------------------------*/
@@ -161,6 +329,181 @@ publish_led_off(void *d)
   leds_off(CC26XX_WEB_DEMO_STATUS_LED);
 }
 /*---------------------------------------------------------------------------*/
+#if CC26XX_WEB_DEMO_MQTT_SN
+#define TRANSPORT_IS_SN() (transport == MQTT_CLIENT_TRANSPORT_MQTT_SN)
+#else
+#define TRANSPORT_IS_SN() 0
+#endif
+/*---------------------------------------------------------------------------*/
+/* Returns 1 if the transport can take a publish right now */
+static int
+transport_ready(void)
+{
+#if CC26XX_WEB_DEMO_MQTT_SN
+  if(TRANSPORT_IS_SN()) {
+    return mqtt_sn_ready();
+  }
+#endif
+  return mqtt_ready(&conn) && conn.out_buffer_sent;
+}
+/*---------------------------------------------------------------------------*/
+/* Returns 1 once the last publish has left the transport's buffers */
+static int
+transport_sent(void)
+{
+  /* MQTT-SN sends each publish as one datagram, straight away */
+  return TRANSPORT_IS_SN() || conn.out_buffer_sent;
+}
+/*---------------------------------------------------------------------------*/
+static void
+transport_disconnect(void)
+{
+#if CC26XX_WEB_DEMO_MQTT_SN
+  if(TRANSPORT_IS_SN()) {
+    mqtt_sn_disconnect();
+    return;
+  }
+#endif
+  mqtt_disconnect(&conn);
+}
+/*---------------------------------------------------------------------------*/
+static int
+transport_disconnected(void)
+{
+#if CC26XX_WEB_DEMO_MQTT_SN
+  if(TRANSPORT_IS_SN()) {
+    return mqtt_sn_disconnected();
+  }
+#endif
+  return conn.state == MQTT_CONN_STATE_NOT_CONNECTED;
+}
+/*---------------------------------------------------------------------------*/
+/* The configured QoS. -1 falls back to 0 over TCP */
+static int8_t
+publish_qos(void)
+{
+  if(conf->qos < 0 && !TRANSPORT_IS_SN()) {
+    return 0;
+  }
+
+  return conf->qos;
+}
+/*---------------------------------------------------------------------------*/
+/* The largest payload the transport can send */
+static uint16_t
+payload_limit(void)
+{
+#if CC26XX_WEB_DEMO_MQTT_SN && MQTT_SN_MAX_PAYLOAD < APP_BUFFER_SIZE
+  if(TRANSPORT_IS_SN()) {
+    return MQTT_SN_MAX_PAYLOAD;
+  }
+#endif
+  return APP_BUFFER_SIZE;
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Bytes of IPv6 header left after IPHC. Our own address is assumed to be
+ * the context prefix plus an interface ID derived from our MAC address
+ */
+static uint8_t
+iphc_header_len(void)
+{
+  uip_ds6_addr_t *own = uip_ds6_get_global(ADDR_PREFERRED);
+  uip_ip6addr_t broker;
+  uint8_t len = FRAME_IPHC_BASE_LEN + FRAME_RPL_OPTION_LEN;
+
+  if(!MQTT_CLIENT_FRAME_CONTEXT || own == NULL) {
+    return len + 2 * sizeof(uip_ipaddr_t);
+  }
+
+  if(uiplib_ipaddrconv(conf->broker_ip, &broker) &&
+     memcmp(&broker, &own->ipaddr, sizeof(uip_ipaddr_t) / 2) == 0) {
+    /* On our prefix: only the interface ID goes inline */
+    return len + sizeof(uip_ipaddr_t) / 2;
+  }
+
+  return len + sizeof(uip_ipaddr_t);
+}
+/*---------------------------------------------------------------------------*/
+/* Radio frames for a datagram of len bytes after hdr bytes of headers */
+static uint16_t
+datagram_frames(uint16_t hdr, uint16_t len)
+{
+  uint16_t first;
+
+  if(hdr + len <= FRAME_PAYLOAD_LEN) {
+    return 1;
+  }
+
+  /* The first fragment also carries the headers */
+  first = (FRAME_PAYLOAD_LEN - FRAME_FRAG1_LEN - hdr) & ~7;
+  len = len > first ? len - first : 0;
+
+  return 1 + (len + FRAME_FRAGN_PAYLOAD - 1) / FRAME_FRAGN_PAYLOAD;
+}
+/*---------------------------------------------------------------------------*/
+/* MQTT bytes per TCP segment, with each segment filling one frame */
+static uint16_t
+frame_segment_size(void)
+{
+#if MQTT_CLIENT_FRAME_AWARE
+  int size = FRAME_PAYLOAD_LEN - link_header_len - UIP_TCPH_LEN;
+
+  if(size > UIP_TCP_MSS) {
+    size = UIP_TCP_MSS;
+  } else if(size < MQTT_CLIENT_MAX_SEGMENT_SIZE) {
+    size = MQTT_CLIENT_MAX_SEGMENT_SIZE;
+  }
+
+  return size;
+#else
+  return MQTT_CLIENT_MAX_SEGMENT_SIZE;
+#endif
+}
+/*---------------------------------------------------------------------------*/
+/* Accounts for the segments and frames of a publish that just went out */
+static void
+count_frames(const char *topic, uint16_t len, int8_t qos)
+{
+  uint32_t remaining;
+  uint32_t packet;
+  uint16_t seg = link_stats.segment_size;
+  uint16_t hdr;
+
+  if(TRANSPORT_IS_SN()) {
+    /* One datagram. The length field grows past 255 bytes */
+    packet = len + (len + 7 <= 0xFF ? 7 : 9);
+    hdr = link_header_len + UIP_UDPH_LEN;
+    link_stats.last_segments = 1;
+    link_stats.last_frames = datagram_frames(hdr, packet);
+  } else {
+    /* Fixed header, remaining length, topic, message ID and payload */
+    remaining = 2 + strlen(topic) + (qos > 0 ? 2 : 0) + len;
+    packet = 1 + (remaining < 128 ? 1 : remaining < 16384 ? 2 : 3) +
+      remaining;
+    hdr = link_header_len + UIP_TCPH_LEN;
+    if(seg == 0) {
+      /* Not connected over TCP yet */
+      return;
+    }
+    link_stats.last_segments = (packet + seg - 1) / seg;
+    link_stats.last_frames = (packet / seg) * datagram_frames(hdr, seg);
+    if(packet % seg) {
+      link_stats.last_frames += datagram_frames(hdr, packet % seg);
+    }
+  }
+
+  link_stats.publishes++;
+  link_stats.segments += link_stats.last_segments;
+  link_stats.frames += link_stats.last_frames;
+}
+/*---------------------------------------------------------------------------*/
+const mqtt_client_link_stats_t *
+mqtt_client_link_stats(void)
+{
+  return &link_stats;
+}
+/*---------------------------------------------------------------------------*/
 static void
 new_net_config(void)
 {
@@ -179,7 +522,7 @@ new_net_config(void)
   state = MQTT_CLIENT_STATE_NEWCONFIG;
 
   etimer_stop(&publish_periodic_timer);
-  mqtt_disconnect(&conn);
+  transport_disconnect();
 }
 /*---------------------------------------------------------------------------*/
 static int
@@ -331,6 +674,179 @@ interval_post_handler(char *key, int key_len, char *val, int val_len)
 }
 /*---------------------------------------------------------------------------*/
 static int
+qos_post_handler(char *key, int key_len, char *val, int val_len)
+{
+  int rv = 0;
+
+  if(key_len != strlen("qos") ||
+     strncasecmp(key, "qos", strlen("qos")) != 0) {
+    /* Not ours */
+    return HTTPD_SIMPLE_POST_HANDLER_UNKNOWN;
+  }
+
+  rv = atoi(val);
+
+  /* QoS 2 is not supported. QoS -1 is for MQTT-SN */
+  if(rv != 0 && rv != 1 && (rv != -1 || !CC26XX_WEB_DEMO_MQTT_SN)) {
+    return HTTPD_SIMPLE_POST_HANDLER_ERROR;
+  }
+
+  if((rv < 0) != (conf->qos < 0)) {
+    /* QoS -1 publishes without a session. Reconnect into or out of that */
+    conf->qos = rv;
+    new_net_config();
+    return HTTPD_SIMPLE_POST_HANDLER_OK;
+  }
+
+  conf->qos = rv;
+
+  return HTTPD_SIMPLE_POST_HANDLER_OK;
+}
+/*---------------------------------------------------------------------------*/
+static int
+transport_post_handler(char *key, int key_len, char *val, int val_len)
+{
+  int rv = 0;
+
+  if(key_len != strlen("transport") ||
+     strncasecmp(key, "transport", strlen("transport")) != 0) {
+    /* Not ours */
+    return HTTPD_SIMPLE_POST_HANDLER_UNKNOWN;
+  }
+
+  rv = atoi(val);
+
+  if(rv < 0 || rv > MQTT_CLIENT_TRANSPORT_MAX ||
+     (rv == MQTT_CLIENT_TRANSPORT_MQTT_SN && !CC26XX_WEB_DEMO_MQTT_SN)) {
+    return HTTPD_SIMPLE_POST_HANDLER_ERROR;
+  }
+
+  if(rv != conf->transport) {
+    conf->transport = rv;
+    new_net_config();
+  }
+
+  return HTTPD_SIMPLE_POST_HANDLER_OK;
+}
+/*---------------------------------------------------------------------------*/
+static void
+resize_motion_buffer(void)
+{
+  if(conf->batch_size < MQTT_CLIENT_BATCH_SIZE_MIN ||
+     conf->batch_size > MQTT_CLIENT_BATCH_SIZE_MAX) {
+    conf->batch_size = CC26XX_WEB_DEMO_DEFAULT_BATCH_SIZE;
+  }
+
+  if(conf->publish_mode > MQTT_CLIENT_PUBLISH_MODE_MAX) {
+    conf->publish_mode = CC26XX_WEB_DEMO_DEFAULT_PUBLISH_MODE;
+  }
+
+  if(conf->publish_mode == MQTT_CLIENT_PUBLISH_MODE_FEATURES) {
+    /* Frames only wait here until they are folded. Absorb large FIFO drains */
+    motion_buffer_init(MOTION_BUFFER_MAX_CAPACITY);
+  } else {
+    /* Room for the batch being sent and the one filling up behind it */
+    motion_buffer_init(conf->batch_size * 2);
+  }
+  motion_features_reset();
+  window_fill = 0;
+  window_seen = 0;
+}
+/*---------------------------------------------------------------------------*/
+/* A saved configuration may ask for a transport this build lacks */
+static void
+check_transport_config(void)
+{
+  if(conf->transport > MQTT_CLIENT_TRANSPORT_MAX ||
+     (conf->transport == MQTT_CLIENT_TRANSPORT_MQTT_SN &&
+      !CC26XX_WEB_DEMO_MQTT_SN)) {
+    conf->transport = CC26XX_WEB_DEMO_DEFAULT_TRANSPORT;
+  }
+
+  if(conf->qos < -1 || conf->qos > 1) {
+    conf->qos = CC26XX_WEB_DEMO_DEFAULT_QOS;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+batch_size_post_handler(char *key, int key_len, char *val, int val_len)
+{
+  int rv = 0;
+
+  if(key_len != strlen("batch_size") ||
+     strncasecmp(key, "batch_size", strlen("batch_size")) != 0) {
+    /* Not ours */
+    return HTTPD_SIMPLE_POST_HANDLER_UNKNOWN;
+  }
+
+  rv = atoi(val);
+
+  if(rv < MQTT_CLIENT_BATCH_SIZE_MIN || rv > MQTT_CLIENT_BATCH_SIZE_MAX) {
+    return HTTPD_SIMPLE_POST_HANDLER_ERROR;
+  }
+
+  if(conf->batch_size != rv) {
+    /* Buffered samples are discarded */
+    conf->batch_size = rv;
+    resize_motion_buffer();
+  }
+
+  return HTTPD_SIMPLE_POST_HANDLER_OK;
+}
+/*---------------------------------------------------------------------------*/
+static int
+payload_format_post_handler(char *key, int key_len, char *val, int val_len)
+{
+  int rv = 0;
+
+  if(key_len != strlen("payload_format") ||
+     strncasecmp(key, "payload_format", strlen("payload_format")) != 0) {
+    /* Not ours */
+    return HTTPD_SIMPLE_POST_HANDLER_UNKNOWN;
+  }
+
+  rv = atoi(val);
+
+  if(rv < MQTT_CLIENT_PAYLOAD_FORMAT_JSON ||
+     rv > MQTT_CLIENT_PAYLOAD_FORMAT_MAX) {
+    return HTTPD_SIMPLE_POST_HANDLER_ERROR;
+  }
+
+  conf->payload_format = rv;
+
+  /* The publish topic carries the format */
+  new_net_config();
+
+  return HTTPD_SIMPLE_POST_HANDLER_OK;
+}
+/*---------------------------------------------------------------------------*/
+static int
+publish_mode_post_handler(char *key, int key_len, char *val, int val_len)
+{
+  int rv = 0;
+
+  if(key_len != strlen("publish_mode") ||
+     strncasecmp(key, "publish_mode", strlen("publish_mode")) != 0) {
+    /* Not ours */
+    return HTTPD_SIMPLE_POST_HANDLER_UNKNOWN;
+  }
+
+  rv = atoi(val);
+
+  if(rv < MQTT_CLIENT_PUBLISH_MODE_RAW || rv > MQTT_CLIENT_PUBLISH_MODE_MAX) {
+    return HTTPD_SIMPLE_POST_HANDLER_ERROR;
+  }
+
+  if(conf->publish_mode != rv) {
+    /* Buffered samples are discarded */
+    conf->publish_mode = rv;
+    resize_motion_buffer();
+  }
+
+  return HTTPD_SIMPLE_POST_HANDLER_OK;
+}
+/*---------------------------------------------------------------------------*/
+static int
 port_post_handler(char *key, int key_len, char *val, int val_len)
 {
   int rv = 0;
@@ -402,6 +918,11 @@ HTTPD_SIMPLE_POST_HANDLER(auth_token, auth_token_post_handler);
 HTTPD_SIMPLE_POST_HANDLER(ip_addr, ip_addr_post_handler);
 HTTPD_SIMPLE_POST_HANDLER(port, port_post_handler);
 HTTPD_SIMPLE_POST_HANDLER(interval, interval_post_handler);
+HTTPD_SIMPLE_POST_HANDLER(batch_size, batch_size_post_handler);
+HTTPD_SIMPLE_POST_HANDLER(qos, qos_post_handler);
+HTTPD_SIMPLE_POST_HANDLER(transport, transport_post_handler);
+HTTPD_SIMPLE_POST_HANDLER(payload_format, payload_format_post_handler);
+HTTPD_SIMPLE_POST_HANDLER(publish_mode, publish_mode_post_handler);
 HTTPD_SIMPLE_POST_HANDLER(reconnect, reconnect_post_handler);
 /*---------------------------------------------------------------------------*/
 static void
@@ -431,6 +952,18 @@ pub_handler(const char *topic, uint16_t topic_len, const uint8_t *chunk,
     return;
   }
 
+#if CC26XX_WEB_DEMO_DOOR_EVENTS
+  if(strncmp(&topic[10], "rawd", 4) == 0) {
+    /* Raw motion windows on or off, on top of door events */
+    if(chunk[0] == '1') {
+      raw_requested = 1;
+    } else if(chunk[0] == '0') {
+      raw_requested = 0;
+    }
+    return;
+  }
+#endif
+
 #if BOARD_SENSORTAG
   if(strncmp(&topic[10], "buzz", 4) == 0) {
     if(chunk[0] == '1') {
@@ -443,24 +976,47 @@ pub_handler(const char *topic, uint16_t topic_len, const uint8_t *chunk,
 #endif
 }
 /*---------------------------------------------------------------------------*/
+static void handle_puback(uint16_t mid);
+static void flush_pending(void);
+#if CC26XX_WEB_DEMO_PUBLISH_SPOOL
+static void spool_slots(void);
+#endif
+/*---------------------------------------------------------------------------*/
+static void
+handle_connected(void)
+{
+  reconnect_stats.connects++;
+  timer_set(&connection_life, CONNECTION_STABLE_TIME);
+  state = MQTT_CLIENT_STATE_CONNECTED;
+}
+/*---------------------------------------------------------------------------*/
+static void
+handle_disconnected(void)
+{
+#if CC26XX_WEB_DEMO_PUBLISH_SPOOL
+  spool_slots();
+#endif
+
+  /* Do nothing if the disconnect was the result of an incoming config */
+  if(state != MQTT_CLIENT_STATE_NEWCONFIG) {
+    reconnect_stats.failures++;
+    state = MQTT_CLIENT_STATE_DISCONNECTED;
+    process_poll(&mqtt_client_process);
+  }
+}
+/*---------------------------------------------------------------------------*/
 static void
 mqtt_event(struct mqtt_connection *m, mqtt_event_t event, void *data)
 {
   switch(event) {
   case MQTT_EVENT_CONNECTED: {
     DBG("APP - Application has a MQTT connection\n");
-    timer_set(&connection_life, CONNECTION_STABLE_TIME);
-    state = MQTT_CLIENT_STATE_CONNECTED;
+    handle_connected();
     break;
   }
   case MQTT_EVENT_DISCONNECTED: {
     DBG("APP - MQTT Disconnect. Reason %u\n", *((mqtt_event_t *)data));
-
-    /* Do nothing if the disconnect was the result of an incoming config */
-    if(state != MQTT_CLIENT_STATE_NEWCONFIG) {
-      state = MQTT_CLIENT_STATE_DISCONNECTED;
-      process_poll(&mqtt_client_process);
-    }
+    handle_disconnected();
     break;
   }
   case MQTT_EVENT_PUBLISH: {
@@ -488,7 +1044,8 @@ mqtt_event(struct mqtt_connection *m, mqtt_event_t event, void *data)
   }
   case MQTT_EVENT_PUBACK: {
     DBG("APP - Publishing complete.\n");
-    break;    
+    handle_puback(*((uint16_t *)data));
+    break;
   }
   default:
     DBG("APP - Application got a unhandled MQTT event: %i\n", event);
@@ -496,22 +1053,95 @@ mqtt_event(struct mqtt_connection *m, mqtt_event_t event, void *data)
   }
 }
 /*---------------------------------------------------------------------------*/
-static int
-construct_pub_topic(void)
+#if CC26XX_WEB_DEMO_MQTT_SN
+static void
+mqtt_sn_event(mqtt_sn_event_t event, void *data)
 {
-  int len = snprintf(pub_topic, BUFFER_SIZE, "iot-2/evt/%s/fmt/json",
-                     conf->event_type_id);
-
-  /* len < 0: Error. Len >= BUFFER_SIZE: Buffer too small */
-  if(len < 0 || len >= BUFFER_SIZE) {
-    printf("Pub Topic: %d, Buffer %d\n", len, BUFFER_SIZE);
-    return 0;
-  }
+  mqtt_sn_message_t *msg;
 
-  return 1;
-}
-/*---------------------------------------------------------------------------*/
-static int
+  switch(event) {
+  case MQTT_SN_EVENT_CONNECTED:
+    DBG("APP - Application has a MQTT-SN connection\n");
+    handle_connected();
+    break;
+  case MQTT_SN_EVENT_DISCONNECTED:
+    DBG("APP - MQTT-SN Disconnect\n");
+    handle_disconnected();
+    break;
+  case MQTT_SN_EVENT_REGACK:
+    /* A publish may have been waiting for its topic ID */
+    flush_pending();
+    break;
+  case MQTT_SN_EVENT_SUBACK:
+    DBG("APP - Application is subscribed to topic successfully\n");
+    break;
+  case MQTT_SN_EVENT_PUBLISH:
+    msg = data;
+    pub_handler(msg->topic, strlen(msg->topic), msg->payload,
+                msg->payload_length);
+    break;
+  case MQTT_SN_EVENT_PUBACK:
+    handle_puback(*((uint16_t *)data));
+    break;
+  }
+}
+#endif
+/*---------------------------------------------------------------------------*/
+static int
+construct_topic_for_format(char *buf, uint8_t format)
+{
+  return snprintf(buf, BUFFER_SIZE, "iot-2/evt/%s/fmt/%s",
+                  conf->event_type_id,
+                  format == MQTT_CLIENT_PAYLOAD_FORMAT_JSON ? "json" : "cbor");
+}
+/*---------------------------------------------------------------------------*/
+static int
+construct_pub_topic(void)
+{
+  int len = construct_topic_for_format(pub_topic, conf->payload_format);
+
+  /* len < 0: Error. Len >= BUFFER_SIZE: Buffer too small */
+  if(len < 0 || len >= BUFFER_SIZE) {
+    printf("Pub Topic: %d, Buffer %d\n", len, BUFFER_SIZE);
+    return 0;
+  }
+
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+construct_status_topic(void)
+{
+  int len = snprintf(status_topic, BUFFER_SIZE, "iot-2/evt/%s/fmt/json",
+                     STATUS_EVENT_TYPE);
+
+  /* len < 0: Error. Len >= BUFFER_SIZE: Buffer too small */
+  if(len < 0 || len >= BUFFER_SIZE) {
+    printf("Status Topic: %d, Buffer %d\n", len, BUFFER_SIZE);
+    return 0;
+  }
+
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+#if CC26XX_WEB_DEMO_DOOR_EVENTS
+static int
+construct_door_topic(void)
+{
+  int len = snprintf(door_topic, BUFFER_SIZE, "iot-2/evt/%s/fmt/json",
+                     DOOR_EVENT_TYPE);
+
+  /* len < 0: Error. Len >= BUFFER_SIZE: Buffer too small */
+  if(len < 0 || len >= BUFFER_SIZE) {
+    printf("Door Topic: %d, Buffer %d\n", len, BUFFER_SIZE);
+    return 0;
+  }
+
+  return 1;
+}
+#endif
+/*---------------------------------------------------------------------------*/
+static int
 construct_sub_topic(void)
 {
   int len = snprintf(sub_topic, BUFFER_SIZE, "iot-2/cmd/%s/fmt/json",
@@ -522,324 +1152,1467 @@ construct_sub_topic(void)
     printf("Sub Topic: %d, Buffer %d\n", len, BUFFER_SIZE);
     return 0;
   }
-
-  return 1;
+
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+construct_client_id(void)
+{
+  int len = snprintf(client_id, BUFFER_SIZE, "d:%s:%s:%02x%02x%02x%02x%02x%02x",
+                     conf->org_id, conf->type_id,
+                     linkaddr_node_addr.u8[0], linkaddr_node_addr.u8[1],
+                     linkaddr_node_addr.u8[2], linkaddr_node_addr.u8[5],
+                     linkaddr_node_addr.u8[6], linkaddr_node_addr.u8[7]);
+
+  /* len < 0: Error. Len >= BUFFER_SIZE: Buffer too small */
+  if(len < 0 || len >= BUFFER_SIZE) {
+    printf("Client ID: %d, Buffer %d\n", len, BUFFER_SIZE);
+    return 0;
+  }
+
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+update_config(void)
+{
+  if(construct_client_id() == 0) {
+    /* Fatal error. Client ID larger than the buffer */
+    state = MQTT_CLIENT_STATE_CONFIG_ERROR;
+    return;
+  }
+
+  if(construct_sub_topic() == 0) {
+    /* Fatal error. Topic larger than the buffer */
+    state = MQTT_CLIENT_STATE_CONFIG_ERROR;
+    return;
+  }
+
+  if(construct_pub_topic() == 0) {
+    /* Fatal error. Topic larger than the buffer */
+    state = MQTT_CLIENT_STATE_CONFIG_ERROR;
+    return;
+  }
+
+  if(construct_status_topic() == 0) {
+    /* Fatal error. Topic larger than the buffer */
+    state = MQTT_CLIENT_STATE_CONFIG_ERROR;
+    return;
+  }
+
+#if CC26XX_WEB_DEMO_DOOR_EVENTS
+  if(construct_door_topic() == 0) {
+    /* Fatal error. Topic larger than the buffer */
+    state = MQTT_CLIENT_STATE_CONFIG_ERROR;
+    return;
+  }
+#endif
+
+  /* Reset the counter */
+  seq_nr_value = 0;
+
+  state = MQTT_CLIENT_STATE_INIT;
+
+  /*
+   * Schedule next timer event ASAP
+   *
+   * If we entered an error state then we won't do anything when it fires.
+   *
+   * Since the error at this stage is a config error, we will only exit this
+   * error state if we get a new config.
+   */
+  etimer_set(&batch_timer, 0);
+  return;
+}
+/*---------------------------------------------------------------------------*/
+static int
+init_config()
+{
+  /* Populate configuration with default values */
+  memset(conf, 0, sizeof(mqtt_client_config_t));
+
+  memcpy(conf->org_id, CC26XX_WEB_DEMO_DEFAULT_ORG_ID, 11);
+  memcpy(conf->type_id, CC26XX_WEB_DEMO_DEFAULT_TYPE_ID, 7);
+  memcpy(conf->event_type_id, CC26XX_WEB_DEMO_DEFAULT_EVENT_TYPE_ID, 7);
+  memcpy(conf->broker_ip, broker_ip, strlen(broker_ip));
+  memcpy(conf->cmd_type, CC26XX_WEB_DEMO_DEFAULT_SUBSCRIBE_CMD_TYPE, 1);
+  memcpy(conf->auth_token, cc26XX_WEB_DEMO_DEFAULT_AUTH_TOKEN, strlen(cc26XX_WEB_DEMO_DEFAULT_AUTH_TOKEN));
+  conf->broker_port = CC26XX_WEB_DEMO_DEFAULT_BROKER_PORT;
+  conf->pub_interval = CC26XX_WEB_DEMO_DEFAULT_PUBLISH_INTERVAL;
+  conf->batch_size = CC26XX_WEB_DEMO_DEFAULT_BATCH_SIZE;
+  conf->payload_format = CC26XX_WEB_DEMO_DEFAULT_PAYLOAD_FORMAT;
+  conf->qos = CC26XX_WEB_DEMO_DEFAULT_QOS;
+  conf->transport = CC26XX_WEB_DEMO_DEFAULT_TRANSPORT;
+  conf->publish_mode = CC26XX_WEB_DEMO_DEFAULT_PUBLISH_MODE;
+  // printf("CLOCK_SECOND is %d\n", CLOCK_SECOND);
+  // printf("pub_interval in init_config is %lu\n", conf->pub_interval);
+
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+register_http_post_handlers(void)
+{
+  httpd_simple_register_post_handler(&org_id_handler);
+  httpd_simple_register_post_handler(&type_id_handler);
+  httpd_simple_register_post_handler(&event_type_id_handler);
+  httpd_simple_register_post_handler(&cmd_type_handler);
+  httpd_simple_register_post_handler(&auth_token_handler);
+  httpd_simple_register_post_handler(&interval_handler);
+  httpd_simple_register_post_handler(&batch_size_handler);
+  httpd_simple_register_post_handler(&qos_handler);
+  httpd_simple_register_post_handler(&transport_handler);
+  httpd_simple_register_post_handler(&payload_format_handler);
+  httpd_simple_register_post_handler(&publish_mode_handler);
+  httpd_simple_register_post_handler(&port_handler);
+  httpd_simple_register_post_handler(&ip_addr_handler);
+  httpd_simple_register_post_handler(&reconnect_handler);
+}
+/*---------------------------------------------------------------------------*/
+static void
+subscribe(void)
+{
+  /* Publish MQTT topic in IBM quickstart format */
+  mqtt_status_t status;
+  printf("Subscribing\n");
+#if CC26XX_WEB_DEMO_MQTT_SN
+  if(TRANSPORT_IS_SN()) {
+    if(mqtt_sn_subscribe(sub_topic, MQTT_SN_QOS_0) != MQTT_SN_STATUS_OK) {
+      DBG("APP - Tried to subscribe but the gateway is busy!\n");
+    }
+    return;
+  }
+#endif
+  status = mqtt_subscribe(&conn, NULL, sub_topic, MQTT_QOS_LEVEL_0);
+
+  DBG("APP - Subscribing!\n");
+  if(status == MQTT_STATUS_OUT_QUEUE_FULL) {
+    DBG("APP - Tried to subscribe but command queue was full!\n");
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+write_json_axis(json_writer_t *w, int axis, uint16_t frame_count)
+{
+  uint16_t i;
+
+  json_writer_open(w, '[');
+  for(i = 0; i < frame_count; i++) {
+    json_writer_fixed2(w, motion_buffer_get(i)->axis[axis]);
+  }
+  json_writer_close(w, ']');
+}
+/*---------------------------------------------------------------------------*/
+static void
+write_cbor_axis(cbor_writer_t *w, int axis, uint16_t frame_count)
+{
+  uint16_t i;
+
+  cbor_writer_array(w, frame_count);
+  for(i = 0; i < frame_count; i++) {
+    cbor_writer_int(w, motion_buffer_get(i)->axis[axis]);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Microseconds between the first frame of the window and frame i */
+static uint32_t
+frame_offset_us(uint16_t i)
+{
+  uint32_t ticks = motion_buffer_get(i)->timestamp -
+    motion_buffer_get(0)->timestamp;
+
+  return (uint32_t)((uint64_t)ticks * 1000000 / MOTION_FRAME_SECOND);
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * The spacing of the frames, in us: one gap per frame after the first.
+ * Offsets are rounded rather than the gaps, so the sums don't drift
+ */
+static void
+write_json_time_deltas(json_writer_t *w, uint16_t frame_count)
+{
+  uint32_t prev = 0;
+  uint32_t offset;
+  uint16_t i;
+
+  json_writer_open(w, '[');
+  for(i = 1; i < frame_count; i++) {
+    offset = frame_offset_us(i);
+    json_writer_uint(w, offset - prev);
+    prev = offset;
+  }
+  json_writer_close(w, ']');
+}
+/*---------------------------------------------------------------------------*/
+static void
+write_cbor_time_deltas(cbor_writer_t *w, uint16_t frame_count)
+{
+  uint32_t prev = 0;
+  uint32_t offset;
+  uint16_t i;
+
+  cbor_writer_array(w, frame_count - 1);
+  for(i = 1; i < frame_count; i++) {
+    offset = frame_offset_us(i);
+    cbor_writer_uint(w, offset - prev);
+    prev = offset;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+write_cbor_delta_axis(cbor_writer_t *w, int axis, uint16_t frame_count)
+{
+  delta_codec_t c;
+  uint16_t i;
+
+  delta_codec_init(&c, delta_buffer, DELTA_BUFFER_SIZE);
+  for(i = 0; i < frame_count; i++) {
+    delta_codec_put(&c, motion_buffer_get(i)->axis[axis]);
+  }
+
+  if(delta_codec_len(&c) < 0) {
+    /* Cannot happen with frame_count <= MQTT_CLIENT_BATCH_SIZE_MAX */
+    w->overflow = 1;
+    return;
+  }
+
+  cbor_writer_bytes(w, delta_buffer, delta_codec_len(&c));
+}
+/*---------------------------------------------------------------------------*/
+static void
+write_json_features(json_writer_t *w, int axis)
+{
+  motion_features_t f;
+
+  motion_features_get(axis, &f);
+
+  json_writer_open(w, '{');
+  json_writer_key(w, "min");
+  json_writer_fixed2(w, f.min);
+  json_writer_key(w, "max");
+  json_writer_fixed2(w, f.max);
+  json_writer_key(w, "mean");
+  json_writer_fixed2(w, f.mean);
+  json_writer_key(w, "rms");
+  json_writer_fixed2(w, f.rms);
+  json_writer_key(w, "var");
+  json_writer_uint(w, f.variance);
+  json_writer_close(w, '}');
+}
+/*---------------------------------------------------------------------------*/
+static void
+write_cbor_features(cbor_writer_t *w, int axis)
+{
+  motion_features_t f;
+
+  motion_features_get(axis, &f);
+
+  cbor_writer_array(w, 5);
+  cbor_writer_int(w, f.min);
+  cbor_writer_int(w, f.max);
+  cbor_writer_int(w, f.mean);
+  cbor_writer_uint(w, f.rms);
+  cbor_writer_uint(w, f.variance);
+}
+/*---------------------------------------------------------------------------*/
+/* Spectrum mode: analyzes the last fft_size frames of the batch */
+static void
+write_json_spectrum(json_writer_t *w, int axis, uint16_t frame_count,
+                    uint16_t fft_size)
+{
+  motion_fft_peak_t peaks[MOTION_FFT_PEAKS];
+  int found = 0;
+  int i;
+
+  if(fft_size) {
+    found = motion_fft_peaks(axis, frame_count - fft_size, fft_size, peaks);
+  }
+
+  json_writer_open(w, '[');
+  for(i = 0; i < found; i++) {
+    json_writer_open(w, '[');
+    json_writer_fixed2(w, peaks[i].freq);
+    json_writer_fixed2(w, peaks[i].amplitude);
+    json_writer_close(w, ']');
+  }
+  json_writer_close(w, ']');
+}
+/*---------------------------------------------------------------------------*/
+static void
+write_cbor_spectrum(cbor_writer_t *w, int axis, uint16_t frame_count,
+                    uint16_t fft_size)
+{
+  motion_fft_peak_t peaks[MOTION_FFT_PEAKS];
+  int found = 0;
+  int i;
+
+  if(fft_size) {
+    found = motion_fft_peaks(axis, frame_count - fft_size, fft_size, peaks);
+  }
+  if(found < 0) {
+    found = 0;
+  }
+
+  cbor_writer_array(w, found);
+  for(i = 0; i < found; i++) {
+    cbor_writer_array(w, 2);
+    cbor_writer_uint(w, peaks[i].freq);
+    cbor_writer_uint(w, peaks[i].amplitude);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Spectrum mode carries the accelerometer only */
+static int
+spectrum_axis(int axis)
+{
+  return axis == MOTION_BUFFER_AXIS_ACC_X || axis == MOTION_BUFFER_AXIS_ACC_Y ||
+         axis == MOTION_BUFFER_AXIS_ACC_Z;
+}
+/*---------------------------------------------------------------------------*/
+static void
+get_node_id(uint8_t *id)
+{
+  id[0] = linkaddr_node_addr.u8[0];
+  id[1] = linkaddr_node_addr.u8[1];
+  id[2] = linkaddr_node_addr.u8[2];
+  id[3] = linkaddr_node_addr.u8[5];
+  id[4] = linkaddr_node_addr.u8[6];
+  id[5] = linkaddr_node_addr.u8[7];
+}
+/*---------------------------------------------------------------------------*/
+static const cc26xx_web_demo_sensor_reading_t *
+get_batt_volt_reading(void)
+{
+  const cc26xx_web_demo_sensor_reading_t *r;
+
+  if(!cc26xx_web_demo_sensor_enabled(CC26XX_WEB_DEMO_SENSOR_BATMON_VOLT)) {
+    return NULL;
+  }
+
+  r = cc26xx_web_demo_sensor_lookup(CC26XX_WEB_DEMO_SENSOR_BATMON_VOLT);
+  if(r->raw == CC26XX_SENSOR_READING_ERROR || !batt_volt_due) {
+    return NULL;
+  }
+
+  return r;
+}
+/*---------------------------------------------------------------------------*/
+static void
+check_batt_volt_due(void)
+{
+  const cc26xx_web_demo_sensor_reading_t *r;
+  uint16_t deadband =
+    cc26xx_web_demo_config.deadband[CC26XX_WEB_DEMO_SENSOR_BATMON_VOLT];
+  int delta;
+
+  r = cc26xx_web_demo_sensor_lookup(CC26XX_WEB_DEMO_SENSOR_BATMON_VOLT);
+  delta = r->raw - batt_volt_sent;
+  if(delta < 0) {
+    delta = -delta;
+  }
+
+  batt_volt_due = deadband == 0 ||
+    batt_volt_sent == CC26XX_SENSOR_READING_ERROR || delta > deadband;
+}
+/*---------------------------------------------------------------------------*/
+static const cc26xx_web_demo_sensor_reading_t *
+get_axis_reading(int axis)
+{
+  int type = CC26XX_WEB_DEMO_SENSOR_MPU_ACC_X + axis;
+
+  if(!cc26xx_web_demo_sensor_enabled(type)) {
+    return NULL;
+  }
+
+  return cc26xx_web_demo_sensor_lookup(type);
+}
+/*---------------------------------------------------------------------------*/
+/* The number of pre-trigger frames. build_payload() makes sure they lead */
+static uint16_t
+count_pretrigger_frames(uint16_t frame_count)
+{
+  uint16_t i;
+
+  for(i = 0; i < frame_count; i++) {
+    if(!(motion_buffer_get(i)->flags & MOTION_FRAME_FLAG_PRETRIGGER)) {
+      break;
+    }
+  }
+
+  return i;
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Wall-clock time of the first sample of the window, or of now if it has
+ * none. 0 until the SNTP client is in sync
+ */
+static uint64_t
+window_utc_ms(uint16_t frame_count)
+{
+#if CC26XX_WEB_DEMO_SNTP_CLIENT
+  uint32_t timestamp = MOTION_FRAME_NOW();
+
+  if(conf->publish_mode == MQTT_CLIENT_PUBLISH_MODE_FEATURES &&
+     motion_features_count()) {
+    timestamp = motion_features_start();
+  } else if(frame_count) {
+    timestamp = motion_buffer_get(0)->timestamp;
+  }
+
+  return sntp_client_utc_ms(timestamp);
+#else
+  return 0;
+#endif
+}
+/*---------------------------------------------------------------------------*/
+/* Features mode: moves every buffered frame into the window's features */
+static void
+fold_motion_frames(void)
+{
+  uint16_t i;
+
+  for(i = 0; i < motion_buffer_count(); i++) {
+    motion_features_add(motion_buffer_get(i));
+  }
+  motion_buffer_drop(motion_buffer_count());
+}
+/*---------------------------------------------------------------------------*/
+#if CC26XX_WEB_DEMO_PUBLISH_SPOOL || CC26XX_WEB_DEMO_WAKE_ON_MOTION
+/* Whether anything has been sampled towards the next publish */
+static int
+window_empty(void)
+{
+  if(conf->publish_mode == MQTT_CLIENT_PUBLISH_MODE_FEATURES) {
+    return motion_features_count() == 0 && motion_buffer_count() == 0;
+  }
+
+  return motion_buffer_count() == 0;
+}
+#endif
+/*---------------------------------------------------------------------------*/
+/*
+ * IBM quickstart format. In features mode, frame_count is 0 and the axes
+ * carry the features of the window instead of its samples. In spectrum mode,
+ * the accelerometer axes carry their strongest frequencies
+ */
+static int
+build_json_payload(char *buf, uint16_t frame_count)
+{
+  json_writer_t w;
+  uint8_t id[MQTT_CLIENT_NODE_ID_LEN];
+  uint8_t features = conf->publish_mode == MQTT_CLIENT_PUBLISH_MODE_FEATURES;
+  uint8_t spectrum = conf->publish_mode == MQTT_CLIENT_PUBLISH_MODE_SPECTRUM;
+  uint16_t fft_size = motion_fft_size(frame_count);
+  uint8_t heartbeat = !features && frame_count == 0;
+  uint32_t start_ms = 0;
+  uint64_t utc_ms;
+  uint16_t pretrigger;
+  int axis;
+
+  get_node_id(id);
+  pretrigger = count_pretrigger_frames(frame_count);
+  utc_ms = window_utc_ms(frame_count);
+
+  if(features && motion_features_count()) {
+    start_ms = motion_frame_ms(motion_features_start());
+  } else if(frame_count) {
+    start_ms = motion_frame_ms(motion_buffer_get(0)->timestamp);
+  }
+
+  json_writer_init(&w, buf, payload_limit());
+  json_writer_open(&w, '{');
+  json_writer_key(&w, "d");
+  json_writer_open(&w, '{');
+  json_writer_key(&w, "Name");
+  json_writer_string(&w, "Door Sensor");
+  json_writer_key(&w, "ID");
+  json_writer_hex(&w, id, sizeof(id));
+  json_writer_key(&w, "Seq #");
+  json_writer_uint(&w, seq_nr_value);
+  json_writer_key(&w, "Alive");
+  json_writer_uint(&w, clock_seconds());
+  json_writer_key(&w, "Time Send");
+  json_writer_uint(&w, start_ms / 1000);
+  if(utc_ms) {
+    json_writer_key(&w, "UTC");
+    json_writer_uint64(&w, utc_ms);
+  }
+  json_writer_key(&w, "PubInt");
+  json_writer_uint(&w, conf->pub_interval / CLOCK_SECOND);
+
+  if(pretrigger > 0) {
+    json_writer_key(&w, "PreTrig");
+    json_writer_uint(&w, pretrigger);
+  }
+
+  reading = get_batt_volt_reading();
+  if(reading != NULL) {
+    json_writer_key(&w, "batt_volt");
+    json_writer_int(&w, (reading->raw * 125) >> 5);
+  }
+
+  if(features) {
+    json_writer_key(&w, "Samples");
+    json_writer_uint(&w, motion_features_count());
+  } else if(heartbeat) {
+    /* Nothing moved past its deadband. Just tell the cloud we're alive */
+    json_writer_key(&w, "HB");
+    json_writer_uint(&w, 1);
+  } else if(spectrum) {
+    json_writer_key(&w, "FFT");
+    json_writer_uint(&w, fft_size);
+  } else {
+    /* Exact sample times: the first one, then the gaps */
+    json_writer_key(&w, "T0");
+    json_writer_uint(&w, start_ms);
+    if(frame_count > 1) {
+      json_writer_key(&w, "dT");
+      write_json_time_deltas(&w, frame_count);
+    }
+  }
+
+  /* Motion samples are kept in binary. Format them straight from the ring */
+  for(axis = 0; axis < MOTION_BUFFER_AXES && !heartbeat; axis++) {
+    reading = get_axis_reading(axis);
+    if(reading != NULL && (!spectrum || spectrum_axis(axis))) {
+      json_writer_key(&w, reading->descr);
+      if(features) {
+        write_json_features(&w, axis);
+      } else if(spectrum) {
+        write_json_spectrum(&w, axis, frame_count, fft_size);
+      } else {
+        write_json_axis(&w, axis, frame_count);
+      }
+    }
+  }
+
+  json_writer_close(&w, '}');
+  json_writer_close(&w, '}');
+
+  return json_writer_len(&w);
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Compact binary format. The layout is documented in README.md. With delta
+ * set, each axis is a byte string of delta + zigzag varints instead of an
+ * array of integers. In features mode, frame_count is 0 and the axes are
+ * replaced by their features, under their own keys. Likewise in spectrum
+ * mode, for the accelerometer peaks
+ */
+static int
+build_cbor_payload(char *buf, uint16_t frame_count, uint8_t delta)
+{
+  cbor_writer_t w;
+  uint8_t id[MQTT_CLIENT_NODE_ID_LEN];
+  const cc26xx_web_demo_sensor_reading_t *batt;
+  uint8_t features = conf->publish_mode == MQTT_CLIENT_PUBLISH_MODE_FEATURES;
+  uint8_t spectrum = conf->publish_mode == MQTT_CLIENT_PUBLISH_MODE_SPECTRUM;
+  uint16_t fft_size = motion_fft_size(frame_count);
+  uint8_t heartbeat = !features && frame_count == 0;
+  uint16_t entries = CBOR_KEY_FIXED_ENTRIES;
+  uint16_t pretrigger;
+  uint32_t start_ms = 0;
+  uint64_t utc_ms;
+  int axis;
+
+  get_node_id(id);
+
+  /* Maps are definite-length, so count the optional entries first */
+  batt = get_batt_volt_reading();
+  if(batt != NULL) {
+    entries++;
+  }
+  pretrigger = count_pretrigger_frames(frame_count);
+  if(pretrigger > 0) {
+    entries++;
+  }
+  utc_ms = window_utc_ms(frame_count);
+  if(utc_ms) {
+    entries++;
+  }
+  if(features || spectrum || heartbeat) {
+    entries++;
+  } else if(frame_count > 1) {
+    entries++;
+  }
+  for(axis = 0; axis < MOTION_BUFFER_AXES && !heartbeat; axis++) {
+    if(get_axis_reading(axis) != NULL && (!spectrum || spectrum_axis(axis))) {
+      entries++;
+    }
+  }
+
+  if(features && motion_features_count()) {
+    start_ms = motion_frame_ms(motion_features_start());
+  } else if(frame_count) {
+    start_ms = motion_frame_ms(motion_buffer_get(0)->timestamp);
+  }
+
+  cbor_writer_init(&w, (uint8_t *)buf, payload_limit());
+  cbor_writer_map(&w, entries);
+  cbor_writer_uint(&w, CBOR_KEY_VERSION);
+  cbor_writer_uint(&w, CBOR_PAYLOAD_VERSION);
+  cbor_writer_uint(&w, CBOR_KEY_NODE_ID);
+  cbor_writer_bytes(&w, id, sizeof(id));
+  cbor_writer_uint(&w, CBOR_KEY_SEQ);
+  cbor_writer_uint(&w, seq_nr_value);
+  cbor_writer_uint(&w, CBOR_KEY_ALIVE);
+  cbor_writer_uint(&w, clock_seconds());
+  cbor_writer_uint(&w, CBOR_KEY_START);
+  cbor_writer_uint(&w, start_ms);
+  cbor_writer_uint(&w, CBOR_KEY_PUB_INTERVAL);
+  cbor_writer_uint(&w, conf->pub_interval / CLOCK_SECOND);
+
+  if(batt != NULL) {
+    cbor_writer_uint(&w, CBOR_KEY_BATT_VOLT);
+    cbor_writer_int(&w, (batt->raw * 125) >> 5);
+  }
+
+  if(pretrigger > 0) {
+    cbor_writer_uint(&w, CBOR_KEY_PRETRIGGER);
+    cbor_writer_uint(&w, pretrigger);
+  }
+
+  if(utc_ms) {
+    cbor_writer_uint(&w, CBOR_KEY_UTC);
+    cbor_writer_uint64(&w, utc_ms);
+  }
+
+  if(features) {
+    cbor_writer_uint(&w, CBOR_KEY_SAMPLES);
+    cbor_writer_uint(&w, motion_features_count());
+  } else if(heartbeat) {
+    cbor_writer_uint(&w, CBOR_KEY_HEARTBEAT);
+    cbor_writer_uint(&w, 1);
+  } else if(spectrum) {
+    cbor_writer_uint(&w, CBOR_KEY_FFT_SIZE);
+    cbor_writer_uint(&w, fft_size);
+  } else if(frame_count > 1) {
+    cbor_writer_uint(&w, CBOR_KEY_TIME_DELTAS);
+    write_cbor_time_deltas(&w, frame_count);
+  }
+
+  for(axis = 0; axis < MOTION_BUFFER_AXES && !heartbeat; axis++) {
+    if(get_axis_reading(axis) == NULL || (spectrum && !spectrum_axis(axis))) {
+      continue;
+    }
+
+    if(features) {
+      cbor_writer_uint(&w, CBOR_KEY_FEATURES_BASE + axis);
+      write_cbor_features(&w, axis);
+    } else if(spectrum) {
+      cbor_writer_uint(&w, CBOR_KEY_SPECTRUM_BASE + axis);
+      write_cbor_spectrum(&w, axis, frame_count, fft_size);
+    } else {
+      cbor_writer_uint(&w, CBOR_KEY_AXIS_BASE + axis);
+      if(delta) {
+        write_cbor_delta_axis(&w, axis, frame_count);
+      } else {
+        write_cbor_axis(&w, axis, frame_count);
+      }
+    }
+  }
+
+  return cbor_writer_len(&w);
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Serializes the oldest frames of the motion buffer into buf, in the
+ * configured format. On return, frame_count holds the number of frames used
+ */
+static int
+build_payload(char *buf, uint16_t *frame_count)
+{
+  const cc26xx_web_demo_sensor_reading_t *batt;
+  uint32_t start;
+  uint16_t i;
+  int len;
+
+  check_batt_volt_due();
+  batt = get_batt_volt_reading();
+  if(batt != NULL) {
+    batt_volt_sent = batt->raw;
+  }
+
+  if(conf->publish_mode == MQTT_CLIENT_PUBLISH_MODE_FEATURES) {
+    /* Features are tiny. Catch up with the latest frames and send them all */
+    fold_motion_frames();
+    *frame_count = 0;
+    seq_nr_value++;
+
+    CYCLE_STATS_START(start);
+    if(conf->payload_format == MQTT_CLIENT_PAYLOAD_FORMAT_JSON) {
+      len = build_json_payload(buf, 0);
+    } else {
+      len = build_cbor_payload(buf, 0, 0);
+    }
+    CYCLE_STATS_STOP(CYCLE_STATS_SITE_SERIALIZE, start);
+    return len;
+  }
+
+  *frame_count = motion_buffer_count();
+  if(*frame_count > conf->batch_size) {
+    *frame_count = conf->batch_size;
+  }
+
+  /* Never span a trigger: pre-trigger frames start a message of their own */
+  for(i = 1; i < *frame_count; i++) {
+    if((motion_buffer_get(i)->flags & MOTION_FRAME_FLAG_PRETRIGGER) &&
+       !(motion_buffer_get(i - 1)->flags & MOTION_FRAME_FLAG_PRETRIGGER)) {
+      *frame_count = i;
+      break;
+    }
+  }
+
+  seq_nr_value++;
+
+  CYCLE_STATS_START(start);
+
+  /*
+   * Large batches may not fit in a buffer, depending on the format. Send as
+   * many frames as fit and leave the rest for the next publish
+   */
+  while(1) {
+    if(conf->payload_format == MQTT_CLIENT_PAYLOAD_FORMAT_CBOR) {
+      len = build_cbor_payload(buf, *frame_count, 0);
+    } else if(conf->payload_format == MQTT_CLIENT_PAYLOAD_FORMAT_CBOR_DELTA) {
+      len = build_cbor_payload(buf, *frame_count, 1);
+    } else {
+      len = build_json_payload(buf, *frame_count);
+    }
+
+    if(len >= 0 || *frame_count == 0) {
+      CYCLE_STATS_STOP(CYCLE_STATS_SITE_SERIALIZE, start);
+      return len;
+    }
+
+    DBG("APP - Buffer too short for %u frames\n", *frame_count);
+    *frame_count /= 2;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+start_new_batch(uint16_t frames_used)
+{
+  motion_buffer_drop(frames_used);
+  motion_features_reset();
+
+  window_fill = motion_buffer_count();
+  window_seen = motion_buffer_total();
+  etimer_set(&batch_timer, conf->pub_interval);
+}
+/*---------------------------------------------------------------------------*/
+/* Returns a buffer that is neither queued for sending nor awaiting a PUBACK */
+static publish_slot_t *
+acquire_slot(void)
+{
+  int i;
+
+  for(i = 0; i < MQTT_CLIENT_INFLIGHT_MAX; i++) {
+    if(slots[i].state == PUBLISH_SLOT_SENDING && transport_sent()) {
+      slots[i].state = PUBLISH_SLOT_FREE;
+    }
+    if(slots[i].state == PUBLISH_SLOT_FREE) {
+      slots[i].retries = 0;
+      slots[i].spooled = 0;
+      slots[i].kind = PUBLISH_KIND_MOTION;
+      return &slots[i];
+    }
+  }
+
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+/* The topic a slot goes out on, by its kind and payload format */
+static char *
+slot_topic(publish_slot_t *slot)
+{
+  if(slot->kind == PUBLISH_KIND_STATUS) {
+    return status_topic;
+#if CC26XX_WEB_DEMO_DOOR_EVENTS
+  } else if(slot->kind == PUBLISH_KIND_DOOR) {
+    return door_topic;
+#endif
+  } else if(slot->format != conf->payload_format) {
+    construct_topic_for_format(alt_topic, slot->format);
+    return alt_topic;
+  }
+
+  return pub_topic;
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Hands a filled slot over to the MQTT engine with the configured QoS.
+ * Returns 1 on success. On failure, the slot is left untouched
+ */
+static int
+send_slot(publish_slot_t *slot)
+{
+  char *topic = slot_topic(slot);
+  int8_t qos = publish_qos();
+  int status;
+
+#if CC26XX_WEB_DEMO_MQTT_SN
+  if(TRANSPORT_IS_SN()) {
+    /* Busy while the topic gets registered. The slot stays pending */
+    status = mqtt_sn_publish(&slot->mid, topic, (uint8_t *)slot->buf,
+                             slot->len, qos);
+    if(status != MQTT_SN_STATUS_OK) {
+      DBG("APP - MQTT-SN publish failed (%u)\n", status);
+      return 0;
+    }
+  } else
+#endif
+  {
+    status = mqtt_publish(&conn, &slot->mid, topic, (uint8_t *)slot->buf,
+                          slot->len, qos > 0 ? MQTT_QOS_LEVEL_1 :
+                          MQTT_QOS_LEVEL_0, MQTT_RETAIN_OFF);
+    if(status != MQTT_STATUS_OK) {
+      DBG("APP - Publish failed (%u)\n", status);
+      return 0;
+    }
+  }
+
+  count_frames(topic, slot->len, qos);
+
+  slot->sent = clock_time();
+  if(qos > 0) {
+    slot->state = PUBLISH_SLOT_UNACKED;
+    if(etimer_expired(&inflight_timer)) {
+      etimer_set(&inflight_timer, PUBACK_TIMEOUT);
+    }
+  } else {
+    slot->state = PUBLISH_SLOT_SENDING;
+  }
+
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+#if CC26XX_WEB_DEMO_MQTT_SN
+/*
+ * Sends an unacknowledged slot again, under its message ID and with the DUP
+ * flag, so that a late PUBACK for the first copy still frees it
+ */
+static int
+resend_slot(publish_slot_t *slot)
+{
+  char *topic = slot_topic(slot);
+  int status;
+
+  status = mqtt_sn_resend(slot->mid, topic, (uint8_t *)slot->buf, slot->len);
+  if(status != MQTT_SN_STATUS_OK) {
+    DBG("APP - MQTT-SN resend failed (%u)\n", status);
+    return 0;
+  }
+
+  count_frames(topic, slot->len, MQTT_SN_QOS_1);
+  slot->sent = clock_time();
+  return 1;
+}
+#endif
+/*---------------------------------------------------------------------------*/
+#if CC26XX_WEB_DEMO_PUBLISH_SPOOL
+static void
+schedule_spool_replay(void)
+{
+  if(publish_spool_pending() > 0 && etimer_expired(&spool_timer)) {
+    etimer_set(&spool_timer, SPOOL_REPLAY_INTERVAL);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Sends the oldest spooled payload, if the connection is idle */
+static void
+replay_spool(void)
+{
+  publish_slot_t *slot;
+  int len;
+  int i;
+
+  if(state != MQTT_CLIENT_STATE_PUBLISHING || !transport_ready()) {
+    return;
+  }
+
+  /*
+   * Live windows go first. One spooled payload in flight at a time, so
+   * PUBACKs consume in order
+   */
+  for(i = 0; i < MQTT_CLIENT_INFLIGHT_MAX; i++) {
+    if(slots[i].state == PUBLISH_SLOT_PENDING ||
+       (slots[i].state == PUBLISH_SLOT_UNACKED && slots[i].spooled)) {
+      return;
+    }
+  }
+
+  slot = acquire_slot();
+  if(slot == NULL) {
+    return;
+  }
+
+  len = publish_spool_peek((uint8_t *)slot->buf, APP_BUFFER_SIZE,
+                           &slot->format);
+  if(len <= 0) {
+    return;
+  }
+
+  if(len > payload_limit()) {
+    /* Spooled for a transport that takes larger packets */
+    printf("Spooled payload too long (%d), dropped\n", len);
+    publish_spool_consume();
+    return;
+  }
+
+  slot->len = len;
+  slot->spooled = 1;
+  if(send_slot(slot)) {
+    if(publish_qos() <= 0) {
+      publish_spool_consume();
+    }
+    DBG("APP - Replayed, %u left\n", publish_spool_pending());
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Moves the current batch to flash while the broker can't be reached */
+static void
+spoolAccReadings(void)
+{
+  int len;
+  uint16_t frame_count;
+
+  len = build_payload(spool_buf, &frame_count);
+  if(len < 0) {
+    return;
+  }
+
+  if(publish_spool_append((uint8_t *)spool_buf, len, conf->payload_format)) {
+    DBG("APP - Spooled seq %d, %u pending\n", seq_nr_value,
+        publish_spool_pending());
+    start_new_batch(frame_count);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Moves the motion windows that are queued or awaiting a PUBACK to flash,
+ * oldest first, once the connection is gone. Replayed ones are still there
+ */
+static void
+spool_slots(void)
+{
+  publish_slot_t *slot;
+  int i;
+
+  do {
+    slot = NULL;
+    for(i = 0; i < MQTT_CLIENT_INFLIGHT_MAX; i++) {
+      if((slots[i].state == PUBLISH_SLOT_PENDING ||
+          slots[i].state == PUBLISH_SLOT_UNACKED) &&
+         slots[i].kind == PUBLISH_KIND_MOTION &&
+         (slot == NULL ||
+          clock_time() - slots[i].sent > clock_time() - slot->sent)) {
+        slot = &slots[i];
+      }
+    }
+
+    if(slot != NULL) {
+      if(!slot->spooled) {
+        publish_spool_append((uint8_t *)slot->buf, slot->len, slot->format);
+        DBG("APP - Spooled mid %u\n", slot->mid);
+      }
+      slot->state = PUBLISH_SLOT_FREE;
+    }
+  } while(slot != NULL);
+}
+#endif
+/*---------------------------------------------------------------------------*/
+/*
+ * Resends QoS 1 publishes whose PUBACK is overdue. Over TCP, the engine
+ * retransmits by itself and takes nothing else until the PUBACK, so there
+ * each timeout only counts toward giving up
+ */
+static void
+check_inflight(void)
+{
+  publish_slot_t *slot;
+  uint8_t unacked = 0;
+  int i;
+
+  for(i = 0; i < MQTT_CLIENT_INFLIGHT_MAX; i++) {
+    slot = &slots[i];
+    if(slot->state != PUBLISH_SLOT_UNACKED) {
+      continue;
+    }
+
+    unacked = 1;
+    if(clock_time() - slot->sent < PUBACK_TIMEOUT) {
+      continue;
+    }
+
+    if(slot->retries >= PUBLISH_MAX_RETRIES) {
+      printf("No PUBACK for mid %u, giving up\n", slot->mid);
+#if CC26XX_WEB_DEMO_PUBLISH_SPOOL
+      /* Spooled payloads are still pending on flash and will be replayed */
+      if(!slot->spooled && slot->kind == PUBLISH_KIND_MOTION) {
+        publish_spool_append((uint8_t *)slot->buf, slot->len, slot->format);
+      }
+#endif
+      slot->state = PUBLISH_SLOT_FREE;
+      if(!TRANSPORT_IS_SN() && state == MQTT_CLIENT_STATE_PUBLISHING) {
+        /* The engine would hold on to the publish. Start over */
+        transport_disconnect();
+      }
+      continue;
+    }
+
+    if(!TRANSPORT_IS_SN()) {
+      if(state == MQTT_CLIENT_STATE_PUBLISHING) {
+        slot->retries++;
+        slot->sent = clock_time();
+        DBG("APP - No PUBACK for mid %u yet (%u)\n", slot->mid, slot->retries);
+      }
+      continue;
+    }
+
+#if CC26XX_WEB_DEMO_MQTT_SN
+    /* Only resend over a working connection. Retries are not spent offline */
+    if(state == MQTT_CLIENT_STATE_PUBLISHING && transport_ready() &&
+       resend_slot(slot)) {
+      slot->retries++;
+      DBG("APP - Resent mid %u (%u)\n", slot->mid, slot->retries);
+    }
+#endif
+  }
+
+  if(unacked) {
+    etimer_set(&inflight_timer, PUBACK_TIMEOUT >> 1);
+  }
+}
+/*---------------------------------------------------------------------------*/
+#if CC26XX_WEB_DEMO_DOOR_EVENTS
+static int
+build_door_payload(char *buf, const door_detector_event_t *ev)
+{
+  json_writer_t w;
+  uint8_t id[MQTT_CLIENT_NODE_ID_LEN];
+
+  get_node_id(id);
+
+  json_writer_init(&w, buf, payload_limit());
+  json_writer_open(&w, '{');
+  json_writer_key(&w, "d");
+  json_writer_open(&w, '{');
+  json_writer_key(&w, "ID");
+  json_writer_hex(&w, id, sizeof(id));
+  json_writer_key(&w, "Seq #");
+  json_writer_uint(&w, door_seq_nr);
+  json_writer_key(&w, "Time");
+  json_writer_uint(&w, motion_frame_ms(ev->timestamp));
+#if CC26XX_WEB_DEMO_SNTP_CLIENT
+  if(sntp_client_synced()) {
+    json_writer_key(&w, "UTC");
+    json_writer_uint64(&w, sntp_client_utc_ms(ev->timestamp));
+  }
+#endif
+  json_writer_key(&w, "Door");
+  json_writer_string(&w, door_detector_state_name(ev->state));
+  json_writer_key(&w, "Angle");
+  json_writer_int(&w, ev->angle);
+  json_writer_key(&w, "Dur");
+  json_writer_uint(&w, ev->duration);
+  json_writer_close(&w, '}');
+  json_writer_close(&w, '}');
+
+  return json_writer_len(&w);
 }
 /*---------------------------------------------------------------------------*/
-static int
-construct_client_id(void)
+/* Serializes the queued door event into a buffer, if one is free */
+static void
+queue_door_event(void)
 {
-  int len = snprintf(client_id, BUFFER_SIZE, "d:%s:%s:%02x%02x%02x%02x%02x%02x",
-                     conf->org_id, conf->type_id,
-                     linkaddr_node_addr.u8[0], linkaddr_node_addr.u8[1],
-                     linkaddr_node_addr.u8[2], linkaddr_node_addr.u8[5],
-                     linkaddr_node_addr.u8[6], linkaddr_node_addr.u8[7]);
+  publish_slot_t *slot;
+  int len;
 
-  /* len < 0: Error. Len >= BUFFER_SIZE: Buffer too small */
-  if(len < 0 || len >= BUFFER_SIZE) {
-    printf("Client ID: %d, Buffer %d\n", len, BUFFER_SIZE);
-    return 0;
+  slot = acquire_slot();
+  if(slot == NULL) {
+    /* Stays queued. The next free buffer is ours */
+    return;
   }
 
-  return 1;
+  door_seq_nr++;
+  len = build_door_payload(slot->buf, &door_queued_event);
+  door_queued = 0;
+  if(len < 0) {
+    return;
+  }
+
+  slot->len = len;
+  slot->kind = PUBLISH_KIND_DOOR;
+  slot->format = MQTT_CLIENT_PAYLOAD_FORMAT_JSON;
+  slot->state = PUBLISH_SLOT_PENDING;
+  slot->sent = clock_time();
 }
+#endif
 /*---------------------------------------------------------------------------*/
+/*
+ * Hands the oldest pending payload to the MQTT engine if it can take it.
+ * Door events go first. Called again when the engine frees up: on a PUBACK,
+ * a REGACK or mqtt_update_event. Only the TCP drain needs a timer
+ */
 static void
-update_config(void)
+flush_pending(void)
 {
-  if(construct_client_id() == 0) {
-    /* Fatal error. Client ID larger than the buffer */
-    state = MQTT_CLIENT_STATE_CONFIG_ERROR;
-    return;
+  publish_slot_t *slot = NULL;
+  uint8_t pending = 0;
+  int i;
+
+#if CC26XX_WEB_DEMO_DOOR_EVENTS
+  if(door_queued) {
+    queue_door_event();
   }
+#endif
 
-  if(construct_sub_topic() == 0) {
-    /* Fatal error. Topic larger than the buffer */
-    state = MQTT_CLIENT_STATE_CONFIG_ERROR;
-    return;
+  for(i = 0; i < MQTT_CLIENT_INFLIGHT_MAX; i++) {
+    if(slots[i].state != PUBLISH_SLOT_PENDING) {
+      continue;
+    }
+    pending++;
+    if(slot != NULL && slot->kind == PUBLISH_KIND_DOOR &&
+       slots[i].kind != PUBLISH_KIND_DOOR) {
+      continue;
+    }
+    if(slot == NULL ||
+       (slots[i].kind == PUBLISH_KIND_DOOR && slot->kind != PUBLISH_KIND_DOOR) ||
+       CLOCK_LT(slots[i].sent, slot->sent)) {
+      slot = &slots[i];
+    }
   }
 
-  if(construct_pub_topic() == 0) {
-    /* Fatal error. Topic larger than the buffer */
-    state = MQTT_CLIENT_STATE_CONFIG_ERROR;
+  if(slot == NULL) {
     return;
   }
 
-  /* Reset the counter */
-  seq_nr_value = 0;
-
-  state = MQTT_CLIENT_STATE_INIT;
+  if(state == MQTT_CLIENT_STATE_PUBLISHING && transport_ready()) {
+    if(send_slot(slot)) {
+      DBG("APP - Publish! mid %u\n", slot->mid);
+      pending--;
+    }
+  }
 
   /*
-   * Schedule next timer event ASAP
-   *
-   * If we entered an error state then we won't do anything when it fires.
-   *
-   * Since the error at this stage is a config error, we will only exit this
-   * error state if we get a new config.
+   * Offline, reaching the publishing state flushes again. While a QoS 1
+   * publish awaits its PUBACK, the PUBACK will. Otherwise the engine is
+   * winding down or TCP is draining, and nothing will tell us when it's done
    */
-  etimer_set(&append_periodic_timer, 0);
-  return;
+  if(pending > 0 && state == MQTT_CLIENT_STATE_PUBLISHING &&
+     !TRANSPORT_IS_SN() && !transport_ready() && etimer_expired(&drain_timer)) {
+    for(i = 0; i < MQTT_CLIENT_INFLIGHT_MAX; i++) {
+      if(slots[i].state == PUBLISH_SLOT_UNACKED) {
+        return;
+      }
+    }
+    etimer_set(&drain_timer, DRAIN_CHECK_INTERVAL);
+  }
 }
 /*---------------------------------------------------------------------------*/
-static int
-init_config()
+static void
+handle_puback(uint16_t mid)
 {
-  /* Populate configuration with default values */
-  memset(conf, 0, sizeof(mqtt_client_config_t));
+  int i;
 
-  memcpy(conf->org_id, CC26XX_WEB_DEMO_DEFAULT_ORG_ID, 11);
-  memcpy(conf->type_id, CC26XX_WEB_DEMO_DEFAULT_TYPE_ID, 7);
-  memcpy(conf->event_type_id, CC26XX_WEB_DEMO_DEFAULT_EVENT_TYPE_ID, 7);
-  memcpy(conf->broker_ip, broker_ip, strlen(broker_ip));
-  memcpy(conf->cmd_type, CC26XX_WEB_DEMO_DEFAULT_SUBSCRIBE_CMD_TYPE, 1);
-  memcpy(conf->auth_token, cc26XX_WEB_DEMO_DEFAULT_AUTH_TOKEN, strlen(cc26XX_WEB_DEMO_DEFAULT_AUTH_TOKEN));
-  conf->broker_port = CC26XX_WEB_DEMO_DEFAULT_BROKER_PORT;
-  conf->pub_interval = CC26XX_WEB_DEMO_DEFAULT_PUBLISH_INTERVAL;
-  // printf("CLOCK_SECOND is %d\n", CLOCK_SECOND);
-  // printf("pub_interval in init_config is %lu\n", conf->pub_interval);
+  for(i = 0; i < MQTT_CLIENT_INFLIGHT_MAX; i++) {
+    if(slots[i].state == PUBLISH_SLOT_UNACKED && slots[i].mid == mid) {
+      BENCH("mid %u acked after %lu ticks\n", mid,
+            (unsigned long)(clock_time() - slots[i].sent));
+#if CC26XX_WEB_DEMO_PUBLISH_SPOOL
+      if(slots[i].spooled) {
+        publish_spool_consume();
+      }
+#endif
+      slots[i].state = PUBLISH_SLOT_FREE;
+      /* The engine can take the next payload, and a door event this buffer */
+      flush_pending();
+      return;
+    }
+  }
 
-  return 1;
+  DBG("APP - PUBACK for unknown mid %u\n", mid);
 }
 /*---------------------------------------------------------------------------*/
 static void
-register_http_post_handlers(void)
+publishAccReadings(void)
 {
-  httpd_simple_register_post_handler(&org_id_handler);
-  httpd_simple_register_post_handler(&type_id_handler);
-  httpd_simple_register_post_handler(&event_type_id_handler);
-  httpd_simple_register_post_handler(&cmd_type_handler);
-  httpd_simple_register_post_handler(&auth_token_handler);
-  httpd_simple_register_post_handler(&interval_handler);
-  httpd_simple_register_post_handler(&port_handler);
-  httpd_simple_register_post_handler(&ip_addr_handler);
-  httpd_simple_register_post_handler(&reconnect_handler);
+  publish_slot_t *slot;
+  int len;
+  uint16_t frame_count;
+  uint32_t start;
+#if MQTT_CLIENT_BENCH
+  clock_time_t build_start;
+#endif
+
+  slot = acquire_slot();
+  if(slot == NULL) {
+    /* No spare buffer. The batch waits in the motion buffer */
+    DBG("APP - No free publish buffer\n");
+    return;
+  }
+
+  CYCLE_STATS_START(start);
+
+#if MQTT_CLIENT_BENCH
+  build_start = clock_time();
+#endif
+  len = build_payload(slot->buf, &frame_count);
+  if(len < 0) {
+    return;
+  }
+  BENCH("seq %u, %u frames, %d bytes, built in %lu ticks\n", seq_nr_value,
+        frame_count, len, (unsigned long)(clock_time() - build_start));
+
+  slot->len = len;
+  slot->format = conf->payload_format;
+  slot->state = PUBLISH_SLOT_PENDING;
+  slot->sent = clock_time();
+
+  /* The window is safe in the slot. Start filling the next one */
+  start_new_batch(frame_count);
+
+  DBG("APP - Publishing reading now\n");
+  flush_pending();
+  CYCLE_STATS_STOP(CYCLE_STATS_SITE_PUBLISH, start);
+
+#if CC26XX_WEB_DEMO_PUBLISH_SPOOL
+  schedule_spool_replay();
+#endif
 }
 /*---------------------------------------------------------------------------*/
-static void
-subscribe(void)
+/*
+ * The status message. Timing statistics are [runs, min, mean, max] per
+ * instrumented site, in the unit given by "unit"
+ */
+static int
+build_status_payload(char *buf)
 {
-  /* Publish MQTT topic in IBM quickstart format */
-  mqtt_status_t status;
-  printf("Subscribing\n");
-  status = mqtt_subscribe(&conn, NULL, sub_topic, MQTT_QOS_LEVEL_0);
+  json_writer_t w;
+#if CYCLE_STATS_ENABLED
+  const cycle_stats_site_t *site;
+#endif
+#if CYCLE_STATS_ENABLED || ENERGY_STATS_ENABLED
+  uint8_t i;
+#endif
 
-  DBG("APP - Subscribing!\n");
-  if(status == MQTT_STATUS_OUT_QUEUE_FULL) {
-    DBG("APP - Tried to subscribe but command queue was full!\n");
+  json_writer_init(&w, buf, payload_limit());
+  json_writer_open(&w, '{');
+  json_writer_key(&w, "d");
+  json_writer_open(&w, '{');
+  json_writer_key(&w, "Alive");
+  json_writer_uint(&w, clock_seconds());
+
+#if CYCLE_STATS_ENABLED
+  json_writer_key(&w, "unit");
+  json_writer_string(&w, CYCLE_STATS_UNIT);
+  json_writer_key(&w, "cyc");
+  json_writer_open(&w, '{');
+  for(i = 0; i < CYCLE_STATS_SITES; i++) {
+    site = cycle_stats_get(i);
+    json_writer_key(&w, cycle_stats_name(i));
+    json_writer_open(&w, '[');
+    json_writer_uint(&w, site->count);
+    json_writer_uint(&w, site->min);
+    json_writer_uint(&w, cycle_stats_mean(i));
+    json_writer_uint(&w, site->max);
+    json_writer_close(&w, ']');
   }
-}
-/*---------------------------------------------------------------------------*/
-static void
-arrToString(char stringArr[][DATA_RES], int size, char* myString){
-  int i;
-  memset(myString,0,strlen(myString));
-  for (i = 0; i < size; i++)
-  {
-    strcat(myString, stringArr[i]);
-    strcat(myString, ",");
+  json_writer_close(&w, '}');
+#endif
+
+  /* How publishes got split up, since boot */
+  json_writer_key(&w, "link");
+  json_writer_open(&w, '{');
+  json_writer_key(&w, "seg");
+  json_writer_uint(&w, link_stats.segment_size);
+  json_writer_key(&w, "pubs");
+  json_writer_uint(&w, link_stats.publishes);
+  json_writer_key(&w, "segs");
+  json_writer_uint(&w, link_stats.segments);
+  json_writer_key(&w, "frames");
+  json_writer_uint(&w, link_stats.frames);
+  json_writer_close(&w, '}');
+
+  /* Connection attempts since boot and the latest backoff in ms */
+  json_writer_key(&w, "conn");
+  json_writer_open(&w, '{');
+  json_writer_key(&w, "att");
+  json_writer_uint(&w, reconnect_stats.attempts);
+  json_writer_key(&w, "ok");
+  json_writer_uint(&w, reconnect_stats.connects);
+  json_writer_key(&w, "fail");
+  json_writer_uint(&w, reconnect_stats.failures);
+  json_writer_key(&w, "cool");
+  json_writer_uint(&w, reconnect_stats.cooldowns);
+  json_writer_key(&w, "backoff");
+  json_writer_uint(&w, reconnect_stats.last_backoff);
+  json_writer_close(&w, '}');
+
+#if ENERGY_STATS_ENABLED
+  /* Time spent in each state since the previous status message, in ms */
+  json_writer_key(&w, "energy");
+  json_writer_open(&w, '{');
+  json_writer_key(&w, "period");
+  json_writer_uint(&w, energy_stats_period());
+  for(i = 0; i < ENERGY_STATS_TYPES; i++) {
+    json_writer_key(&w, energy_stats_name(i));
+    json_writer_uint(&w, energy_stats_get(i));
   }
-  myString[strlen(myString)-1] = '\0';
+  json_writer_close(&w, '}');
+#endif
+
+  json_writer_close(&w, '}');
+  json_writer_close(&w, '}');
+
+  return json_writer_len(&w);
 }
 /*---------------------------------------------------------------------------*/
 static void
-publishAccReadings(void)
+publish_status(void)
 {
-  /* Publish MQTT topic in IBM quickstart format */
+  publish_slot_t *slot;
   int len;
-  int remaining = APP_BUFFER_SIZE;
-  char myString[NUM_DATA_PER_PUB*DATA_RES] = "";    
 
-  seq_nr_value++;
-  buf_ptr = app_buffer;
-  len = snprintf(buf_ptr, remaining,
-                 "{"
-                 "\"d\":{"
-                 "\"Name\":\"%s\","
-                 "\"ID\":\"%02x%02x%02x%02x%02x%02x\","
-                 "\"Seq #\":%d,"
-                 "\"Alive\":%lu,"
-                 "\"Time Send\":%lu,"
-                 "\"PubInt\":%lu",
-                 "Door Sensor", 
-                 linkaddr_node_addr.u8[0], linkaddr_node_addr.u8[1],
-                 linkaddr_node_addr.u8[2], linkaddr_node_addr.u8[5],
-                 linkaddr_node_addr.u8[6], linkaddr_node_addr.u8[7],
-                 seq_nr_value, clock_seconds(),start_time_send,conf->pub_interval/CLOCK_SECOND);
-
-  if(len < 0 || len >= remaining) {
-    printf("Buffer too short. Have %d, need %d + \\0\n", remaining, len);
+  /* Motion windows have priority. Skip this round if the buffers are busy */
+  slot = acquire_slot();
+  if(slot == NULL) {
     return;
   }
 
-  remaining -= len;
-  buf_ptr += len;
-
-  for(reading = cc26xx_web_demo_sensor_first();
-      reading != NULL; reading = reading->next) {
-    if(strcmp(reading->descr, "Battery Volt") == 0){
-      // printf("Getting Volt reading, %s\n", reading->descr);
-      if(reading->publish && reading->raw != CC26XX_SENSOR_READING_ERROR) {
-        len = snprintf(buf_ptr, remaining,
-                       ",\"%s\":%s", "batt_volt",
-                       reading->converted);
-
-        if(len < 0 || len >= remaining) {
-          printf("Buffer too short. Have %d, need %d + \\0\n", remaining, len);
-          return;
-        }
-        remaining -= len;
-        buf_ptr += len;
-        break;
-      }
-    }
-    
-  }
-  arrToString(motion_sensor_arr.acc_x, motion_sensor_arr.size, myString);
-  len = snprintf(buf_ptr, remaining,
-                 ",\"Acc X\":[%s]", myString);
-  if(len < 0 || len >= remaining) {
-    printf("Buffer too short. Have %d, need %d + \\0\n", remaining, len);
+  len = build_status_payload(slot->buf);
+  if(len < 0) {
     return;
   }
-  remaining -= len;
-  buf_ptr += len;
 
-  arrToString(motion_sensor_arr.acc_y, motion_sensor_arr.size, myString);
-  len = snprintf(buf_ptr, remaining,
-                 ",\"Acc Y\":[%s]", myString);
-  if(len < 0 || len >= remaining) {
-    printf("Buffer too short. Have %d, need %d + \\0\n", remaining, len);
-    return;
-  }
-  remaining -= len;
-  buf_ptr += len;
+  slot->len = len;
+  slot->kind = PUBLISH_KIND_STATUS;
+  slot->format = MQTT_CLIENT_PAYLOAD_FORMAT_JSON;
+  slot->state = PUBLISH_SLOT_PENDING;
+  slot->sent = clock_time();
 
-  arrToString(motion_sensor_arr.acc_z, motion_sensor_arr.size, myString);
-  len = snprintf(buf_ptr, remaining,
-                 ",\"Acc Z\":[%s]", myString);
-  if(len < 0 || len >= remaining) {
-    printf("Buffer too short. Have %d, need %d + \\0\n", remaining, len);
-    return;
-  }
-  remaining -= len;
-  buf_ptr += len;
+  flush_pending();
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Accounts for frames added to the motion buffer since we last looked.
+ * Returns 1 when they completed a batch
+ */
+static int
+motion_window_complete(void)
+{
+  uint32_t total = motion_buffer_total();
 
-  arrToString(motion_sensor_arr.gyro_x, motion_sensor_arr.size, myString);
-  len = snprintf(buf_ptr, remaining,
-                 ",\"Gyro X\":[%s]", myString);
-  if(len < 0 || len >= remaining) {
-    printf("Buffer too short. Have %d, need %d + \\0\n", remaining, len);
-    return;
-  }
-  remaining -= len;
-  buf_ptr += len;
+  window_fill += total - window_seen;
+  window_seen = total;
 
-  arrToString(motion_sensor_arr.gyro_y, motion_sensor_arr.size, myString);
-  len = snprintf(buf_ptr, remaining,
-                 ",\"Gyro Y\":[%s]", myString);
-  if(len < 0 || len >= remaining) {
-    printf("Buffer too short. Have %d, need %d + \\0\n", remaining, len);
-    return;
+  if(window_fill >= conf->batch_size) {
+    window_fill -= conf->batch_size;
+    return 1;
   }
-  remaining -= len;
-  buf_ptr += len;
 
-  arrToString(motion_sensor_arr.gyro_z, motion_sensor_arr.size, myString);
-  len = snprintf(buf_ptr, remaining,
-                 ",\"Gyro Z\":[%s]", myString);
-  if(len < 0 || len >= remaining) {
-    printf("Buffer too short. Have %d, need %d + \\0\n", remaining, len);
-    return;
-  }
-  remaining -= len;
-  buf_ptr += len;
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+#if CC26XX_WEB_DEMO_MQTT_SN
+/* QoS -1 has no session to register topics in. The gateway knows their IDs */
+static void
+predefine_sn_topics(void)
+{
+  construct_topic_for_format(alt_topic, MQTT_CLIENT_PAYLOAD_FORMAT_JSON);
+  mqtt_sn_predefine(alt_topic, MQTT_CLIENT_SN_TOPIC_ID_JSON);
+  construct_topic_for_format(alt_topic, MQTT_CLIENT_PAYLOAD_FORMAT_CBOR);
+  mqtt_sn_predefine(alt_topic, MQTT_CLIENT_SN_TOPIC_ID_CBOR);
+  mqtt_sn_predefine(status_topic, MQTT_CLIENT_SN_TOPIC_ID_STATUS);
+#if CC26XX_WEB_DEMO_DOOR_EVENTS
+  mqtt_sn_predefine(door_topic, MQTT_CLIENT_SN_TOPIC_ID_DOOR);
+#endif
+}
+/*---------------------------------------------------------------------------*/
+static void
+connect_to_gateway(void)
+{
+  /* MQTT-SN keep-alive is in seconds */
+  clock_time_t keep_alive = conf->pub_interval * 3 / CLOCK_SECOND;
 
-  len = snprintf(buf_ptr, remaining, "}}");
+  if(keep_alive > 0xFFFF) {
+    keep_alive = 0xFFFF;
+  }
 
-  if(len < 0 || len >= remaining) {
-    printf("Buffer too short. Have %d, need %d + \\0\n", remaining, len);
+  if(!mqtt_sn_connect(conf->broker_ip, conf->broker_port, keep_alive,
+                      publish_qos() < 0)) {
+    printf("Bad gateway address %s\n", conf->broker_ip);
+    state = MQTT_CLIENT_STATE_CONFIG_ERROR;
     return;
   }
-  printf("publishing reading now\n");
-  mqtt_publish(&conn, NULL, pub_topic, (uint8_t *)app_buffer,
-               strlen(app_buffer), MQTT_QOS_LEVEL_0, MQTT_RETAIN_OFF);
-  printf("Data Sent, seq %d\n", seq_nr_value);
-  DBG("APP - Publish!\n");
-}
-/*---------------------------------------------------------------------------*/
-/*static void
-printMotionReadings(void){
-  char myString[NUM_DATA_PER_PUB*DATA_RES] = "";    
-  arrToString(motion_sensor_arr.acc_x, motion_sensor_arr.size, myString);
-  printf("acc_x is %s\n", myString);
-  arrToString(motion_sensor_arr.acc_y, motion_sensor_arr.size, myString);
-  printf("acc_y is %s\n", myString);
-  arrToString(motion_sensor_arr.acc_z, motion_sensor_arr.size, myString);
-  printf("acc_z is %s\n", myString);
-  arrToString(motion_sensor_arr.gyro_x, motion_sensor_arr.size, myString);
-  printf("gyro_x is %s\n", myString);
-  arrToString(motion_sensor_arr.gyro_y, motion_sensor_arr.size, myString);
-  printf("gyro_y is %s\n", myString);
-  arrToString(motion_sensor_arr.gyro_z, motion_sensor_arr.size, myString);
-  printf("gyro_z is %s\n", myString);
-}*/
-/*---------------------------------------------------------------------------*/
-static void 
-appendMotionReadings(void)
-{
-  int size = motion_sensor_arr.size;
-  printf("Size:  %d\n", size);
-  if(size == 0) {
-    start_time = clock_seconds();
-  }
-  if(size == NUM_DATA_PER_PUB){
-    // printf("reached full size\n");
-    // memset(motion_sensor_arr, 0, sizeof(motion_sensor_Data_t));
-    motion_sensor_arr = empty_motion_arr;
-    motion_sensor_arr.size = 0;
-    size = 0;
-    start_time = clock_seconds();
-  }
-  for(reading = cc26xx_web_demo_sensor_first();
-      reading != NULL; reading = reading->next) {
-    if(reading->publish && reading->raw != CC26XX_SENSOR_READING_ERROR ) {
-      if(strcmp(reading->descr, "Acc X") == 0) {
-        // printf("acc_x reading is %s\n", reading->converted);
-        strcpy(motion_sensor_arr.acc_x[size] ,reading->converted);
-      }else if(strcmp(reading->descr, "Acc Y") == 0){
-        // printf("acc_y reading is %s\n", reading->converted);
-        strcpy(motion_sensor_arr.acc_y[size], reading->converted);
-      }else if(strcmp(reading->descr, "Acc Z") == 0){
-        // printf("acc_z reading is %s\n", reading->converted);
-        strcpy(motion_sensor_arr.acc_z[size] ,reading->converted);
-      }else if(strcmp(reading->descr, "Gyro X") == 0){
-        // printf("gyro_x reading is %s\n", reading->converted);
-        strcpy(motion_sensor_arr.gyro_x[size] ,reading->converted);
-      }else if(strcmp(reading->descr, "Gyro Y") == 0){
-        // printf("gyro_y reading is %s\n", reading->converted);
-        strcpy(motion_sensor_arr.gyro_y[size] ,reading->converted);
-      }else if(strcmp(reading->descr, "Gyro Z") == 0){
-        // printf("gyro_z reading is %s\n", reading->converted);
-        strcpy(motion_sensor_arr.gyro_z[size] ,reading->converted);
-      }
-    }
-  }
-  motion_sensor_arr.size+=1;
-  // printf("conf->pub_interval is %lu\n", conf->pub_interval);
-  // printf("timer set is %lu\n", conf->pub_interval/NUM_DATA_PER_PUB);
-  etimer_set(&append_periodic_timer, conf->pub_interval/NUM_DATA_PER_PUB);
+  state = MQTT_CLIENT_STATE_CONNECTING;
 }
+#endif
 /*---------------------------------------------------------------------------*/
 static void
 connect_to_broker(void)
 {
+  /* Our address and the broker's may have changed since the last time */
+  link_header_len = iphc_header_len();
+  reconnect_stats.attempts++;
+
+#if CC26XX_WEB_DEMO_MQTT_SN
+  if(TRANSPORT_IS_SN()) {
+    link_stats.segment_size = 0;
+    connect_to_gateway();
+    return;
+  }
+#endif
+
+  conn.max_segment_size = frame_segment_size();
+  link_stats.segment_size = conn.max_segment_size;
+  DBG("APP - %u byte segments, %u header bytes\n", conn.max_segment_size,
+      link_header_len);
+
   /* Connect to MQTT server */
   mqtt_connect(&conn, conf->broker_ip, conf->broker_port,
                conf->pub_interval * 3);
   state = MQTT_CLIENT_STATE_CONNECTING;
 }
 /*---------------------------------------------------------------------------*/
+/*
+ * How long to wait before the next connection attempt, after connect_attempt
+ * failed ones. Exponential up to the cap, then the cool-down once the budget
+ * is spent. Either way, half of it is random
+ */
+static clock_time_t
+reconnect_backoff(void)
+{
+  clock_time_t interval;
+
+  if(connect_attempt > MQTT_CLIENT_RECONNECT_BUDGET) {
+    interval = MQTT_CLIENT_RECONNECT_COOLDOWN;
+  } else {
+    uint8_t i;
+
+    interval = MQTT_CLIENT_RECONNECT_INTERVAL;
+    for(i = 1; i < connect_attempt &&
+        interval < MQTT_CLIENT_RECONNECT_MAX_INTERVAL; i++) {
+      interval <<= 1;
+    }
+    if(interval > MQTT_CLIENT_RECONNECT_MAX_INTERVAL) {
+      interval = MQTT_CLIENT_RECONNECT_MAX_INTERVAL;
+    }
+  }
+
+  return interval - (clock_time_t)(((uint64_t)(interval >> 1) *
+                                    random_rand()) / RANDOM_RAND_MAX);
+}
+/*---------------------------------------------------------------------------*/
+const mqtt_client_reconnect_stats_t *
+mqtt_client_reconnect_stats(void)
+{
+  reconnect_stats.failed = connect_attempt;
+  return &reconnect_stats;
+}
+/*---------------------------------------------------------------------------*/
 static bool
 state_machine(void)
 {
@@ -847,28 +2620,41 @@ state_machine(void)
   switch(state) {
   case MQTT_CLIENT_STATE_INIT:
     printf("Case Init\n");
-    /* If we have just been configured register MQTT connection */
-    mqtt_register(&conn, &mqtt_client_process, client_id, mqtt_event,
-                  MQTT_CLIENT_MAX_SEGMENT_SIZE);
+    transport = conf->transport;
+#if CC26XX_WEB_DEMO_MQTT_SN
+    if(TRANSPORT_IS_SN()) {
+      /* No credentials here: the gateway holds the broker connection */
+      mqtt_sn_register(&mqtt_client_process, client_id, mqtt_sn_event);
+      if(publish_qos() < 0) {
+        predefine_sn_topics();
+      }
+    } else
+#endif
+    {
+      /* If we have just been configured register MQTT connection */
+      mqtt_register(&conn, &mqtt_client_process, client_id, mqtt_event,
+                    MQTT_CLIENT_MAX_SEGMENT_SIZE);
 
-    /*
-     * If we are not using the quickstart service (thus we are an IBM
-     * registered device), we need to provide user name and password
-     */
-    if(strncasecmp(conf->org_id, QUICKSTART, strlen(conf->org_id)) != 0) {
-      if(strlen(conf->auth_token) == 0) {
-        printf("User name set, but empty auth token\n");
-        state = MQTT_CLIENT_STATE_ERROR;
-        break;
-      } else {
-        mqtt_set_username_password(&conn, "use-token-auth",
-                                   conf->auth_token);
+      /*
+       * If we are not using the quickstart service (thus we are an IBM
+       * registered device), we need to provide user name and password
+       */
+      if(strncasecmp(conf->org_id, QUICKSTART, strlen(conf->org_id)) != 0) {
+        if(strlen(conf->auth_token) == 0) {
+          printf("User name set, but empty auth token\n");
+          state = MQTT_CLIENT_STATE_ERROR;
+          break;
+        } else {
+          mqtt_set_username_password(&conn, "use-token-auth",
+                                     conf->auth_token);
+        }
       }
-    }
 
-    /* _register() will set auto_reconnect. We don't want that. */
-    conn.auto_reconnect = 0;
-    connect_attempt = 1;
+      /* _register() will set auto_reconnect. We don't want that. */
+      conn.auto_reconnect = 0;
+    }
+    connect_attempt = 0;
+    timer_set(&reconnect_wait, 0);
 
     /*
      * Wipe out the default route so we'll republish it every time we switch to
@@ -881,6 +2667,10 @@ state_machine(void)
     /* Continue */
   case MQTT_CLIENT_STATE_REGISTERED:
     printf("case registering state hahaha\n");
+    if(!timer_expired(&reconnect_wait)) {
+      /* Backing off. publish_periodic_timer brings us back when it's over */
+      return false;
+    }
     if(uip_ds6_get_global(ADDR_PREFERRED) != NULL) {
       /* Registered and with a public IP. Connect */
       DBG("Registered. Connect attempt %u\n", connect_attempt);
@@ -902,24 +2692,29 @@ state_machine(void)
     if(strncasecmp(conf->org_id, QUICKSTART, strlen(conf->org_id)) == 0) {
       DBG("Using 'quickstart': Skipping subscribe\n");
       state = MQTT_CLIENT_STATE_PUBLISHING;
+    } else if(publish_qos() < 0) {
+      DBG("QoS -1: No session to subscribe in\n");
+      state = MQTT_CLIENT_STATE_PUBLISHING;
     }
     /* Continue */
   case MQTT_CLIENT_STATE_PUBLISHING:
     printf("case publish\n");
     /* If the timer expired, the connection is stable. */
     if(timer_expired(&connection_life)) {
-      /*
-       * Intentionally using 0 here instead of 1: We want RECONNECT_ATTEMPTS
-       * attempts if we disconnect after a successful connect
-       */
+      /* Refill the failure budget */
       connect_attempt = 0;
     }
 
-    if(mqtt_ready(&conn) && conn.out_buffer_sent) {
+    if(transport_ready()) {
       /* Connected. Publish */
       if(state == MQTT_CLIENT_STATE_CONNECTED) {
         subscribe();
         state = MQTT_CLIENT_STATE_PUBLISHING;
+        /* Windows serialized before a disconnect go out once SUBSCRIBE has */
+        flush_pending();
+#if CC26XX_WEB_DEMO_PUBLISH_SPOOL
+        schedule_spool_replay();
+#endif
       } else {
         leds_on(CC26XX_WEB_DEMO_STATUS_LED);
         ctimer_set(&ct, PUBLISH_LED_ON_DURATION, publish_led_off, NULL);
@@ -932,6 +2727,14 @@ state_machine(void)
       // DBG("Publishing\n");
       /* Return here so we don't end up rescheduling the timer */
       return false;
+    } else if(state == MQTT_CLIENT_STATE_PUBLISHING) {
+      /*
+       * Some MQTT packet is still in flight. Rather than leaving the window
+       * in the motion buffer to be overwritten, serialize it into a spare
+       * buffer now. It goes out as soon as the engine is done
+       */
+      publishAccReadings();
+      return false;
     } else {
       /*
        * Our publish timer fired, but some MQTT packet is already in flight
@@ -953,33 +2756,35 @@ state_machine(void)
       return true;
     }
     break;
-  case MQTT_CLIENT_STATE_DISCONNECTED:
-    DBG("Disconnected\n");
-    if(connect_attempt < RECONNECT_ATTEMPTS ||
-       RECONNECT_ATTEMPTS == RETRY_FOREVER) {
-      /* Disconnect and backoff */
-      clock_time_t interval;
-      mqtt_disconnect(&conn);
-      connect_attempt++;
+  case MQTT_CLIENT_STATE_DISCONNECTED: {
+    /* Disconnect and back off. We never give up for good */
+    clock_time_t interval;
 
-      interval = connect_attempt < 3 ? RECONNECT_INTERVAL << connect_attempt :
-        RECONNECT_INTERVAL << 3;
+    transport_disconnect();
+    if(connect_attempt < 0xFF) {
+      connect_attempt++;
+    }
+    if(connect_attempt == MQTT_CLIENT_RECONNECT_BUDGET + 1) {
+      reconnect_stats.cooldowns++;
+      printf("%u failed attempts. Retrying every %lu s\n",
+             connect_attempt - 1,
+             (unsigned long)(MQTT_CLIENT_RECONNECT_COOLDOWN / CLOCK_SECOND));
+    }
 
-      DBG("Disconnected. Attempt %u in %lu ticks\n", connect_attempt, interval);
+    interval = reconnect_backoff();
+    reconnect_stats.last_backoff = (uint32_t)interval * 1000 / CLOCK_SECOND;
+    DBG("Disconnected. Attempt %u in %lu ticks\n", connect_attempt + 1,
+        (unsigned long)interval);
 
-      etimer_set(&publish_periodic_timer, interval);
+    timer_set(&reconnect_wait, interval);
+    etimer_set(&publish_periodic_timer, interval);
 
-      state = MQTT_CLIENT_STATE_REGISTERED;
-      return false;
-    } else {
-      /* Max reconnect attempts reached. Enter error state */
-      state = MQTT_CLIENT_STATE_ERROR;
-      DBG("Aborting connection after %u attempts\n", connect_attempt - 1);
-    }
-    break;
+    state = MQTT_CLIENT_STATE_REGISTERED;
+    return false;
+  }
   case MQTT_CLIENT_STATE_NEWCONFIG:
     /* Only update config after we have disconnected */
-    if(conn.state == MQTT_CONN_STATE_NOT_CONNECTED) {
+    if(transport_disconnected()) {
       update_config();
       DBG("New config\n");
 
@@ -1009,6 +2814,39 @@ state_machine(void)
   return false;
 }
 /*---------------------------------------------------------------------------*/
+/* Called when a batch is full or its time is up */
+static void
+batch_ready(void)
+{
+#if CC26XX_WEB_DEMO_DOOR_EVENTS
+  if(!raw_requested) {
+    /* Nobody asked for the window. Drop it, but keep the connection going */
+    start_new_batch(motion_buffer_count());
+    if(state != MQTT_CLIENT_STATE_PUBLISHING) {
+      state_machine();
+    }
+    return;
+  }
+#endif
+
+#if CC26XX_WEB_DEMO_PUBLISH_SPOOL
+  if(state != MQTT_CLIENT_STATE_CONNECTED &&
+     state != MQTT_CLIENT_STATE_PUBLISHING && !window_empty()) {
+    /* Keep the batch from being overwritten until we can send it */
+    spoolAccReadings();
+  }
+#endif
+
+#if CC26XX_WEB_DEMO_WAKE_ON_MOTION
+  if(state == MQTT_CLIENT_STATE_PUBLISHING && window_empty()) {
+    /* The door hasn't moved. Stay off the air */
+    return;
+  }
+#endif
+
+  state_machine();
+}
+/*---------------------------------------------------------------------------*/
 PROCESS_THREAD(mqtt_client_process, ev, data)
 {
 
@@ -1020,10 +2858,14 @@ PROCESS_THREAD(mqtt_client_process, ev, data)
   if(init_config() != 1) {
     PROCESS_EXIT();
   }
-  motion_sensor_arr.size = 0;
+  resize_motion_buffer();
+#if CC26XX_WEB_DEMO_PUBLISH_SPOOL
+  publish_spool_init();
+#endif
   register_http_post_handlers();
 
   update_config();
+  etimer_set(&status_timer, MQTT_CLIENT_STATUS_INTERVAL);
   /* Main loop */
   //first event is 143 - cc26xx_web_demo_config_loaded_event, this event is set by web-demo.c line 897
   //2nd event is 136, this is set by update_config above.
@@ -1037,23 +2879,72 @@ PROCESS_THREAD(mqtt_client_process, ev, data)
     if(ev == PROCESS_EVENT_TIMER && data==&publish_periodic_timer) {
       // printf("After PROCESS_YIELD, data is publish_periodic_timer \n");
     }
-    if(ev == PROCESS_EVENT_TIMER && data == &append_periodic_timer){
-      // printf("starting appending, time now is %lu\n", clock_seconds());
-      appendMotionReadings();
-      if(motion_sensor_arr.size == NUM_DATA_PER_PUB){
-        // printMotionReadings();
-        start_time_send = start_time;
-        stop_time_send = stop_time;
-        state_machine();
+    if(ev == PROCESS_EVENT_TIMER && data == &batch_timer) {
+      /* The publish interval ran out before the batch filled up */
+      etimer_set(&batch_timer, conf->pub_interval);
+      batch_ready();
+    }
+    if(ev == append_motion_sensor_event) {
+      if(conf->publish_mode == MQTT_CLIENT_PUBLISH_MODE_FEATURES) {
+        /* Windows are timed by the publish interval alone */
+        fold_motion_frames();
+      } else if(motion_window_complete()) {
+        batch_ready();
+      }
+    }
+    if(ev == motion_window_end_event) {
+      /* Don't sit on a partial batch until the next motion */
+      batch_ready();
+    }
+#if CC26XX_WEB_DEMO_DOOR_EVENTS
+    if(ev == door_event) {
+      /* Out right away, without waiting for the batch */
+      door_queued_event = *(door_detector_event_t *)data;
+      door_queued = 1;
+      flush_pending();
+    }
+#endif
+    if(ev == PROCESS_EVENT_TIMER && data == &inflight_timer) {
+      check_inflight();
+    }
+    if(ev == mqtt_update_event ||
+       (ev == PROCESS_EVENT_TIMER && data == &drain_timer)) {
+      /* The engine is done with a QoS 0 publish, or TCP may have drained */
+      flush_pending();
+    }
+    if(ev == PROCESS_EVENT_TIMER && data == &status_timer) {
+      /* The status interval is also the energy reporting period */
+      energy_stats_update();
+      if(state == MQTT_CLIENT_STATE_PUBLISHING) {
+        publish_status();
+      }
+      etimer_set(&status_timer, MQTT_CLIENT_STATUS_INTERVAL);
+    }
+#if CC26XX_WEB_DEMO_PUBLISH_SPOOL
+    if(ev == PROCESS_EVENT_TIMER && data == &spool_timer) {
+      replay_spool();
+      if(state == MQTT_CLIENT_STATE_PUBLISHING) {
+        schedule_spool_replay();
       }
     }
+#endif
+    if(ev == cc26xx_web_demo_config_loaded_event) {
+      /* The saved batch size may differ from our default */
+      resize_motion_buffer();
+      check_transport_config();
+    }
     // printf("After append function\n");
     if(ev == sensors_event && data == CC26XX_WEB_DEMO_MQTT_PUBLISH_TRIGGER) {
       // printf("Inside CC26XX_WEB_DEMO_MQTT_PUBLISH_TRIGGER\n");
       if(state == MQTT_CLIENT_STATE_ERROR) {
-        connect_attempt = 1;
+        connect_attempt = 0;
         state = MQTT_CLIENT_STATE_REGISTERED;
       }
+      if(state == MQTT_CLIENT_STATE_REGISTERED) {
+        /* Cut any backoff short */
+        timer_set(&reconnect_wait, 0);
+        state_machine();
+      }
     }
     // printf("After publish trigger\n");
     if(ev == httpd_simple_event_new_config) {
@@ -1065,6 +2956,16 @@ PROCESS_THREAD(mqtt_client_process, ev, data)
        // printf("Inside httpd_simple_event_new_config\n");
       etimer_set(&publish_periodic_timer, NEW_CONFIG_WAIT_INTERVAL);
     }
+    if((ev == PROCESS_EVENT_TIMER && data == &publish_periodic_timer) ||
+       ev == PROCESS_EVENT_POLL) {
+      /*
+       * Getting (back) to the broker: Backoff over, connection progress or
+       * a disconnect. Once publishing, only full batches drive us
+       */
+      if(state != MQTT_CLIENT_STATE_PUBLISHING) {
+        state_machine();
+      }
+    }
     //PROCESS_EVENT_TIMER IS 136, PROCESS_EVENT_POLL IS 130, sensor_event is 141
     // if((ev == PROCESS_EVENT_TIMER && data == &publish_periodic_timer) ||
     //    ev == PROCESS_EVENT_POLL ||
@@ -1075,6 +2976,7 @@ PROCESS_THREAD(mqtt_client_process, ev, data)
     if(ev == cc26xx_web_demo_load_config_defaults) {
       printf("cc26xx_web_demo_load_config_defaults\n");
       init_config();
+      resize_motion_buffer();
       etimer_set(&publish_periodic_timer, NEW_CONFIG_WAIT_INTERVAL);
     }
     // printf("Reached end of while\n");  
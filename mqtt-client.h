@@ -47,6 +47,164 @@
 /*---------------------------------------------------------------------------*/
 #define MQTT_CLIENT_PUBLISH_INTERVAL_MAX      86400 /* secs: 1 day */
 #define MQTT_CLIENT_PUBLISH_INTERVAL_MIN          5 /* secs */
+
+/*
+ * Frames per publish. The motion buffer arena holds two batches of the
+ * largest size, so that a full batch can keep filling while the previous one
+ * is still being sent. At 20 bytes a frame, the default of 64 takes 2.5 KB
+ * of RAM whatever batch size is configured at runtime. See motion-buffer.h
+ */
+#ifdef MQTT_CLIENT_CONF_BATCH_SIZE_MAX
+#define MQTT_CLIENT_BATCH_SIZE_MAX MQTT_CLIENT_CONF_BATCH_SIZE_MAX
+#else
+#define MQTT_CLIENT_BATCH_SIZE_MAX               64
+#endif
+#define MQTT_CLIENT_BATCH_SIZE_MIN                1
+
+/*
+ * Number of publish buffers. Each buffer costs about 1 KB of RAM. With QoS 1
+ * over MQTT-SN, this is how many publishes can await their PUBACK at the same
+ * time. Over TCP, Contiki's MQTT engine takes no new publish until the last
+ * one is acknowledged, so one awaits its PUBACK and the others wait their turn
+ */
+#ifdef MQTT_CLIENT_CONF_INFLIGHT_MAX
+#define MQTT_CLIENT_INFLIGHT_MAX MQTT_CLIENT_CONF_INFLIGHT_MAX
+#else
+#define MQTT_CLIENT_INFLIGHT_MAX                  2
+#endif
+
+/* How often to publish the status message (timing statistics etc.) */
+#ifdef MQTT_CLIENT_CONF_STATUS_INTERVAL
+#define MQTT_CLIENT_STATUS_INTERVAL MQTT_CLIENT_CONF_STATUS_INTERVAL
+#else
+#define MQTT_CLIENT_STATUS_INTERVAL     (CLOCK_SECOND * 60)
+#endif
+
+/*
+ * Frame-aware TCP output. Size MQTT's TCP segments so that each one, with
+ * its TCP, compressed IPv6 and 802.15.4 headers, fills exactly one radio
+ * frame. With 0, segments are MQTT_CLIENT_MAX_SEGMENT_SIZE bytes
+ */
+#ifdef MQTT_CLIENT_CONF_FRAME_AWARE
+#define MQTT_CLIENT_FRAME_AWARE MQTT_CLIENT_CONF_FRAME_AWARE
+#else
+#define MQTT_CLIENT_FRAME_AWARE                   1
+#endif
+
+/*
+ * MAC header and footer bytes around each frame's payload. The default is
+ * for long addresses and PAN ID compression, without link-layer security
+ */
+#ifdef MQTT_CLIENT_CONF_FRAME_MAC_OVERHEAD
+#define MQTT_CLIENT_FRAME_MAC_OVERHEAD MQTT_CLIENT_CONF_FRAME_MAC_OVERHEAD
+#else
+#define MQTT_CLIENT_FRAME_MAC_OVERHEAD   (7 + 2 * LINKADDR_SIZE)
+#endif
+
+/*
+ * Whether 6LoWPAN context 0 holds our global prefix, as with Contiki's
+ * default border router setup. Addresses under it compress to their
+ * interface ID, or to nothing for our own
+ */
+#ifdef MQTT_CLIENT_CONF_FRAME_CONTEXT
+#define MQTT_CLIENT_FRAME_CONTEXT MQTT_CLIENT_CONF_FRAME_CONTEXT
+#else
+#define MQTT_CLIENT_FRAME_CONTEXT                 1
+#endif
+
+/*
+ * Reconnect backoff. The wait doubles from MQTT_CLIENT_RECONNECT_INTERVAL with
+ * each failed attempt up to MQTT_CLIENT_RECONNECT_MAX_INTERVAL, and half of it
+ * is random so that nodes which lost the broker together don't all come back
+ * together
+ */
+#ifdef MQTT_CLIENT_CONF_RECONNECT_INTERVAL
+#define MQTT_CLIENT_RECONNECT_INTERVAL MQTT_CLIENT_CONF_RECONNECT_INTERVAL
+#else
+#define MQTT_CLIENT_RECONNECT_INTERVAL  (CLOCK_SECOND * 2)
+#endif
+
+#ifdef MQTT_CLIENT_CONF_RECONNECT_MAX_INTERVAL
+#define MQTT_CLIENT_RECONNECT_MAX_INTERVAL MQTT_CLIENT_CONF_RECONNECT_MAX_INTERVAL
+#else
+#define MQTT_CLIENT_RECONNECT_MAX_INTERVAL (CLOCK_SECOND * 120)
+#endif
+
+/*
+ * Failed attempts before we slow down to one every
+ * MQTT_CLIENT_RECONNECT_COOLDOWN. Only a connection that stays up refills
+ * the budget
+ */
+#ifdef MQTT_CLIENT_CONF_RECONNECT_BUDGET
+#define MQTT_CLIENT_RECONNECT_BUDGET MQTT_CLIENT_CONF_RECONNECT_BUDGET
+#else
+#define MQTT_CLIENT_RECONNECT_BUDGET              8
+#endif
+
+#ifdef MQTT_CLIENT_CONF_RECONNECT_COOLDOWN
+#define MQTT_CLIENT_RECONNECT_COOLDOWN MQTT_CLIENT_CONF_RECONNECT_COOLDOWN
+#else
+#define MQTT_CLIENT_RECONNECT_COOLDOWN  (CLOCK_SECOND * 600)
+#endif
+
+/* Log payload sizes, serialization times and PUBACK latencies */
+#ifdef MQTT_CLIENT_CONF_BENCH
+#define MQTT_CLIENT_BENCH MQTT_CLIENT_CONF_BENCH
+#else
+#define MQTT_CLIENT_BENCH                         0
+#endif
+/*---------------------------------------------------------------------------*/
+/* Encodings of motion publishes. The value is also the payload_format key */
+#define MQTT_CLIENT_PAYLOAD_FORMAT_JSON           0
+#define MQTT_CLIENT_PAYLOAD_FORMAT_CBOR           1
+#define MQTT_CLIENT_PAYLOAD_FORMAT_CBOR_DELTA     2
+#define MQTT_CLIENT_PAYLOAD_FORMAT_MAX            MQTT_CLIENT_PAYLOAD_FORMAT_CBOR_DELTA
+
+/*
+ * What motion publishes carry: every sample of a batch, per-axis features of
+ * everything sampled during a publish interval, or the strongest frequencies
+ * of each accelerometer axis over a batch
+ */
+#define MQTT_CLIENT_PUBLISH_MODE_RAW              0
+#define MQTT_CLIENT_PUBLISH_MODE_FEATURES         1
+#define MQTT_CLIENT_PUBLISH_MODE_SPECTRUM         2
+#define MQTT_CLIENT_PUBLISH_MODE_MAX              MQTT_CLIENT_PUBLISH_MODE_SPECTRUM
+
+/*
+ * How publishes reach the broker: MQTT over TCP, or MQTT-SN over UDP through
+ * a gateway. See mqtt-sn.h
+ */
+#define MQTT_CLIENT_TRANSPORT_TCP                 0
+#define MQTT_CLIENT_TRANSPORT_MQTT_SN             1
+#define MQTT_CLIENT_TRANSPORT_MAX                 MQTT_CLIENT_TRANSPORT_MQTT_SN
+
+/*
+ * Topic IDs the MQTT-SN gateway must be configured with for QoS -1, which
+ * has no session to register topics in
+ */
+#ifdef MQTT_CLIENT_CONF_SN_TOPIC_ID_JSON
+#define MQTT_CLIENT_SN_TOPIC_ID_JSON MQTT_CLIENT_CONF_SN_TOPIC_ID_JSON
+#else
+#define MQTT_CLIENT_SN_TOPIC_ID_JSON              1
+#endif
+
+#ifdef MQTT_CLIENT_CONF_SN_TOPIC_ID_CBOR
+#define MQTT_CLIENT_SN_TOPIC_ID_CBOR MQTT_CLIENT_CONF_SN_TOPIC_ID_CBOR
+#else
+#define MQTT_CLIENT_SN_TOPIC_ID_CBOR              2
+#endif
+
+#ifdef MQTT_CLIENT_CONF_SN_TOPIC_ID_STATUS
+#define MQTT_CLIENT_SN_TOPIC_ID_STATUS MQTT_CLIENT_CONF_SN_TOPIC_ID_STATUS
+#else
+#define MQTT_CLIENT_SN_TOPIC_ID_STATUS            3
+#endif
+
+#ifdef MQTT_CLIENT_CONF_SN_TOPIC_ID_DOOR
+#define MQTT_CLIENT_SN_TOPIC_ID_DOOR MQTT_CLIENT_CONF_SN_TOPIC_ID_DOOR
+#else
+#define MQTT_CLIENT_SN_TOPIC_ID_DOOR              4
+#endif
 /*---------------------------------------------------------------------------*/
 PROCESS_NAME(mqtt_client_process);
 /*---------------------------------------------------------------------------*/
@@ -61,9 +219,49 @@ typedef struct mqtt_client_config {
   char broker_ip[MQTT_CLIENT_CONFIG_IP_ADDR_STR_LEN];
   char cmd_type[MQTT_CLIENT_CONFIG_CMD_TYPE_LEN];
   clock_time_t pub_interval;
+  uint16_t batch_size;
   uint16_t broker_port;
+  uint8_t payload_format;
+  int8_t qos; /* -1 with the MQTT-SN transport only */
+  uint8_t publish_mode;
+  uint8_t transport;
 } mqtt_client_config_t;
 /*---------------------------------------------------------------------------*/
+/**
+ * \brief How publishes get split up on the way out. Frame counts are
+ * estimates from the header sizes, before link-layer retransmissions
+ */
+typedef struct mqtt_client_link_stats {
+  uint16_t segment_size;  /* MQTT bytes per TCP segment. 0 over MQTT-SN */
+  uint16_t last_segments; /* Of the latest publish */
+  uint16_t last_frames;
+  uint32_t publishes;
+  uint32_t segments;
+  uint32_t frames;
+} mqtt_client_link_stats_t;
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief Returns the segment and frame counts of publishes so far
+ */
+const mqtt_client_link_stats_t *mqtt_client_link_stats(void);
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief Connection attempts and their outcomes since boot
+ */
+typedef struct mqtt_client_reconnect_stats {
+  uint32_t attempts;
+  uint32_t connects;
+  uint32_t failures;      /* Attempts that failed and connections lost */
+  uint16_t cooldowns;     /* Times the failure budget ran out */
+  uint8_t failed;         /* Failures since the last stable connection */
+  uint32_t last_backoff;  /* ms */
+} mqtt_client_reconnect_stats_t;
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief Returns the connection attempt counts so far
+ */
+const mqtt_client_reconnect_stats_t *mqtt_client_reconnect_stats(void);
+/*---------------------------------------------------------------------------*/
 #endif /* MQTT_CLIENT_H_ */
 /*---------------------------------------------------------------------------*/
 /**
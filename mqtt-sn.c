@@ -0,0 +1,772 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \addtogroup cc26xx-web-demo
+ * @{
+ *
+ * \file
+ *   A minimal MQTT-SN v1.2 client. No gateway discovery, wills or sleeping
+ *   clients: the gateway address comes from the configuration, and one
+ *   request at a time awaits its answer.
+ */
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+#include "contiki-net.h"
+#include "net/ip/uip.h"
+#include "mqtt-sn.h"
+
+#include <string.h>
+#include <stdio.h>
+/*---------------------------------------------------------------------------*/
+#define DEBUG 0
+#if DEBUG
+#define PRINTF(...) printf(__VA_ARGS__)
+#else
+#define PRINTF(...)
+#endif
+/*---------------------------------------------------------------------------*/
+/* Message types */
+#define MSG_CONNECT           0x04
+#define MSG_CONNACK           0x05
+#define MSG_REGISTER          0x0A
+#define MSG_REGACK            0x0B
+#define MSG_PUBLISH           0x0C
+#define MSG_PUBACK            0x0D
+#define MSG_SUBSCRIBE         0x12
+#define MSG_SUBACK            0x13
+#define MSG_PINGREQ           0x16
+#define MSG_PINGRESP          0x17
+#define MSG_DISCONNECT        0x18
+
+/* The flags byte */
+#define FLAG_DUP              0x80
+#define FLAG_QOS_SHIFT           5
+#define FLAG_QOS_MASK         0x03
+#define FLAG_CLEAN_SESSION    0x04
+#define FLAG_TOPIC_NORMAL     0x00
+#define FLAG_TOPIC_PREDEFINED 0x01
+#define FLAG_TOPIC_TYPE_MASK  0x03
+
+#define PROTOCOL_ID           0x01
+
+/* Return codes */
+#define RC_ACCEPTED           0x00
+#define RC_CONGESTION         0x01
+#define RC_INVALID_TOPIC_ID   0x02
+
+/* A length byte of 0x01 announces a 3-byte length field */
+#define LONG_LENGTH_MARKER    0x01
+/*---------------------------------------------------------------------------*/
+#define STATE_DISCONNECTED       0
+#define STATE_CONNECTING         1
+#define STATE_CONNECTED          2
+#define STATE_CONNECTIONLESS     3 /* QoS -1 publishes only */
+
+#define TOPIC_USED            0x01
+#define TOPIC_REGISTERED      0x02 /* The ID is valid */
+#define TOPIC_PREDEFINED      0x04 /* Configured on the gateway. Never lost */
+#define TOPIC_REJECTED        0x08 /* The gateway refused to register it */
+
+typedef struct topic {
+  char name[MQTT_SN_TOPIC_NAME_LEN];
+  uint16_t id;
+  uint8_t flags;
+} topic_t;
+/*---------------------------------------------------------------------------*/
+static struct uip_udp_conn *client_conn = NULL;
+static uip_ip6addr_t gateway_addr;
+static uint16_t gateway_port;
+static uint16_t keep_alive;
+static uint8_t connectionless;
+static uint8_t state = STATE_DISCONNECTED;
+
+static struct process *app_process;
+static const char *client_id;
+static mqtt_sn_event_callback_t event_callback;
+
+static topic_t topics[MQTT_SN_TOPIC_MAX];
+static uint16_t last_mid;
+
+/*
+ * The request that awaits its answer, if any. Retransmissions are built
+ * afresh, so the transmit buffer is free for anything else in between
+ */
+static uint8_t request_type;
+static uint16_t request_mid;
+static uint8_t request_tries;
+static topic_t *request_topic;     /* REGISTER */
+static const char *request_filter; /* SUBSCRIBE */
+static int8_t request_qos;
+
+static struct etimer retry_timer;
+static struct etimer ping_timer;
+
+static uint8_t tx_buf[MQTT_SN_MAX_PACKET_LEN];
+/*---------------------------------------------------------------------------*/
+PROCESS(mqtt_sn_process, "MQTT-SN Client Process");
+/*---------------------------------------------------------------------------*/
+static uint16_t
+get16(const uint8_t *p)
+{
+  return ((uint16_t)p[0] << 8) | p[1];
+}
+/*---------------------------------------------------------------------------*/
+static void
+put16(uint8_t *p, uint16_t v)
+{
+  p[0] = v >> 8;
+  p[1] = v;
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+next_mid(void)
+{
+  last_mid++;
+  if(last_mid == 0) {
+    last_mid = 1;
+  }
+  return last_mid;
+}
+/*---------------------------------------------------------------------------*/
+/* Our timers belong to our process, whoever calls into the API */
+static void
+set_timer(struct etimer *et, clock_time_t interval)
+{
+  PROCESS_CONTEXT_BEGIN(&mqtt_sn_process);
+  etimer_set(et, interval);
+  PROCESS_CONTEXT_END(&mqtt_sn_process);
+}
+/*---------------------------------------------------------------------------*/
+static void
+call_event(mqtt_sn_event_t event, void *data)
+{
+  PROCESS_CONTEXT_BEGIN(app_process);
+  event_callback(event, data);
+  PROCESS_CONTEXT_END(app_process);
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Writes the length and type fields for a body of len bytes into the
+ * transmit buffer. Returns the offset of the body
+ */
+static uint16_t
+start_packet(uint8_t type, uint16_t len)
+{
+  if(len + 2 <= 0xFF) {
+    tx_buf[0] = len + 2;
+    tx_buf[1] = type;
+    return 2;
+  }
+
+  tx_buf[0] = LONG_LENGTH_MARKER;
+  put16(&tx_buf[1], len + 4);
+  tx_buf[3] = type;
+  return 4;
+}
+/*---------------------------------------------------------------------------*/
+static void
+send_packet(uint16_t len)
+{
+  uip_udp_packet_send(client_conn, tx_buf, len);
+
+  /* The gateway only needs to hear from us once per keep-alive period */
+  if(state == STATE_CONNECTED && keep_alive > 0) {
+    set_timer(&ping_timer, keep_alive * CLOCK_SECOND);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static topic_t *
+find_topic(const char *name)
+{
+  int i;
+
+  for(i = 0; i < MQTT_SN_TOPIC_MAX; i++) {
+    if((topics[i].flags & TOPIC_USED) && strcmp(topics[i].name, name) == 0) {
+      return &topics[i];
+    }
+  }
+
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+static topic_t *
+find_topic_id(uint16_t id, uint8_t predefined)
+{
+  int i;
+
+  for(i = 0; i < MQTT_SN_TOPIC_MAX; i++) {
+    if((topics[i].flags & TOPIC_REGISTERED) && topics[i].id == id &&
+       !(topics[i].flags & TOPIC_PREDEFINED) == !predefined) {
+      return &topics[i];
+    }
+  }
+
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+/* Returns the entry for name, adding it if needed. NULL if it can't be */
+static topic_t *
+add_topic(const char *name)
+{
+  topic_t *t = find_topic(name);
+  int i;
+
+  if(t != NULL) {
+    return t;
+  }
+
+  if(strlen(name) >= MQTT_SN_TOPIC_NAME_LEN) {
+    return NULL;
+  }
+
+  for(i = 0; i < MQTT_SN_TOPIC_MAX; i++) {
+    if(!(topics[i].flags & TOPIC_USED)) {
+      strcpy(topics[i].name, name);
+      topics[i].flags = TOPIC_USED;
+      return &topics[i];
+    }
+  }
+
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+/* (Re)sends the outstanding request */
+static void
+send_request(void)
+{
+  uint16_t len;
+  uint16_t pos;
+
+  switch(request_type) {
+  case MSG_CONNECT:
+    len = strlen(client_id);
+    pos = start_packet(MSG_CONNECT, 4 + len);
+    tx_buf[pos] = FLAG_CLEAN_SESSION;
+    tx_buf[pos + 1] = PROTOCOL_ID;
+    put16(&tx_buf[pos + 2], keep_alive);
+    memcpy(&tx_buf[pos + 4], client_id, len);
+    len += pos + 4;
+    break;
+  case MSG_REGISTER:
+    len = strlen(request_topic->name);
+    pos = start_packet(MSG_REGISTER, 4 + len);
+    put16(&tx_buf[pos], 0);
+    put16(&tx_buf[pos + 2], request_mid);
+    memcpy(&tx_buf[pos + 4], request_topic->name, len);
+    len += pos + 4;
+    break;
+  case MSG_SUBSCRIBE:
+    len = strlen(request_filter);
+    pos = start_packet(MSG_SUBSCRIBE, 3 + len);
+    tx_buf[pos] = (request_qos << FLAG_QOS_SHIFT) | FLAG_TOPIC_NORMAL;
+    put16(&tx_buf[pos + 1], request_mid);
+    memcpy(&tx_buf[pos + 3], request_filter, len);
+    len += pos + 3;
+    break;
+  case MSG_PINGREQ:
+    len = start_packet(MSG_PINGREQ, 0);
+    break;
+  default:
+    return;
+  }
+
+  request_tries++;
+  send_packet(len);
+  set_timer(&retry_timer, MQTT_SN_RETRY_INTERVAL);
+}
+/*---------------------------------------------------------------------------*/
+static void
+start_request(uint8_t type)
+{
+  request_type = type;
+  request_mid = next_mid();
+  request_tries = 0;
+  send_request();
+}
+/*---------------------------------------------------------------------------*/
+/* Ends the session. Topic IDs other than predefined ones go with it */
+static void
+go_disconnected(void)
+{
+  int i;
+
+  if(state == STATE_DISCONNECTED) {
+    return;
+  }
+
+  state = STATE_DISCONNECTED;
+  request_type = 0;
+  etimer_stop(&retry_timer);
+  etimer_stop(&ping_timer);
+
+  for(i = 0; i < MQTT_SN_TOPIC_MAX; i++) {
+    if(!(topics[i].flags & TOPIC_PREDEFINED)) {
+      topics[i].flags = 0;
+    }
+  }
+
+  call_event(MQTT_SN_EVENT_DISCONNECTED, NULL);
+}
+/*---------------------------------------------------------------------------*/
+static void
+open_connection(void)
+{
+  if(client_conn != NULL) {
+    uip_udp_remove(client_conn);
+  }
+
+  client_conn = udp_new(&gateway_addr, UIP_HTONS(gateway_port), NULL);
+  if(client_conn == NULL) {
+    PRINTF("MQTT-SN: Could not open connection\n");
+    go_disconnected();
+    return;
+  }
+
+  if(connectionless) {
+    state = STATE_CONNECTIONLESS;
+    call_event(MQTT_SN_EVENT_CONNECTED, NULL);
+    return;
+  }
+
+  start_request(MSG_CONNECT);
+}
+/*---------------------------------------------------------------------------*/
+static void
+check_request(void)
+{
+  if(request_type == 0) {
+    return;
+  }
+
+  if(request_tries > MQTT_SN_RETRY_MAX) {
+    PRINTF("MQTT-SN: No answer to 0x%02x, gateway lost\n", request_type);
+    go_disconnected();
+    return;
+  }
+
+  send_request();
+}
+/*---------------------------------------------------------------------------*/
+static void
+ping(void)
+{
+  if(state != STATE_CONNECTED) {
+    return;
+  }
+
+  if(request_type != 0) {
+    /* That request tells us whether the gateway is still there */
+    set_timer(&ping_timer, keep_alive * CLOCK_SECOND);
+    return;
+  }
+
+  start_request(MSG_PINGREQ);
+}
+/*---------------------------------------------------------------------------*/
+static void
+send_ack(uint8_t type, uint16_t topic_id, uint16_t mid, uint8_t rc)
+{
+  uint16_t pos = start_packet(type, 5);
+
+  put16(&tx_buf[pos], topic_id);
+  put16(&tx_buf[pos + 2], mid);
+  tx_buf[pos + 4] = rc;
+  send_packet(pos + 5);
+}
+/*---------------------------------------------------------------------------*/
+/* The gateway tells us the ID of a topic before publishing on it */
+static void
+handle_register(const uint8_t *body, uint16_t len)
+{
+  char name[MQTT_SN_TOPIC_NAME_LEN];
+  topic_t *t = NULL;
+
+  if(len < 4) {
+    return;
+  }
+
+  if(len - 4 < MQTT_SN_TOPIC_NAME_LEN) {
+    memcpy(name, &body[4], len - 4);
+    name[len - 4] = '\0';
+    t = add_topic(name);
+  }
+
+  if(t == NULL) {
+    send_ack(MSG_REGACK, get16(body), get16(&body[2]), RC_CONGESTION);
+    return;
+  }
+
+  t->id = get16(body);
+  t->flags |= TOPIC_REGISTERED;
+  send_ack(MSG_REGACK, t->id, get16(&body[2]), RC_ACCEPTED);
+}
+/*---------------------------------------------------------------------------*/
+static void
+handle_publish(const uint8_t *body, uint16_t len)
+{
+  mqtt_sn_message_t msg;
+  topic_t *t;
+  uint16_t topic_id;
+  uint16_t mid;
+  uint8_t qos;
+
+  if(len < 5) {
+    return;
+  }
+
+  qos = (body[0] >> FLAG_QOS_SHIFT) & FLAG_QOS_MASK;
+  topic_id = get16(&body[1]);
+  mid = get16(&body[3]);
+
+  t = find_topic_id(topic_id, (body[0] & FLAG_TOPIC_TYPE_MASK) ==
+                    FLAG_TOPIC_PREDEFINED);
+  if(t != NULL) {
+    msg.topic = t->name;
+    msg.payload = &body[5];
+    msg.payload_length = len - 5;
+    call_event(MQTT_SN_EVENT_PUBLISH, &msg);
+  }
+
+  /* Last: the ack overwrites the payload in the uIP buffer */
+  if(qos == MQTT_SN_QOS_1) {
+    send_ack(MSG_PUBACK, topic_id, mid,
+             t != NULL ? RC_ACCEPTED : RC_INVALID_TOPIC_ID);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+handle_ack(uint8_t type, const uint8_t *body, uint16_t len)
+{
+  topic_t *t;
+  uint16_t mid;
+
+  switch(type) {
+  case MSG_CONNACK:
+    if(len < 1 || request_type != MSG_CONNECT) {
+      return;
+    }
+    request_type = 0;
+    if(body[0] != RC_ACCEPTED) {
+      PRINTF("MQTT-SN: Connection refused (%u)\n", body[0]);
+      go_disconnected();
+      return;
+    }
+    state = STATE_CONNECTED;
+    if(keep_alive > 0) {
+      set_timer(&ping_timer, keep_alive * CLOCK_SECOND);
+    }
+    call_event(MQTT_SN_EVENT_CONNECTED, NULL);
+    break;
+  case MSG_REGACK:
+    if(len < 5 || request_type != MSG_REGISTER ||
+       get16(&body[2]) != request_mid) {
+      return;
+    }
+    request_type = 0;
+    t = request_topic;
+    if(body[4] == RC_ACCEPTED) {
+      t->id = get16(body);
+      t->flags |= TOPIC_REGISTERED;
+    } else if(body[4] == RC_CONGESTION) {
+      /* Try again with the next publish */
+      t->flags = 0;
+    } else {
+      PRINTF("MQTT-SN: Topic %s rejected (%u)\n", t->name, body[4]);
+      t->flags |= TOPIC_REJECTED;
+    }
+    call_event(MQTT_SN_EVENT_REGACK, NULL);
+    break;
+  case MSG_SUBACK:
+    if(len < 6 || request_type != MSG_SUBSCRIBE ||
+       get16(&body[3]) != request_mid) {
+      return;
+    }
+    request_type = 0;
+    if(body[5] == RC_ACCEPTED && get16(&body[1]) != 0) {
+      /* Without wildcards, the ID of the topic itself */
+      t = add_topic(request_filter);
+      if(t != NULL) {
+        t->id = get16(&body[1]);
+        t->flags |= TOPIC_REGISTERED;
+      }
+    }
+    call_event(MQTT_SN_EVENT_SUBACK, NULL);
+    break;
+  case MSG_PUBACK:
+    if(len < 5) {
+      return;
+    }
+    mid = get16(&body[2]);
+    if(body[4] == RC_ACCEPTED) {
+      call_event(MQTT_SN_EVENT_PUBACK, &mid);
+    } else if(body[4] == RC_INVALID_TOPIC_ID) {
+      /* The gateway lost our registration. Register again on the resend */
+      t = find_topic_id(get16(body), 0);
+      if(t != NULL) {
+        t->flags = 0;
+      }
+    }
+    break;
+  case MSG_PINGRESP:
+    if(request_type == MSG_PINGREQ) {
+      request_type = 0;
+    }
+    break;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+tcpip_handler(void)
+{
+  const uint8_t *p = uip_appdata;
+  uint16_t len = uip_datalen();
+  uint16_t packet_len;
+  uint16_t pos;
+  uint8_t type;
+
+  if(!uip_newdata() || state == STATE_DISCONNECTED || len < 2) {
+    return;
+  }
+
+  if(p[0] == LONG_LENGTH_MARKER) {
+    if(len < 4) {
+      return;
+    }
+    packet_len = get16(&p[1]);
+    type = p[3];
+    pos = 4;
+  } else {
+    packet_len = p[0];
+    type = p[1];
+    pos = 2;
+  }
+
+  if(packet_len < pos || packet_len > len) {
+    return;
+  }
+  len = packet_len - pos;
+
+  switch(type) {
+  case MSG_REGISTER:
+    handle_register(&p[pos], len);
+    break;
+  case MSG_PUBLISH:
+    handle_publish(&p[pos], len);
+    break;
+  case MSG_DISCONNECT:
+    PRINTF("MQTT-SN: Disconnected by the gateway\n");
+    go_disconnected();
+    break;
+  default:
+    handle_ack(type, &p[pos], len);
+    break;
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+mqtt_sn_register(struct process *process, const char *id,
+                 mqtt_sn_event_callback_t callback)
+{
+  app_process = process;
+  client_id = id;
+  event_callback = callback;
+
+  state = STATE_DISCONNECTED;
+  request_type = 0;
+  memset(topics, 0, sizeof(topics));
+
+  if(!process_is_running(&mqtt_sn_process)) {
+    process_start(&mqtt_sn_process, NULL);
+  }
+}
+/*---------------------------------------------------------------------------*/
+int
+mqtt_sn_predefine(const char *topic, uint16_t topic_id)
+{
+  topic_t *t = add_topic(topic);
+
+  if(t == NULL) {
+    return 0;
+  }
+
+  t->id = topic_id;
+  t->flags = TOPIC_USED | TOPIC_REGISTERED | TOPIC_PREDEFINED;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+int
+mqtt_sn_connect(const char *host, uint16_t port, uint16_t keep_alive_secs,
+                uint8_t no_session)
+{
+  if(uiplib_ipaddrconv(host, &gateway_addr) == 0) {
+    return 0;
+  }
+
+  gateway_port = port;
+  keep_alive = keep_alive_secs;
+  connectionless = no_session;
+  state = STATE_CONNECTING;
+  request_type = 0;
+
+  /* The connection has to be opened by our process, to get its events */
+  process_poll(&mqtt_sn_process);
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+void
+mqtt_sn_disconnect(void)
+{
+  if(state == STATE_CONNECTED) {
+    send_packet(start_packet(MSG_DISCONNECT, 0));
+  }
+
+  go_disconnected();
+}
+/*---------------------------------------------------------------------------*/
+int
+mqtt_sn_ready(void)
+{
+  return state == STATE_CONNECTED || state == STATE_CONNECTIONLESS;
+}
+/*---------------------------------------------------------------------------*/
+int
+mqtt_sn_disconnected(void)
+{
+  return state == STATE_DISCONNECTED;
+}
+/*---------------------------------------------------------------------------*/
+/* A new message gets the next message ID, a resend keeps *mid */
+static int
+publish(uint16_t *mid, uint8_t dup, const char *topic, const uint8_t *payload,
+        uint16_t len, int8_t qos)
+{
+  topic_t *t;
+  uint16_t pos;
+
+  if(!mqtt_sn_ready() || len > MQTT_SN_MAX_PAYLOAD ||
+     (state == STATE_CONNECTIONLESS && qos != MQTT_SN_QOS_MINUS_1)) {
+    return MQTT_SN_STATUS_ERROR;
+  }
+
+  t = find_topic(topic);
+  if(t != NULL && (t->flags & TOPIC_REJECTED)) {
+    return MQTT_SN_STATUS_ERROR;
+  }
+
+  /* QoS -1 can't wait for a REGACK. Its topics must be predefined */
+  if(qos == MQTT_SN_QOS_MINUS_1 &&
+     (t == NULL || !(t->flags & TOPIC_PREDEFINED))) {
+    return MQTT_SN_STATUS_ERROR;
+  }
+
+  if(t == NULL || !(t->flags & TOPIC_REGISTERED)) {
+    if(request_type != 0) {
+      return MQTT_SN_STATUS_BUSY;
+    }
+    request_topic = add_topic(topic);
+    if(request_topic == NULL) {
+      PRINTF("MQTT-SN: No room for topic %s\n", topic);
+      return MQTT_SN_STATUS_ERROR;
+    }
+    start_request(MSG_REGISTER);
+    return MQTT_SN_STATUS_BUSY;
+  }
+
+  if(!dup) {
+    *mid = qos == MQTT_SN_QOS_1 ? next_mid() : 0;
+  }
+
+  pos = start_packet(MSG_PUBLISH, 5 + len);
+  tx_buf[pos] = ((qos & FLAG_QOS_MASK) << FLAG_QOS_SHIFT) |
+    (t->flags & TOPIC_PREDEFINED ? FLAG_TOPIC_PREDEFINED : FLAG_TOPIC_NORMAL) |
+    (dup ? FLAG_DUP : 0);
+  put16(&tx_buf[pos + 1], t->id);
+  put16(&tx_buf[pos + 3], *mid);
+  memcpy(&tx_buf[pos + 5], payload, len);
+  send_packet(pos + 5 + len);
+
+  return MQTT_SN_STATUS_OK;
+}
+/*---------------------------------------------------------------------------*/
+int
+mqtt_sn_publish(uint16_t *mid, const char *topic, const uint8_t *payload,
+                uint16_t len, int8_t qos)
+{
+  return publish(mid, 0, topic, payload, len, qos);
+}
+/*---------------------------------------------------------------------------*/
+int
+mqtt_sn_resend(uint16_t mid, const char *topic, const uint8_t *payload,
+               uint16_t len)
+{
+  return publish(&mid, 1, topic, payload, len, MQTT_SN_QOS_1);
+}
+/*---------------------------------------------------------------------------*/
+int
+mqtt_sn_subscribe(const char *topic, int8_t qos)
+{
+  if(state != STATE_CONNECTED) {
+    return MQTT_SN_STATUS_ERROR;
+  }
+
+  if(request_type != 0) {
+    return MQTT_SN_STATUS_BUSY;
+  }
+
+  request_filter = topic;
+  request_qos = qos;
+  start_request(MSG_SUBSCRIBE);
+  return MQTT_SN_STATUS_OK;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(mqtt_sn_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  while(1) {
+    PROCESS_YIELD();
+    if(ev == PROCESS_EVENT_POLL && state == STATE_CONNECTING &&
+       request_type == 0) {
+      open_connection();
+    } else if(ev == PROCESS_EVENT_TIMER && data == &retry_timer) {
+      check_request();
+    } else if(ev == PROCESS_EVENT_TIMER && data == &ping_timer) {
+      ping();
+    } else if(ev == tcpip_event) {
+      tcpip_handler();
+    }
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * @}
+ */
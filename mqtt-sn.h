@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \addtogroup cc26xx-web-demo
+ * @{
+ *
+ * \file
+ *   Header file for the MQTT-SN client of the CC26XX web demo.
+ *
+ *   An alternative to the TCP MQTT engine for the publish path. Talks
+ *   MQTT-SN v1.2 over UDP to a gateway, which relays to the MQTT broker.
+ *   Every packet is a single datagram, so there are no per-segment ACKs and
+ *   no TCP handshake. Topics are registered once per session and then
+ *   referred to by a 2-byte ID.
+ *
+ *   Supports QoS 0 and 1 and, with topic IDs predefined on the gateway,
+ *   connectionless QoS -1 publishes.
+ */
+/*---------------------------------------------------------------------------*/
+#ifndef MQTT_SN_H_
+#define MQTT_SN_H_
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+
+#include <stdint.h>
+/*---------------------------------------------------------------------------*/
+/*
+ * The largest packet we send. Payloads go out from a buffer of this size,
+ * so it costs as much RAM. It must fit in the uIP buffer with the IPv6 and
+ * UDP headers
+ */
+#ifdef MQTT_SN_CONF_MAX_PACKET_LEN
+#define MQTT_SN_MAX_PACKET_LEN MQTT_SN_CONF_MAX_PACKET_LEN
+#else
+#define MQTT_SN_MAX_PACKET_LEN         512
+#endif
+
+/* The largest payload that fits in a PUBLISH */
+#define MQTT_SN_MAX_PAYLOAD            (MQTT_SN_MAX_PACKET_LEN - 9)
+
+/* Topics we can hold IDs for: our own publish topics and incoming ones */
+#ifdef MQTT_SN_CONF_TOPIC_MAX
+#define MQTT_SN_TOPIC_MAX MQTT_SN_CONF_TOPIC_MAX
+#else
+#define MQTT_SN_TOPIC_MAX                6
+#endif
+
+#define MQTT_SN_TOPIC_NAME_LEN          64
+
+/* Retransmission of CONNECT, REGISTER, SUBSCRIBE and PINGREQ */
+#ifdef MQTT_SN_CONF_RETRY_INTERVAL
+#define MQTT_SN_RETRY_INTERVAL MQTT_SN_CONF_RETRY_INTERVAL
+#else
+#define MQTT_SN_RETRY_INTERVAL         (CLOCK_SECOND * 5)
+#endif
+
+/* Unanswered retransmissions after which the gateway is considered lost */
+#ifdef MQTT_SN_CONF_RETRY_MAX
+#define MQTT_SN_RETRY_MAX MQTT_SN_CONF_RETRY_MAX
+#else
+#define MQTT_SN_RETRY_MAX                3
+#endif
+/*---------------------------------------------------------------------------*/
+/* Publish QoS levels. -1 needs no connection, only a predefined topic ID */
+#define MQTT_SN_QOS_MINUS_1             -1
+#define MQTT_SN_QOS_0                    0
+#define MQTT_SN_QOS_1                    1
+
+/* Return values of mqtt_sn_publish() and mqtt_sn_subscribe() */
+#define MQTT_SN_STATUS_OK                0
+#define MQTT_SN_STATUS_BUSY              1 /* Try again shortly */
+#define MQTT_SN_STATUS_ERROR             2
+/*---------------------------------------------------------------------------*/
+typedef enum {
+  MQTT_SN_EVENT_CONNECTED,
+  MQTT_SN_EVENT_DISCONNECTED,
+  MQTT_SN_EVENT_REGACK,    /* A topic got its ID. Publishes may proceed */
+  MQTT_SN_EVENT_SUBACK,
+  MQTT_SN_EVENT_PUBLISH,   /* data: a mqtt_sn_message_t */
+  MQTT_SN_EVENT_PUBACK,    /* data: the uint16_t message ID */
+} mqtt_sn_event_t;
+
+typedef struct mqtt_sn_message {
+  const char *topic;
+  const uint8_t *payload;
+  uint16_t payload_length;
+} mqtt_sn_message_t;
+
+typedef void (*mqtt_sn_event_callback_t)(mqtt_sn_event_t event, void *data);
+/*---------------------------------------------------------------------------*/
+PROCESS_NAME(mqtt_sn_process);
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief Sets up the client, forgetting all topic IDs
+ * \param app_process The process to run the event callback in
+ * \param client_id The client ID. Must stay valid while in use
+ * \param event_callback Called on connection changes, acks and publishes
+ */
+void mqtt_sn_register(struct process *app_process, const char *client_id,
+                      mqtt_sn_event_callback_t event_callback);
+
+/**
+ * \brief Adds a topic ID that the gateway has been configured with
+ * \param topic The topic name
+ * \param topic_id Its ID on the gateway
+ * \return 1 on success, 0 if the topic table is full
+ */
+int mqtt_sn_predefine(const char *topic, uint16_t topic_id);
+
+/**
+ * \brief Connects to a gateway. Completion is signalled by an event
+ * \param host The gateway's IPv6 address
+ * \param port The gateway's UDP port
+ * \param keep_alive Keep-alive interval, in seconds
+ * \param connectionless 1 to skip CONNECT and only publish at QoS -1
+ * \return 1 if the connection is under way, 0 on a bad address
+ */
+int mqtt_sn_connect(const char *host, uint16_t port, uint16_t keep_alive,
+                    uint8_t connectionless);
+
+/**
+ * \brief Ends the session, if any. Signalled by a disconnected event
+ */
+void mqtt_sn_disconnect(void);
+
+/**
+ * \brief Returns whether publishes can be sent
+ */
+int mqtt_sn_ready(void);
+
+/**
+ * \brief Returns whether there is neither a session nor one under way
+ */
+int mqtt_sn_disconnected(void);
+
+/**
+ * \brief Publishes a message
+ * \param mid Set to the message ID, which a PUBACK event will carry
+ * \param topic The topic name. Gets registered on first use
+ * \param payload The message, of at most MQTT_SN_MAX_PAYLOAD bytes
+ * \param len The message length
+ * \param qos One of MQTT_SN_QOS_xyz
+ * \return MQTT_SN_STATUS_BUSY while the topic is being registered
+ */
+int mqtt_sn_publish(uint16_t *mid, const char *topic, const uint8_t *payload,
+                    uint16_t len, int8_t qos);
+
+/**
+ * \brief Sends a QoS 1 message again, with the DUP flag set
+ * \param mid The message ID mqtt_sn_publish() gave it. A late PUBACK for the
+ *        first copy still matches
+ * \param topic, payload, len As for mqtt_sn_publish()
+ * \return As for mqtt_sn_publish()
+ */
+int mqtt_sn_resend(uint16_t mid, const char *topic, const uint8_t *payload,
+                   uint16_t len);
+
+/**
+ * \brief Subscribes to a topic, possibly with wildcards
+ * \param topic The topic filter. Must stay valid until the SUBACK
+ * \param qos MQTT_SN_QOS_0 or MQTT_SN_QOS_1
+ * \return MQTT_SN_STATUS_BUSY while another request awaits its answer
+ */
+int mqtt_sn_subscribe(const char *topic, int8_t qos);
+/*---------------------------------------------------------------------------*/
+#endif /* MQTT_SN_H_ */
+/*---------------------------------------------------------------------------*/
+/**
+ * @}
+ */
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \addtogroup cc26xx-web-demo
+ * @{
+ *
+ * \file
+ *   Stand-in for the SensorTag board-peripherals.h in native builds. Declares
+ *   the mock sensors implemented in sensors-mock.c
+ */
+/*---------------------------------------------------------------------------*/
+#ifndef BOARD_PERIPHERALS_H_
+#define BOARD_PERIPHERALS_H_
+/*---------------------------------------------------------------------------*/
+#include "lib/sensors.h"
+#include "ext-flash.h"
+#include "button-sensor.h"
+/*---------------------------------------------------------------------------*/
+#ifndef CC26XX_SENSOR_READING_ERROR
+#define CC26XX_SENSOR_READING_ERROR 0x80000000
+#endif
+/*---------------------------------------------------------------------------*/
+/* Same values as the MPU-9250 driver */
+#define MPU_9250_SENSOR_TYPE_GYRO_Z  0x01
+#define MPU_9250_SENSOR_TYPE_GYRO_Y  0x02
+#define MPU_9250_SENSOR_TYPE_GYRO_X  0x04
+#define MPU_9250_SENSOR_TYPE_ACC_Z   0x08
+#define MPU_9250_SENSOR_TYPE_ACC_Y   0x10
+#define MPU_9250_SENSOR_TYPE_ACC_X   0x20
+
+#define MPU_9250_SENSOR_TYPE_GYRO    0x07
+#define MPU_9250_SENSOR_TYPE_ACC     0x38
+#define MPU_9250_SENSOR_TYPE_ALL     0x3F
+/*---------------------------------------------------------------------------*/
+extern const struct sensors_sensor mpu_9250_sensor;
+extern const struct sensors_sensor reed_relay_sensor;
+/*---------------------------------------------------------------------------*/
+#endif /* BOARD_PERIPHERALS_H_ */
+/*---------------------------------------------------------------------------*/
+/**
+ * @}
+ */
@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \addtogroup cc26xx-web-demo
+ * @{
+ *
+ * \file
+ *   A file-backed external flash for native builds. Like the real part,
+ *   erasing sets bytes to 0xFF and programming can only clear bits
+ */
+/*---------------------------------------------------------------------------*/
+#include "ext-flash.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+#define CHUNK_LEN 256
+/*---------------------------------------------------------------------------*/
+static FILE *flash;
+/*---------------------------------------------------------------------------*/
+static bool
+in_range(size_t offset, size_t length)
+{
+  return offset <= EXT_FLASH_MOCK_SIZE &&
+         length <= EXT_FLASH_MOCK_SIZE - offset;
+}
+/*---------------------------------------------------------------------------*/
+static bool
+fill(size_t offset, size_t length)
+{
+  uint8_t blank[CHUNK_LEN];
+  size_t n;
+
+  memset(blank, 0xFF, sizeof(blank));
+
+  if(fseek(flash, offset, SEEK_SET) != 0) {
+    return false;
+  }
+
+  while(length > 0) {
+    n = length < CHUNK_LEN ? length : CHUNK_LEN;
+    if(fwrite(blank, 1, n, flash) != n) {
+      return false;
+    }
+    length -= n;
+  }
+
+  return true;
+}
+/*---------------------------------------------------------------------------*/
+bool
+ext_flash_open(void)
+{
+  long size;
+
+  if(flash != NULL) {
+    return true;
+  }
+
+  flash = fopen(EXT_FLASH_MOCK_FILE, "r+b");
+  if(flash == NULL) {
+    flash = fopen(EXT_FLASH_MOCK_FILE, "w+b");
+  }
+  if(flash == NULL) {
+    printf("Could not open %s\n", EXT_FLASH_MOCK_FILE);
+    return false;
+  }
+
+  /* A new or short file reads as erased flash */
+  fseek(flash, 0, SEEK_END);
+  size = ftell(flash);
+  if(size < EXT_FLASH_MOCK_SIZE &&
+     !fill(size, EXT_FLASH_MOCK_SIZE - size)) {
+    ext_flash_close();
+    return false;
+  }
+
+  return true;
+}
+/*---------------------------------------------------------------------------*/
+void
+ext_flash_close(void)
+{
+  if(flash != NULL) {
+    fclose(flash);
+    flash = NULL;
+  }
+}
+/*---------------------------------------------------------------------------*/
+bool
+ext_flash_read(size_t offset, size_t length, uint8_t *buf)
+{
+  if(flash == NULL || !in_range(offset, length)) {
+    return false;
+  }
+
+  if(fseek(flash, offset, SEEK_SET) != 0) {
+    return false;
+  }
+
+  return fread(buf, 1, length, flash) == length;
+}
+/*---------------------------------------------------------------------------*/
+bool
+ext_flash_write(size_t offset, size_t length, const uint8_t *buf)
+{
+  uint8_t cur[CHUNK_LEN];
+  size_t n;
+  size_t i;
+
+  if(flash == NULL || !in_range(offset, length)) {
+    return false;
+  }
+
+  while(length > 0) {
+    n = length < CHUNK_LEN ? length : CHUNK_LEN;
+
+    if(fseek(flash, offset, SEEK_SET) != 0 ||
+       fread(cur, 1, n, flash) != n) {
+      return false;
+    }
+
+    /* Programming can only turn ones into zeros */
+    for(i = 0; i < n; i++) {
+      cur[i] &= buf[i];
+    }
+
+    if(fseek(flash, offset, SEEK_SET) != 0 ||
+       fwrite(cur, 1, n, flash) != n) {
+      return false;
+    }
+
+    offset += n;
+    buf += n;
+    length -= n;
+  }
+
+  return fflush(flash) == 0;
+}
+/*---------------------------------------------------------------------------*/
+bool
+ext_flash_erase(size_t offset, size_t length)
+{
+  size_t end;
+
+  if(flash == NULL || !in_range(offset, length)) {
+    return false;
+  }
+
+  /* Whole sectors get erased, as with the real part */
+  end = offset + length;
+  offset -= offset % EXT_FLASH_ERASE_SECTOR_SIZE;
+  end += (EXT_FLASH_ERASE_SECTOR_SIZE - end % EXT_FLASH_ERASE_SECTOR_SIZE) %
+    EXT_FLASH_ERASE_SECTOR_SIZE;
+
+  if(!fill(offset, end - offset)) {
+    return false;
+  }
+
+  return fflush(flash) == 0;
+}
+/*---------------------------------------------------------------------------*/
+bool
+ext_flash_test(void)
+{
+  bool ret = ext_flash_open();
+
+  ext_flash_close();
+
+  return ret;
+}
+/*---------------------------------------------------------------------------*/
+void
+ext_flash_init(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * @}
+ */
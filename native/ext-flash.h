@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \addtogroup cc26xx-web-demo
+ * @{
+ *
+ * \file
+ *   Stand-in for the CC26xx ext-flash.h in native builds. The flash is backed
+ *   by a file on the host, so saved settings and the publish spool survive a
+ *   restart of the process
+ */
+/*---------------------------------------------------------------------------*/
+#ifndef EXT_FLASH_H_
+#define EXT_FLASH_H_
+/*---------------------------------------------------------------------------*/
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+/*---------------------------------------------------------------------------*/
+/* Host file that holds the flash contents */
+#ifdef EXT_FLASH_MOCK_CONF_FILE
+#define EXT_FLASH_MOCK_FILE EXT_FLASH_MOCK_CONF_FILE
+#else
+#define EXT_FLASH_MOCK_FILE "ext-flash.bin"
+#endif
+
+/* Same size as the SensorTag's part */
+#define EXT_FLASH_MOCK_SIZE   0x100000
+#define EXT_FLASH_ERASE_SECTOR_SIZE 4096
+/*---------------------------------------------------------------------------*/
+bool ext_flash_open(void);
+void ext_flash_close(void);
+bool ext_flash_read(size_t offset, size_t length, uint8_t *buf);
+bool ext_flash_write(size_t offset, size_t length, const uint8_t *buf);
+bool ext_flash_erase(size_t offset, size_t length);
+bool ext_flash_test(void);
+void ext_flash_init(void);
+/*---------------------------------------------------------------------------*/
+#endif /* EXT_FLASH_H_ */
+/*---------------------------------------------------------------------------*/
+/**
+ * @}
+ */
@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \addtogroup cc26xx-web-demo
+ * @{
+ *
+ * \file
+ *   Synthetic sensors for native builds: the battery monitor, the MPU-9250 in
+ *   polled mode, the reed relay and the buttons. Values follow the same
+ *   patterns as the MPU FIFO mock, so either acquisition mode produces
+ *   comparable payloads
+ */
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+#include "lib/sensors.h"
+#include "board-peripherals.h"
+#include "batmon-sensor.h"
+#include "button-sensor.h"
+
+#include <stdint.h>
+/*---------------------------------------------------------------------------*/
+/* Time the real MPU needs between power-up and the first reading */
+#define MPU_STARTUP_DELAY (CLOCK_SECOND / 10)
+/*---------------------------------------------------------------------------*/
+static struct ctimer mpu_startup_timer;
+static uint32_t mpu_samples;
+static int mpu_enabled;
+/*---------------------------------------------------------------------------*/
+/* A triangle wave with a period of 64 samples */
+static int
+triangle(uint32_t n, int amplitude)
+{
+  int phase = n & 0x3F;
+
+  phase = phase < 32 ? phase : 64 - phase;
+
+  return (phase - 16) * amplitude / 16;
+}
+/*---------------------------------------------------------------------------*/
+static int
+batmon_value(int type)
+{
+  switch(type) {
+  case BATMON_SENSOR_TYPE_TEMP:
+    return 25;
+  case BATMON_SENSOR_TYPE_VOLT:
+    /* 3 V, in the batmon's 1/256 V units */
+    return 3 << 8;
+  default:
+    return CC26XX_SENSOR_READING_ERROR;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+batmon_configure(int type, int enable)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+batmon_status(int type)
+{
+  return SENSORS_READY;
+}
+/*---------------------------------------------------------------------------*/
+SENSORS_SENSOR(batmon_sensor, "Battery Monitor", batmon_value,
+               batmon_configure, batmon_status);
+/*---------------------------------------------------------------------------*/
+static void
+mpu_ready(void *data)
+{
+  /* Like the real driver, tell the world that a reading can be taken */
+  process_post(PROCESS_BROADCAST, sensors_event,
+               (void *)&mpu_9250_sensor);
+}
+/*---------------------------------------------------------------------------*/
+static int
+mpu_value(int type)
+{
+  if(!mpu_enabled) {
+    return CC26XX_SENSOR_READING_ERROR;
+  }
+
+  /* Every poll of the full set reads GYRO_X first. Count samples there */
+  switch(type) {
+  case MPU_9250_SENSOR_TYPE_GYRO_X:
+    mpu_samples++;
+    return 0;
+  case MPU_9250_SENSOR_TYPE_GYRO_Y:
+    return 0;
+  case MPU_9250_SENSOR_TYPE_GYRO_Z:
+    return triangle(mpu_samples, 3000);
+  case MPU_9250_SENSOR_TYPE_ACC_X:
+    return triangle(mpu_samples, 10);
+  case MPU_9250_SENSOR_TYPE_ACC_Y:
+    return 0;
+  case MPU_9250_SENSOR_TYPE_ACC_Z:
+    return 100;
+  default:
+    return CC26XX_SENSOR_READING_ERROR;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+mpu_configure(int type, int enable)
+{
+  if(type != SENSORS_ACTIVE) {
+    return 0;
+  }
+
+  mpu_enabled = enable & MPU_9250_SENSOR_TYPE_ALL;
+  if(mpu_enabled) {
+    ctimer_set(&mpu_startup_timer, MPU_STARTUP_DELAY, mpu_ready, NULL);
+  } else {
+    ctimer_stop(&mpu_startup_timer);
+  }
+
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+mpu_status(int type)
+{
+  return mpu_enabled ? SENSORS_READY : 0;
+}
+/*---------------------------------------------------------------------------*/
+SENSORS_SENSOR(mpu_9250_sensor, "MPU9250", mpu_value, mpu_configure,
+               mpu_status);
+/*---------------------------------------------------------------------------*/
+/* The reed relay and the buttons never trigger */
+static int
+idle_value(int type)
+{
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+idle_configure(int type, int enable)
+{
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+idle_status(int type)
+{
+  return SENSORS_READY;
+}
+/*---------------------------------------------------------------------------*/
+SENSORS_SENSOR(reed_relay_sensor, "REED", idle_value, idle_configure,
+               idle_status);
+SENSORS_SENSOR(button_left_sensor, "Left Button", idle_value,
+               idle_configure, idle_status);
+SENSORS_SENSOR(button_right_sensor, "Right Button", idle_value,
+               idle_configure, idle_status);
+SENSORS_SENSOR(button_up_sensor, "Up Button", idle_value, idle_configure,
+               idle_status);
+SENSORS_SENSOR(button_down_sensor, "Down Button", idle_value,
+               idle_configure, idle_status);
+SENSORS_SENSOR(button_select_sensor, "Select Button", idle_value,
+               idle_configure, idle_status);
+/*---------------------------------------------------------------------------*/
+/**
+ * @}
+ */
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \addtogroup cc26xx-web-demo
+ * @{
+ *
+ * \file
+ *   A ring of the motion frames sampled just before a trigger
+ */
+/*---------------------------------------------------------------------------*/
+#include "pretrigger.h"
+#include "motion-buffer.h"
+
+#include <stdint.h>
+/*---------------------------------------------------------------------------*/
+static motion_frame_t frames[PRETRIGGER_MAX_DEPTH];
+static uint16_t depth;
+static uint16_t head; /* Index of the oldest frame */
+static uint16_t count;
+/*---------------------------------------------------------------------------*/
+void
+pretrigger_init(uint16_t d)
+{
+  depth = d < PRETRIGGER_MAX_DEPTH ? d : PRETRIGGER_MAX_DEPTH;
+  head = 0;
+  count = 0;
+}
+/*---------------------------------------------------------------------------*/
+void
+pretrigger_push(const motion_frame_t *frame)
+{
+  uint16_t tail = head + count;
+
+  if(depth == 0) {
+    return;
+  }
+
+  if(tail >= depth) {
+    tail -= depth;
+  }
+
+  frames[tail] = *frame;
+
+  if(count < depth) {
+    count++;
+  } else {
+    head = head + 1 < depth ? head + 1 : 0;
+  }
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+pretrigger_release(void)
+{
+  uint16_t released = count;
+
+  while(count > 0) {
+    frames[head].flags |= MOTION_FRAME_FLAG_PRETRIGGER;
+    motion_buffer_push(&frames[head]);
+    head = head + 1 < depth ? head + 1 : 0;
+    count--;
+  }
+
+  head = 0;
+
+  return released;
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+pretrigger_depth(void)
+{
+  return depth;
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * @}
+ */
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \addtogroup cc26xx-web-demo
+ * @{
+ *
+ * \file
+ *   Header file for the pre-trigger buffer.
+ *
+ *   While the node waits for a trigger, a small ring keeps the last few
+ *   low-rate motion frames. When the trigger fires, they are frozen and
+ *   moved to the motion buffer ahead of the samples of the new window, like
+ *   the pre-trigger part of an oscilloscope capture.
+ */
+/*---------------------------------------------------------------------------*/
+#ifndef PRETRIGGER_H_
+#define PRETRIGGER_H_
+/*---------------------------------------------------------------------------*/
+#include "motion-buffer.h"
+
+#include <stdint.h>
+/*---------------------------------------------------------------------------*/
+/* Size of the static ring in frames, i.e. the largest possible depth */
+#ifdef PRETRIGGER_CONF_MAX_DEPTH
+#define PRETRIGGER_MAX_DEPTH PRETRIGGER_CONF_MAX_DEPTH
+#else
+#define PRETRIGGER_MAX_DEPTH 32
+#endif
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief Empties the ring and sets its depth
+ * \param depth The number of frames kept. Clipped to PRETRIGGER_MAX_DEPTH.
+ *        0 disables pre-trigger capture
+ */
+void pretrigger_init(uint16_t depth);
+
+/**
+ * \brief Appends a frame, overwriting the oldest one once the ring is full
+ * \param frame A pointer to the frame to be copied in
+ */
+void pretrigger_push(const motion_frame_t *frame);
+
+/**
+ * \brief Moves all frames to the motion buffer, oldest first, and empties
+ *        the ring
+ * \return The number of frames moved
+ *
+ * Moved frames carry MOTION_FRAME_FLAG_PRETRIGGER
+ */
+uint16_t pretrigger_release(void);
+
+/**
+ * \brief Returns the configured depth
+ */
+uint16_t pretrigger_depth(void);
+/*---------------------------------------------------------------------------*/
+#endif /* PRETRIGGER_H_ */
+/*---------------------------------------------------------------------------*/
+/**
+ * @}
+ */
@@ -39,6 +39,21 @@
 /* Enable/Disable Components of this Demo */
 #define CC26XX_WEB_DEMO_CONF_MQTT_CLIENT      1
 #define CC26XX_WEB_DEMO_CONF_6LBR_CLIENT      0
+
+/* Wall-clock timestamps over SNTP. Needs a server, see README.md */
+#define CC26XX_WEB_DEMO_CONF_SNTP_CLIENT      0
+
+/* MQTT-SN over UDP as an alternative transport. Needs a gateway */
+#define CC26XX_WEB_DEMO_CONF_MQTT_SN          0
+
+/* Leave the MPU sampling into its FIFO and drain it in bursts */
+#define CC26XX_WEB_DEMO_CONF_MPU_FIFO         0
+
+/* Spool motion publishes to external flash while offline. See README.md */
+#define CC26XX_WEB_DEMO_CONF_PUBLISH_SPOOL    0
+
+/* Account for CPU, radio and MPU on-time. See README.md */
+#define ENERGEST_CONF_ON                      1
 /*---------------------------------------------------------------------------*/
 /*
  * Shrink the size of the uIP buffer, routing table and ND cache.
@@ -53,5 +68,14 @@
 #define MPU_9250_SENSOR_CONF_ACC_RANGE 		MPU_9250_SENSOR_ACC_RANGE_2G
 #define MPU_9250_SENSOR_CONF_ACC_SAMPLING 	MPU_9250_SENSOR_ACC_SAMPLING_1_95
 /*---------------------------------------------------------------------------*/
+/* Host builds (make TARGET=native): mock sensors and a broker on tap0 */
+#if CONTIKI_TARGET_NATIVE
+#define BOARD_STRING                    "Native (mock sensors)"
+#define MPU_FIFO_CONF_DRIVER            mpu_fifo_mock_driver
+#define MPU_WOM_CONF_DRIVER             mpu_wom_mock_driver
+#define MQTT_CLIENT_CONF_BROKER_IP_ADDR "fd00::1"
+#define MQTT_CLIENT_CONF_BENCH                1
+#endif
+/*---------------------------------------------------------------------------*/
 #endif /* PROJECT_CONF_H_ */
 /*---------------------------------------------------------------------------*/
@@ -0,0 +1,358 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \addtogroup cc26xx-web-demo
+ * @{
+ *
+ * \file
+ *   A log-structured spool of publish payloads in external flash
+ */
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+#include "ext-flash.h"
+#include "publish-spool.h"
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+#define DEBUG 0
+#if DEBUG
+#define PRINTF(...) printf(__VA_ARGS__)
+#else
+#define PRINTF(...)
+#endif
+/*---------------------------------------------------------------------------*/
+#define RECORD_MAGIC    0x5053
+
+/* Flags are erased to 0xFF and programmed to 0x00 without another erase */
+#define FLAG_CLEAR        0xFF
+#define FLAG_SET          0x00
+/*---------------------------------------------------------------------------*/
+typedef struct record_header {
+  uint16_t magic;
+  uint16_t len;
+  uint32_t seq;
+  uint8_t format;
+  uint8_t committed; /* Programmed once the payload is fully written */
+  uint8_t consumed;  /* Programmed once the payload has been sent */
+  uint8_t reserved;
+} record_header_t;
+
+#define HEADER_LEN        sizeof(record_header_t)
+#define RECORD_LEN(h)     (HEADER_LEN + (h)->len)
+#define SECTOR_START(pos) ((pos) - ((pos) % PUBLISH_SPOOL_SECTOR_SIZE))
+#define SECTOR_END(pos)   (SECTOR_START(pos) + PUBLISH_SPOOL_SECTOR_SIZE)
+/*---------------------------------------------------------------------------*/
+/* Positions are relative to PUBLISH_SPOOL_OFFSET */
+static uint32_t read_pos;  /* At or before the oldest pending record */
+static uint32_t write_pos; /* Where the next record goes */
+static uint32_t next_seq;
+static uint16_t pending;
+static uint16_t dropped;
+static uint8_t usable;
+/*---------------------------------------------------------------------------*/
+static uint32_t
+wrap(uint32_t pos)
+{
+  return pos >= PUBLISH_SPOOL_SIZE ? pos - PUBLISH_SPOOL_SIZE : pos;
+}
+/*---------------------------------------------------------------------------*/
+/* Reads a header. Returns 1 if it looks like a record that fits its sector */
+static int
+read_header(uint32_t pos, record_header_t *h)
+{
+  if(SECTOR_END(pos) - pos < HEADER_LEN) {
+    return 0;
+  }
+
+  if(!ext_flash_read(PUBLISH_SPOOL_OFFSET + pos, HEADER_LEN, (uint8_t *)h)) {
+    return 0;
+  }
+
+  return h->magic == RECORD_MAGIC &&
+         h->len <= PUBLISH_SPOOL_SECTOR_SIZE - HEADER_LEN &&
+         pos + RECORD_LEN(h) <= SECTOR_END(pos);
+}
+/*---------------------------------------------------------------------------*/
+static int
+is_pending(const record_header_t *h)
+{
+  return h->committed == FLAG_SET && h->consumed != FLAG_SET;
+}
+/*---------------------------------------------------------------------------*/
+static void
+set_flag(uint32_t pos, size_t field)
+{
+  uint8_t flag = FLAG_SET;
+
+  ext_flash_write(PUBLISH_SPOOL_OFFSET + pos + field, 1, &flag);
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Moves read_pos forward to the oldest pending record. Returns 1 with its
+ * header in h, or 0 if there are none. The flash must be open
+ */
+static int
+seek_pending(record_header_t *h)
+{
+  while(pending > 0 && read_pos != write_pos) {
+    if(!read_header(read_pos, h)) {
+      /* Nothing more in this sector */
+      read_pos = wrap(SECTOR_END(read_pos));
+      continue;
+    }
+
+    if(is_pending(h)) {
+      return 1;
+    }
+
+    read_pos = wrap(read_pos + RECORD_LEN(h));
+  }
+
+  /* Resynchronise, in case the count drifted from what is on flash */
+  pending = 0;
+  read_pos = write_pos;
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Accounts for the pending records of a sector that is about to be erased */
+static void
+drop_sector(uint32_t start)
+{
+  record_header_t h;
+  uint32_t pos = start;
+
+  while(pos < start + PUBLISH_SPOOL_SECTOR_SIZE && read_header(pos, &h)) {
+    if(is_pending(&h) && pending > 0) {
+      pending--;
+      dropped++;
+    }
+    pos += RECORD_LEN(&h);
+  }
+
+  if(SECTOR_START(read_pos) == start) {
+    read_pos = wrap(start + PUBLISH_SPOOL_SECTOR_SIZE);
+  }
+}
+/*---------------------------------------------------------------------------*/
+int
+publish_spool_init(void)
+{
+  record_header_t h;
+  uint32_t sector;
+  uint32_t pos;
+  uint32_t oldest_seq = 0;
+  uint8_t found = 0;
+
+  read_pos = 0;
+  write_pos = 0;
+  next_seq = 0;
+  pending = 0;
+  dropped = 0;
+  usable = 0;
+
+  if(!ext_flash_open()) {
+    printf("Spool: could not open flash\n");
+    ext_flash_close();
+    return 0;
+  }
+
+  /* Rebuild the ring pointers from sequence numbers */
+  for(sector = 0; sector < PUBLISH_SPOOL_SIZE;
+      sector += PUBLISH_SPOOL_SECTOR_SIZE) {
+    pos = sector;
+    while(pos < sector + PUBLISH_SPOOL_SECTOR_SIZE && read_header(pos, &h)) {
+      if(!found || h.seq >= next_seq) {
+        next_seq = h.seq + 1;
+        write_pos = wrap(pos + RECORD_LEN(&h));
+      }
+      found = 1;
+
+      if(is_pending(&h)) {
+        if(pending == 0 || h.seq < oldest_seq) {
+          oldest_seq = h.seq;
+          read_pos = pos;
+        }
+        pending++;
+      }
+
+      pos += RECORD_LEN(&h);
+    }
+  }
+
+  ext_flash_close();
+
+  if(pending == 0) {
+    read_pos = write_pos;
+  }
+
+  usable = 1;
+  PRINTF("Spool: %u pending, read 0x%lx, write 0x%lx\n", pending,
+         (unsigned long)read_pos, (unsigned long)write_pos);
+
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+int
+publish_spool_append(const uint8_t *data, uint16_t len, uint8_t format)
+{
+  record_header_t h;
+  int rv;
+
+  if(!usable || len > PUBLISH_SPOOL_SECTOR_SIZE - HEADER_LEN) {
+    return 0;
+  }
+
+  if(!ext_flash_open()) {
+    ext_flash_close();
+    return 0;
+  }
+
+  /* Records don't straddle sectors. Skip the tail of this one if needed */
+  if(write_pos + HEADER_LEN + len > SECTOR_END(write_pos)) {
+    write_pos = wrap(SECTOR_END(write_pos));
+  }
+
+  /* Entering a sector: it holds the oldest data in the ring. Recycle it */
+  if(write_pos % PUBLISH_SPOOL_SECTOR_SIZE == 0) {
+    drop_sector(write_pos);
+    if(!ext_flash_erase(PUBLISH_SPOOL_OFFSET + write_pos,
+                        PUBLISH_SPOOL_SECTOR_SIZE)) {
+      ext_flash_close();
+      return 0;
+    }
+  }
+
+  if(pending == 0) {
+    read_pos = write_pos;
+  }
+
+  memset(&h, FLAG_CLEAR, sizeof(h));
+  h.magic = RECORD_MAGIC;
+  h.len = len;
+  h.seq = next_seq;
+  h.format = format;
+
+  rv = ext_flash_write(PUBLISH_SPOOL_OFFSET + write_pos, HEADER_LEN,
+                       (uint8_t *)&h);
+  rv = rv && ext_flash_write(PUBLISH_SPOOL_OFFSET + write_pos + HEADER_LEN,
+                             len, data);
+  if(rv) {
+    set_flag(write_pos, offsetof(record_header_t, committed));
+    pending++;
+  }
+
+  /* Even a torn record occupies its space */
+  next_seq++;
+  write_pos = wrap(write_pos + HEADER_LEN + len);
+
+  ext_flash_close();
+
+  return rv;
+}
+/*---------------------------------------------------------------------------*/
+int
+publish_spool_peek(uint8_t *buf, uint16_t size, uint8_t *format)
+{
+  record_header_t h;
+  int rv = 0;
+
+  if(!usable || pending == 0) {
+    return 0;
+  }
+
+  if(!ext_flash_open()) {
+    ext_flash_close();
+    return -1;
+  }
+
+  while(seek_pending(&h)) {
+    if(h.len <= size) {
+      if(ext_flash_read(PUBLISH_SPOOL_OFFSET + read_pos + HEADER_LEN, h.len,
+                        buf)) {
+        *format = h.format;
+        rv = h.len;
+      } else {
+        rv = -1;
+      }
+      break;
+    }
+
+    /* Can never be sent from this buffer. Don't let it block the rest */
+    set_flag(read_pos, offsetof(record_header_t, consumed));
+    pending--;
+    dropped++;
+  }
+
+  ext_flash_close();
+
+  return rv;
+}
+/*---------------------------------------------------------------------------*/
+void
+publish_spool_consume(void)
+{
+  record_header_t h;
+
+  if(!usable || pending == 0) {
+    return;
+  }
+
+  if(!ext_flash_open()) {
+    ext_flash_close();
+    return;
+  }
+
+  if(seek_pending(&h)) {
+    set_flag(read_pos, offsetof(record_header_t, consumed));
+    pending--;
+    read_pos = wrap(read_pos + RECORD_LEN(&h));
+  }
+
+  ext_flash_close();
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+publish_spool_pending(void)
+{
+  return pending;
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+publish_spool_dropped(void)
+{
+  return dropped;
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * @}
+ */
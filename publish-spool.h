@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \addtogroup cc26xx-web-demo
+ * @{
+ *
+ * \file
+ *   Header file for the offline publish spool.
+ *
+ *   Serialized publish payloads that could not be sent are appended to a log
+ *   in external flash and read back, oldest first, once the broker can be
+ *   reached again. The log is a ring of erase sectors: records never cross a
+ *   sector boundary and a sector only gets erased when the writer wraps round
+ *   to it, so every sector sees the same number of erase cycles. When the
+ *   ring is full, the oldest sector and the records in it are dropped.
+ */
+/*---------------------------------------------------------------------------*/
+#ifndef PUBLISH_SPOOL_H_
+#define PUBLISH_SPOOL_H_
+/*---------------------------------------------------------------------------*/
+#include <stdint.h>
+/*---------------------------------------------------------------------------*/
+/* Location of the spool in external flash. Must not overlap the config */
+#ifdef PUBLISH_SPOOL_CONF_OFFSET
+#define PUBLISH_SPOOL_OFFSET PUBLISH_SPOOL_CONF_OFFSET
+#else
+#define PUBLISH_SPOOL_OFFSET          0x10000
+#endif
+
+/* Size of the spool in bytes. A multiple of PUBLISH_SPOOL_SECTOR_SIZE */
+#ifdef PUBLISH_SPOOL_CONF_SIZE
+#define PUBLISH_SPOOL_SIZE PUBLISH_SPOOL_CONF_SIZE
+#else
+#define PUBLISH_SPOOL_SIZE            0x10000
+#endif
+
+/* Erase granularity of the external flash */
+#define PUBLISH_SPOOL_SECTOR_SIZE        4096
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief Recovers the state of the spool from flash
+ * \return 1 if the spool is usable, 0 if the flash could not be accessed
+ *
+ * Must be called before any other function of this module. Records left
+ * pending by a previous run will be replayed
+ */
+int publish_spool_init(void);
+
+/**
+ * \brief Appends a payload to the spool
+ * \param data The payload
+ * \param len The payload length
+ * \param format The payload format (MQTT_CLIENT_PAYLOAD_FORMAT_xyz)
+ * \return 1 on success, 0 on failure
+ *
+ * If the spool is full, the oldest records are dropped to make room
+ */
+int publish_spool_append(const uint8_t *data, uint16_t len, uint8_t format);
+
+/**
+ * \brief Reads the oldest pending payload without removing it
+ * \param buf Where to copy the payload
+ * \param size The size of buf
+ * \param format Where to store the format of the payload
+ * \return The payload length, 0 if the spool is empty or -1 on error
+ */
+int publish_spool_peek(uint8_t *buf, uint16_t size, uint8_t *format);
+
+/**
+ * \brief Marks the oldest pending payload as sent
+ */
+void publish_spool_consume(void);
+
+/**
+ * \brief Returns the number of payloads waiting in the spool
+ */
+uint16_t publish_spool_pending(void);
+
+/**
+ * \brief Returns the number of payloads dropped because the spool was full
+ */
+uint16_t publish_spool_dropped(void);
+/*---------------------------------------------------------------------------*/
+#endif /* PUBLISH_SPOOL_H_ */
+/*---------------------------------------------------------------------------*/
+/**
+ * @}
+ */
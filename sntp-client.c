@@ -0,0 +1,312 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \addtogroup cc26xx-web-demo
+ * @{
+ *
+ * \file
+ *   A minimal SNTP client. Only the server's receive and transmit
+ *   timestamps are used, together with our own rtimer send and receive
+ *   times.
+ */
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+#include "contiki-net.h"
+#include "net/rpl/rpl.h"
+#include "net/ip/uip.h"
+#include "sntp-client.h"
+
+#include <string.h>
+#include <stdio.h>
+/*---------------------------------------------------------------------------*/
+#define DEBUG 0
+#if DEBUG
+#define PRINTF(...) printf(__VA_ARGS__)
+#else
+#define PRINTF(...)
+#endif
+/*---------------------------------------------------------------------------*/
+#define NTP_PACKET_LEN        48
+#define NTP_VERSION            4
+#define NTP_MODE_CLIENT        3
+#define NTP_MODE_SERVER        4
+
+/* Field offsets */
+#define NTP_STRATUM            1
+#define NTP_ORIGINATE         24
+#define NTP_RECEIVE           32
+#define NTP_TRANSMIT          40
+
+/* Seconds from 1900, the NTP epoch, to 1970 */
+#define NTP_UNIX_OFFSET       2208988800UL
+
+/* Replies that took longer than this say too little about the time */
+#define MAX_RTT_US            1000000L
+
+/* Clamp the drift estimate to what a 32 kHz crystal could plausibly do */
+#define MAX_DRIFT_PPB         500000L
+
+/* Polls closer together than this don't give a usable drift estimate */
+#define MIN_DRIFT_SPAN_US     (60 * 1000000LL)
+/*---------------------------------------------------------------------------*/
+static struct uip_udp_conn *client_conn = NULL;
+static struct etimer poll_timer;
+static uip_ip6addr_t server_addr;
+
+static uint8_t synced;
+static uint32_t anchor_rt;     /* An rtimer time ... */
+static uint64_t anchor_us;     /* ... and UTC at that time, us since 1970 */
+static int64_t since_sync_us;  /* Local time elapsed since the last reply */
+static int32_t drift_ppb;
+
+static uint32_t request_rt;    /* When the outstanding request went out */
+static uint8_t request_pending;
+/*---------------------------------------------------------------------------*/
+PROCESS(sntp_client_process, "SNTP Client Process");
+/*---------------------------------------------------------------------------*/
+static uint32_t
+get32(const uint8_t *p)
+{
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+    ((uint32_t)p[2] << 8) | p[3];
+}
+/*---------------------------------------------------------------------------*/
+static void
+put32(uint8_t *p, uint32_t v)
+{
+  p[0] = v >> 24;
+  p[1] = v >> 16;
+  p[2] = v >> 8;
+  p[3] = v;
+}
+/*---------------------------------------------------------------------------*/
+/* An NTP timestamp in us since 1970. Also right after the 2036 NTP rollover */
+static uint64_t
+ntp_to_us(const uint8_t *p)
+{
+  uint32_t secs = get32(p) - NTP_UNIX_OFFSET;
+
+  return (uint64_t)secs * 1000000 + (((uint64_t)get32(p + 4) * 1000000) >> 32);
+}
+/*---------------------------------------------------------------------------*/
+/* Signed, so that timestamps from before the anchor work too */
+static int64_t
+rtimer_us(uint32_t from, uint32_t to)
+{
+  return (int64_t)(int32_t)(to - from) * 1000000 / RTIMER_SECOND;
+}
+/*---------------------------------------------------------------------------*/
+static uint64_t
+utc_us(uint32_t timestamp)
+{
+  int64_t elapsed = rtimer_us(anchor_rt, timestamp);
+
+  return anchor_us + elapsed + elapsed * drift_ppb / 1000000000;
+}
+/*---------------------------------------------------------------------------*/
+/* Moves the anchor to now, so that the rtimer difference never gets large */
+static void
+reanchor(uint32_t now)
+{
+  anchor_us = utc_us(now);
+  since_sync_us += rtimer_us(anchor_rt, now);
+  anchor_rt = now;
+}
+/*---------------------------------------------------------------------------*/
+/* Returns 1 if we know where to send requests */
+static int
+set_server_addr(void)
+{
+#ifdef SNTP_CLIENT_SERVER_ADDR
+  return uiplib_ipaddrconv(SNTP_CLIENT_SERVER_ADDR, &server_addr);
+#else
+  uip_ds6_addr_t *addr_desc = uip_ds6_get_global(ADDR_PREFERRED);
+  rpl_dag_t *dag = rpl_get_any_dag();
+
+  if(addr_desc == NULL || dag == NULL) {
+    /* Not joined yet */
+    return 0;
+  }
+
+  /* Our prefix with the interface ID of the DAG root */
+  uip_ipaddr_copy(&server_addr, &addr_desc->ipaddr);
+  memcpy(&server_addr.u8[8], &dag->dag_id.u8[8], sizeof(uip_ipaddr_t) / 2);
+  return 1;
+#endif
+}
+/*---------------------------------------------------------------------------*/
+static void
+send_request(void)
+{
+  uint8_t buf[NTP_PACKET_LEN];
+
+  if(!set_server_addr()) {
+    PRINTF("SNTP: No server\n");
+    return;
+  }
+
+  if(client_conn != NULL &&
+     memcmp(&client_conn->ripaddr, &server_addr, sizeof(uip_ipaddr_t)) != 0) {
+    /* The border router changed */
+    uip_udp_remove(client_conn);
+    client_conn = NULL;
+  }
+
+  if(client_conn == NULL) {
+    client_conn = udp_new(&server_addr, UIP_HTONS(SNTP_CLIENT_PORT), NULL);
+    if(client_conn == NULL) {
+      PRINTF("SNTP: Could not open connection\n");
+      return;
+    }
+  }
+
+  /*
+   * The server echoes our transmit timestamp back as the originate one.
+   * Put our rtimer in there, to match the reply to this request
+   */
+  memset(buf, 0, sizeof(buf));
+  buf[0] = (NTP_VERSION << 3) | NTP_MODE_CLIENT;
+  request_rt = RTIMER_NOW();
+  put32(&buf[NTP_TRANSMIT + 4], request_rt);
+  request_pending = 1;
+
+  uip_udp_packet_send(client_conn, buf, sizeof(buf));
+}
+/*---------------------------------------------------------------------------*/
+static void
+tcpip_handler(void)
+{
+  const uint8_t *p = uip_appdata;
+  uint32_t now = RTIMER_NOW();
+  uint64_t server_rx;
+  uint64_t server_tx;
+  uint64_t server_now;
+  int64_t rtt;
+  int64_t error;
+
+  if(!uip_newdata() || uip_datalen() < NTP_PACKET_LEN || !request_pending) {
+    return;
+  }
+
+  if((p[0] & 0x07) != NTP_MODE_SERVER || p[NTP_STRATUM] == 0 ||
+     (p[0] >> 6) == 3 || get32(&p[NTP_ORIGINATE + 4]) != request_rt) {
+    /* Not a reply to us, kiss-o'-death, or unsynchronized server */
+    return;
+  }
+  request_pending = 0;
+
+  server_rx = ntp_to_us(&p[NTP_RECEIVE]);
+  server_tx = ntp_to_us(&p[NTP_TRANSMIT]);
+
+  /* Time on the wire, without the time the server held on to the request */
+  rtt = rtimer_us(request_rt, now) - (int64_t)(server_tx - server_rx);
+  if(rtt < 0) {
+    rtt = 0;
+  } else if(rtt > MAX_RTT_US) {
+    PRINTF("SNTP: Reply took too long\n");
+    return;
+  }
+  server_now = server_tx + rtt / 2;
+
+  if(!synced) {
+    synced = 1;
+    drift_ppb = 0;
+  } else {
+    /* How far we got off since the last reply tells the drift */
+    reanchor(now);
+    error = (int64_t)(server_now - anchor_us);
+    if(since_sync_us >= MIN_DRIFT_SPAN_US) {
+      drift_ppb += (int32_t)(error * 1000000000 / since_sync_us / 2);
+      if(drift_ppb > MAX_DRIFT_PPB) {
+        drift_ppb = MAX_DRIFT_PPB;
+      } else if(drift_ppb < -MAX_DRIFT_PPB) {
+        drift_ppb = -MAX_DRIFT_PPB;
+      }
+    }
+    PRINTF("SNTP: Off by %ld us, drift %ld ppb\n", (long)error,
+           (long)drift_ppb);
+  }
+
+  anchor_rt = now;
+  anchor_us = server_now;
+  since_sync_us = 0;
+}
+/*---------------------------------------------------------------------------*/
+int
+sntp_client_synced(void)
+{
+  return synced;
+}
+/*---------------------------------------------------------------------------*/
+uint64_t
+sntp_client_utc_ms(uint32_t timestamp)
+{
+  if(!synced) {
+    return 0;
+  }
+
+  return utc_us(timestamp) / 1000;
+}
+/*---------------------------------------------------------------------------*/
+int32_t
+sntp_client_drift(void)
+{
+  return drift_ppb;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(sntp_client_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("SNTP Client Process\n");
+
+  memset(&server_addr, 0, sizeof(uip_ipaddr_t));
+
+  etimer_set(&poll_timer, SNTP_CLIENT_RETRY_INTERVAL);
+  while(1) {
+    PROCESS_YIELD();
+    if(ev == PROCESS_EVENT_TIMER && data == &poll_timer) {
+      if(synced) {
+        reanchor(RTIMER_NOW());
+      }
+      send_request();
+      etimer_set(&poll_timer, synced ? SNTP_CLIENT_INTERVAL :
+                 SNTP_CLIENT_RETRY_INTERVAL);
+    } else if(ev == tcpip_event) {
+      tcpip_handler();
+    }
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+/**
+ * @}
+ */
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \addtogroup cc26xx-web-demo
+ * @{
+ *
+ * \file
+ *   Header file for the SNTP client of the CC26XX web demo.
+ *
+ *   Keeps the rtimer in step with UTC so that motion windows and door events
+ *   from different nodes can be lined up. The client polls an SNTP server
+ *   (RFC 4330), by default the RPL border router, and keeps an offset and a
+ *   drift estimate between polls. Frame timestamps are rtimer values, so
+ *   they convert to UTC directly.
+ */
+/*---------------------------------------------------------------------------*/
+#ifndef SNTP_CLIENT_H_
+#define SNTP_CLIENT_H_
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+
+#include <stdint.h>
+/*---------------------------------------------------------------------------*/
+/*
+ * The server to poll. Without one, the client asks the root of the RPL DAG,
+ * which is usually the border router
+ */
+#ifdef SNTP_CLIENT_CONF_SERVER_ADDR
+#define SNTP_CLIENT_SERVER_ADDR SNTP_CLIENT_CONF_SERVER_ADDR
+#endif
+
+#ifdef SNTP_CLIENT_CONF_PORT
+#define SNTP_CLIENT_PORT SNTP_CLIENT_CONF_PORT
+#else
+#define SNTP_CLIENT_PORT                123
+#endif
+
+/* Time between polls once in sync. Must stay well below an rtimer wrap */
+#ifdef SNTP_CLIENT_CONF_INTERVAL
+#define SNTP_CLIENT_INTERVAL SNTP_CLIENT_CONF_INTERVAL
+#else
+#define SNTP_CLIENT_INTERVAL            (CLOCK_SECOND * 600)
+#endif
+
+/* Time between polls until the first reply */
+#ifdef SNTP_CLIENT_CONF_RETRY_INTERVAL
+#define SNTP_CLIENT_RETRY_INTERVAL SNTP_CLIENT_CONF_RETRY_INTERVAL
+#else
+#define SNTP_CLIENT_RETRY_INTERVAL      (CLOCK_SECOND * 16)
+#endif
+/*---------------------------------------------------------------------------*/
+PROCESS_NAME(sntp_client_process);
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief Returns whether the client has heard from the server yet
+ */
+int sntp_client_synced(void);
+
+/**
+ * \brief Converts an rtimer timestamp to UTC
+ * \param timestamp An RTIMER_NOW() value, e.g. a motion frame timestamp,
+ *        taken within a few hours of now
+ * \return Milliseconds since the Unix epoch, or 0 if not in sync
+ */
+uint64_t sntp_client_utc_ms(uint32_t timestamp);
+
+/**
+ * \brief Returns how much faster UTC runs than the rtimer
+ * \return The drift estimate in parts per billion
+ */
+int32_t sntp_client_drift(void);
+/*---------------------------------------------------------------------------*/
+#endif /* SNTP_CLIENT_H_ */
+/*---------------------------------------------------------------------------*/
+/**
+ * @}
+ */
@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file
+ *   Compression benchmark of delta-codec.c over recorded traces.
+ *
+ *   Each trace is cut into windows of a batch size. For every window, the
+ *   six axes are encoded the way the 'CBOR' format does (arrays of integers)
+ *   and the way 'CBOR + delta' does (one byte string per axis), and the
+ *   delta axes are decoded again to check the round trip.
+ *
+ *   Usage: bench-delta [-n frames] trace.csv...
+ *
+ *   Traces are CSV files with a header line and one sample per line:
+ *   acc_x,acc_y,acc_z,gyro_x,gyro_y,gyro_z in the MPU driver's units, i.e.
+ *   hundredths of a G and hundredths of a deg/sec
+ */
+/*---------------------------------------------------------------------------*/
+#include "cbor-writer.h"
+#include "delta-codec.h"
+#include "delta-decoder.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+#define AXES              6
+#define TRACE_MAX      4096
+#define WINDOW_MAX       64
+#define BUF_SIZE       2048
+/*---------------------------------------------------------------------------*/
+static int16_t trace[TRACE_MAX][AXES];
+/*---------------------------------------------------------------------------*/
+static int
+load(const char *path)
+{
+  FILE *f = fopen(path, "r");
+  char line[128];
+  int n = 0;
+  int v[AXES];
+  int axis;
+
+  if(f == NULL) {
+    perror(path);
+    return -1;
+  }
+
+  while(fgets(line, sizeof(line), f) != NULL && n < TRACE_MAX) {
+    if(sscanf(line, "%d,%d,%d,%d,%d,%d", &v[0], &v[1], &v[2], &v[3], &v[4],
+              &v[5]) != AXES) {
+      /* The header */
+      continue;
+    }
+    for(axis = 0; axis < AXES; axis++) {
+      trace[n][axis] = (int16_t)v[axis];
+    }
+    n++;
+  }
+
+  fclose(f);
+  return n;
+}
+/*---------------------------------------------------------------------------*/
+/* CBOR bytes of the axes of one window, as integer arrays */
+static int
+plain_len(int first, int frames)
+{
+  static uint8_t buf[BUF_SIZE];
+  cbor_writer_t w;
+  int axis;
+  int i;
+
+  cbor_writer_init(&w, buf, sizeof(buf));
+  for(axis = 0; axis < AXES; axis++) {
+    cbor_writer_array(&w, frames);
+    for(i = 0; i < frames; i++) {
+      cbor_writer_int(&w, trace[first + i][axis]);
+    }
+  }
+
+  return cbor_writer_len(&w);
+}
+/*---------------------------------------------------------------------------*/
+/* CBOR bytes of the axes of one window, as delta byte strings */
+static int
+delta_len(int first, int frames)
+{
+  static uint8_t buf[BUF_SIZE];
+  static uint8_t axis_buf[WINDOW_MAX * DELTA_CODEC_MAX_BYTES_PER_VALUE];
+  int16_t out[WINDOW_MAX];
+  cbor_writer_t w;
+  delta_codec_t c;
+  int axis;
+  int i;
+
+  cbor_writer_init(&w, buf, sizeof(buf));
+  for(axis = 0; axis < AXES; axis++) {
+    delta_codec_init(&c, axis_buf, sizeof(axis_buf));
+    for(i = 0; i < frames; i++) {
+      delta_codec_put(&c, trace[first + i][axis]);
+    }
+
+    if(delta_decode(axis_buf, delta_codec_len(&c), out, WINDOW_MAX) !=
+       frames) {
+      return -1;
+    }
+    for(i = 0; i < frames; i++) {
+      if(out[i] != trace[first + i][axis]) {
+        return -1;
+      }
+    }
+
+    cbor_writer_bytes(&w, axis_buf, delta_codec_len(&c));
+  }
+
+  return cbor_writer_len(&w);
+}
+/*---------------------------------------------------------------------------*/
+int
+main(int argc, char **argv)
+{
+  long total_plain = 0;
+  long total_delta = 0;
+  int frames = 15;
+  int arg = 1;
+  int samples;
+  int first;
+  int plain, delta;
+  long trace_plain, trace_delta;
+
+  if(argc > 2 && strcmp(argv[1], "-n") == 0) {
+    frames = atoi(argv[2]);
+    arg = 3;
+  }
+
+  if(frames < 1 || frames > WINDOW_MAX || arg >= argc) {
+    fprintf(stderr, "Usage: %s [-n 1-%u] trace.csv...\n", argv[0],
+            WINDOW_MAX);
+    return 2;
+  }
+
+  printf("%u frames per window, axes only\n", frames);
+  printf("%-28s %7s %9s %9s %6s\n", "trace", "windows", "CBOR", "delta",
+         "saved");
+
+  for(; arg < argc; arg++) {
+    samples = load(argv[arg]);
+    if(samples < 0) {
+      return 2;
+    }
+
+    trace_plain = 0;
+    trace_delta = 0;
+    for(first = 0; first + frames <= samples; first += frames) {
+      plain = plain_len(first, frames);
+      delta = delta_len(first, frames);
+      if(plain < 0 || delta < 0) {
+        printf("%s: window at %d failed to encode or round-trip\n",
+               argv[arg], first);
+        return 1;
+      }
+      trace_plain += plain;
+      trace_delta += delta;
+    }
+
+    printf("%-28s %7u %9ld %9ld %5ld%%\n", strrchr(argv[arg], '/') ?
+           strrchr(argv[arg], '/') + 1 : argv[arg], samples / frames,
+           trace_plain, trace_delta, trace_plain ?
+           (trace_plain - trace_delta) * 100 / trace_plain : 0);
+    total_plain += trace_plain;
+    total_delta += trace_delta;
+  }
+
+  printf("%-28s %7s %9ld %9ld %5ld%%\n", "total", "", total_plain,
+         total_delta, total_plain ?
+         (total_plain - total_delta) * 100 / total_plain : 0);
+
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
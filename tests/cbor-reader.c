@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file
+ *   A minimal CBOR reader for the host tests
+ */
+/*---------------------------------------------------------------------------*/
+#include "cbor-reader.h"
+
+#include <stddef.h>
+#include <stdint.h>
+/*---------------------------------------------------------------------------*/
+void
+cbor_reader_init(cbor_reader_t *r, const uint8_t *buf, uint16_t len)
+{
+  r->buf = buf;
+  r->len = len;
+  r->pos = 0;
+  r->error = 0;
+}
+/*---------------------------------------------------------------------------*/
+int
+cbor_reader_next(cbor_reader_t *r, cbor_item_t *item)
+{
+  uint8_t info;
+  int bytes;
+
+  if(r->error || r->pos >= r->len) {
+    return 0;
+  }
+
+  item->major = r->buf[r->pos] >> 5;
+  info = r->buf[r->pos++] & 0x1F;
+  item->data = NULL;
+
+  if(info < 24) {
+    item->arg = info;
+  } else if(info <= 27) {
+    bytes = 1 << (info - 24);
+    if(r->len - r->pos < bytes) {
+      r->error = 1;
+      return 0;
+    }
+    for(item->arg = 0; bytes > 0; bytes--) {
+      item->arg = (item->arg << 8) | r->buf[r->pos++];
+    }
+  } else {
+    /* Indefinite lengths, floats and simple values are never written */
+    r->error = 1;
+    return 0;
+  }
+
+  if(item->major > CBOR_READER_MAP) {
+    r->error = 1;
+    return 0;
+  }
+
+  if(item->major == CBOR_READER_BYTES || item->major == CBOR_READER_TEXT) {
+    if(item->arg > (uint64_t)(r->len - r->pos)) {
+      r->error = 1;
+      return 0;
+    }
+    item->data = &r->buf[r->pos];
+    r->pos += item->arg;
+  }
+
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+int
+cbor_reader_expect(cbor_reader_t *r, uint8_t major, cbor_item_t *item)
+{
+  if(!cbor_reader_next(r, item) || item->major != major) {
+    r->error = 1;
+    return 0;
+  }
+
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+int
+cbor_reader_int(cbor_reader_t *r, int64_t *value)
+{
+  cbor_item_t item;
+
+  if(!cbor_reader_next(r, &item) || item.arg > INT64_MAX ||
+     (item.major != CBOR_READER_UINT && item.major != CBOR_READER_NINT)) {
+    r->error = 1;
+    return 0;
+  }
+
+  *value = item.major == CBOR_READER_UINT ? (int64_t)item.arg :
+    -1 - (int64_t)item.arg;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+int
+cbor_reader_done(const cbor_reader_t *r)
+{
+  return !r->error && r->pos == r->len;
+}
+/*---------------------------------------------------------------------------*/
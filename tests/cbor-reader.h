@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file
+ *   A minimal CBOR reader for the host tests. Covers what cbor-writer.c
+ *   produces: integers, byte and text strings, definite-length arrays and
+ *   maps
+ */
+/*---------------------------------------------------------------------------*/
+#ifndef CBOR_READER_H_
+#define CBOR_READER_H_
+/*---------------------------------------------------------------------------*/
+#include <stdint.h>
+/*---------------------------------------------------------------------------*/
+#define CBOR_READER_UINT    0
+#define CBOR_READER_NINT    1
+#define CBOR_READER_BYTES   2
+#define CBOR_READER_TEXT    3
+#define CBOR_READER_ARRAY   4
+#define CBOR_READER_MAP     5
+/*---------------------------------------------------------------------------*/
+typedef struct cbor_reader {
+  const uint8_t *buf;
+  uint16_t len;
+  uint16_t pos;
+  uint8_t error;
+} cbor_reader_t;
+
+typedef struct cbor_item {
+  uint8_t major;       /* CBOR_READER_xyz */
+  uint64_t arg;        /* Value, string length or element count */
+  const uint8_t *data; /* String contents */
+} cbor_item_t;
+/*---------------------------------------------------------------------------*/
+void cbor_reader_init(cbor_reader_t *r, const uint8_t *buf, uint16_t len);
+
+/**
+ * \brief Reads the next item header, and the contents of strings
+ * \return 1 on success, 0 at the end of the input or on malformed input
+ */
+int cbor_reader_next(cbor_reader_t *r, cbor_item_t *item);
+
+/**
+ * \brief Reads the next item, which must be of the given major type
+ * \return 1 on success. On a mismatch, 0 and the error flag is latched
+ */
+int cbor_reader_expect(cbor_reader_t *r, uint8_t major, cbor_item_t *item);
+
+/**
+ * \brief Reads the next item as a signed integer of either major type
+ * \return 1 on success, 0 if the item is not an integer or does not fit
+ */
+int cbor_reader_int(cbor_reader_t *r, int64_t *value);
+
+/** \brief Whether all input has been consumed without errors */
+int cbor_reader_done(const cbor_reader_t *r);
+/*---------------------------------------------------------------------------*/
+#endif /* CBOR_READER_H_ */
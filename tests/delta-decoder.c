@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file
+ *   Decoder for the delta + zigzag varint axes of delta-codec.c
+ */
+/*---------------------------------------------------------------------------*/
+#include "delta-decoder.h"
+#include "delta-codec.h"
+
+#include <stdint.h>
+/*---------------------------------------------------------------------------*/
+int
+delta_decode(const uint8_t *buf, uint16_t len, int16_t *values,
+             uint16_t max)
+{
+  int32_t prev = 0;
+  int32_t delta;
+  uint32_t zz;
+  uint16_t pos = 0;
+  int count = 0;
+  int shift;
+
+  while(pos < len) {
+    zz = 0;
+    for(shift = 0; ; shift += 7) {
+      if(pos >= len || shift >= 7 * DELTA_CODEC_MAX_BYTES_PER_VALUE) {
+        return -1;
+      }
+      zz |= (uint32_t)(buf[pos] & 0x7F) << shift;
+      if(!(buf[pos++] & 0x80)) {
+        break;
+      }
+    }
+
+    delta = (int32_t)(zz >> 1) ^ -(int32_t)(zz & 1);
+    prev += delta;
+    if(prev < INT16_MIN || prev > INT16_MAX || count >= max) {
+      return -1;
+    }
+    values[count++] = (int16_t)prev;
+  }
+
+  return count;
+}
+/*---------------------------------------------------------------------------*/
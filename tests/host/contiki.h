@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file
+ *   The parts of Contiki's API that the modules under test use, for host
+ *   builds. host-contiki.c implements processes, event timers and UDP on
+ *   top of the host's clock and sockets
+ */
+/*---------------------------------------------------------------------------*/
+#ifndef CONTIKI_H_
+#define CONTIKI_H_
+/*---------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stddef.h>
+/*---------------------------------------------------------------------------*/
+typedef uint32_t clock_time_t;
+#define CLOCK_SECOND 128
+
+clock_time_t clock_time(void);
+unsigned long clock_seconds(void);
+/*---------------------------------------------------------------------------*/
+typedef uint32_t rtimer_clock_t;
+#define RTIMER_SECOND 65536UL
+
+rtimer_clock_t host_rtimer_now(void);
+#define RTIMER_NOW() host_rtimer_now()
+/*---------------------------------------------------------------------------*/
+/* Protothreads, as in Contiki's lc-switch.h */
+struct pt {
+  unsigned short lc;
+};
+
+#define PT_WAITING 0
+#define PT_YIELDED 1
+#define PT_EXITED  2
+#define PT_ENDED   3
+
+#define PT_INIT(pt) (pt)->lc = 0
+#define PT_BEGIN(pt) { char PT_YIELD_FLAG = 1; (void)PT_YIELD_FLAG; \
+    switch((pt)->lc) { case 0:
+#define PT_END(pt) } PT_YIELD_FLAG = 0; PT_INIT(pt); return PT_ENDED; }
+#define PT_YIELD(pt) do { PT_YIELD_FLAG = 0; (pt)->lc = __LINE__; \
+    case __LINE__: if(PT_YIELD_FLAG == 0) { return PT_YIELDED; } } while(0)
+#define PT_YIELD_UNTIL(pt, c) do { PT_YIELD_FLAG = 0; (pt)->lc = __LINE__; \
+    case __LINE__: if(PT_YIELD_FLAG == 0 || !(c)) { return PT_YIELDED; } \
+  } while(0)
+/*---------------------------------------------------------------------------*/
+typedef unsigned char process_event_t;
+typedef void *process_data_t;
+
+struct process {
+  struct process *next;
+  const char *name;
+  char (*thread)(struct pt *, process_event_t, process_data_t);
+  struct pt pt;
+  unsigned char running;
+  unsigned char needspoll;
+};
+
+#define PROCESS_EVENT_NONE        0x80
+#define PROCESS_EVENT_INIT        0x81
+#define PROCESS_EVENT_POLL        0x82
+#define PROCESS_EVENT_EXIT        0x83
+#define PROCESS_EVENT_TIMER       0x88
+#define PROCESS_EVENT_MAX         0x8a
+
+#define PROCESS_BROADCAST         NULL
+
+#define PROCESS_THREAD(name, ev, data) \
+  static char process_thread_##name(struct pt *process_pt, \
+                                    process_event_t ev, process_data_t data)
+#define PROCESS_NAME(name) extern struct process name
+#define PROCESS(name, strname) \
+  PROCESS_THREAD(name, ev, data); \
+  struct process name = { NULL, strname, process_thread_##name }
+
+#define PROCESS_BEGIN()             PT_BEGIN(process_pt)
+#define PROCESS_END()               PT_END(process_pt)
+#define PROCESS_YIELD()             PT_YIELD(process_pt)
+#define PROCESS_WAIT_EVENT()        PROCESS_YIELD()
+#define PROCESS_WAIT_EVENT_UNTIL(c) PT_YIELD_UNTIL(process_pt, c)
+
+#define PROCESS_CONTEXT_BEGIN(p) { \
+    struct process *tmp_current = process_current; \
+    process_current = (p)
+#define PROCESS_CONTEXT_END(p) process_current = tmp_current; }
+
+extern struct process *process_current;
+#define PROCESS_CURRENT() process_current
+
+void process_start(struct process *p, process_data_t data);
+int process_post(struct process *p, process_event_t ev, process_data_t data);
+void process_poll(struct process *p);
+int process_is_running(struct process *p);
+process_event_t process_alloc_event(void);
+/*---------------------------------------------------------------------------*/
+struct etimer {
+  struct etimer *next;
+  clock_time_t start;
+  clock_time_t interval;
+  struct process *p;
+};
+
+void etimer_set(struct etimer *et, clock_time_t interval);
+void etimer_stop(struct etimer *et);
+int etimer_expired(struct etimer *et);
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief Runs processes, timers and sockets
+ * \param ms How long to run for at most
+ * \param done Stops the loop early once it returns non-zero. May be NULL
+ * \return The value of done(), or 0 on a timeout
+ */
+int host_contiki_run(unsigned long ms, int (*done)(void));
+/*---------------------------------------------------------------------------*/
+#endif /* CONTIKI_H_ */
@@ -0,0 +1,392 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file
+ *   A single-threaded stand-in for Contiki's kernel on the host: processes,
+ *   an event queue, event timers and UDP over IPv6 sockets
+ */
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+#include "net/ip/uip.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+/*---------------------------------------------------------------------------*/
+#define EVENT_QUEUE_SIZE    32
+#define CONNS_MAX            4
+#define UIP_BUFSIZE       1280
+/*---------------------------------------------------------------------------*/
+struct process *process_current;
+process_event_t tcpip_event = PROCESS_EVENT_MAX;
+
+void *uip_appdata;
+uint16_t uip_len;
+
+static struct process *processes;
+static process_event_t last_event = PROCESS_EVENT_MAX + 1;
+
+static struct {
+  struct process *p;
+  process_event_t ev;
+  process_data_t data;
+} queue[EVENT_QUEUE_SIZE];
+static int queue_head;
+static int queue_count;
+
+static struct etimer *timers;
+
+static struct uip_udp_conn conns[CONNS_MAX];
+static uint8_t uip_buf[UIP_BUFSIZE];
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_us(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+/*---------------------------------------------------------------------------*/
+clock_time_t
+clock_time(void)
+{
+  return (clock_time_t)(now_us() * CLOCK_SECOND / 1000000);
+}
+/*---------------------------------------------------------------------------*/
+unsigned long
+clock_seconds(void)
+{
+  return (unsigned long)(now_us() / 1000000);
+}
+/*---------------------------------------------------------------------------*/
+rtimer_clock_t
+host_rtimer_now(void)
+{
+  return (rtimer_clock_t)(now_us() * RTIMER_SECOND / 1000000);
+}
+/*---------------------------------------------------------------------------*/
+static void
+call_process(struct process *p, process_event_t ev, process_data_t data)
+{
+  struct process *caller = process_current;
+  char ret;
+
+  if(!p->running) {
+    return;
+  }
+
+  process_current = p;
+  ret = p->thread(&p->pt, ev, data);
+  process_current = caller;
+
+  if(ret == PT_EXITED || ret == PT_ENDED) {
+    p->running = 0;
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+process_start(struct process *p, process_data_t data)
+{
+  struct process *q;
+
+  for(q = processes; q != NULL && q != p; q = q->next);
+  if(q == NULL) {
+    p->next = processes;
+    processes = p;
+  }
+
+  PT_INIT(&p->pt);
+  p->running = 1;
+  p->needspoll = 0;
+  call_process(p, PROCESS_EVENT_INIT, data);
+}
+/*---------------------------------------------------------------------------*/
+int
+process_post(struct process *p, process_event_t ev, process_data_t data)
+{
+  int i;
+
+  if(queue_count == EVENT_QUEUE_SIZE) {
+    return 1;
+  }
+
+  i = (queue_head + queue_count++) % EVENT_QUEUE_SIZE;
+  queue[i].p = p;
+  queue[i].ev = ev;
+  queue[i].data = data;
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+void
+process_poll(struct process *p)
+{
+  if(p != NULL) {
+    p->needspoll = 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+int
+process_is_running(struct process *p)
+{
+  return p->running;
+}
+/*---------------------------------------------------------------------------*/
+process_event_t
+process_alloc_event(void)
+{
+  return last_event++;
+}
+/*---------------------------------------------------------------------------*/
+/* Delivers polls and one queued event. Returns whether there was any */
+static int
+run_processes(void)
+{
+  struct process *p;
+  int ran = 0;
+  int i;
+
+  for(p = processes; p != NULL; p = p->next) {
+    if(p->needspoll) {
+      p->needspoll = 0;
+      call_process(p, PROCESS_EVENT_POLL, NULL);
+      ran = 1;
+    }
+  }
+
+  if(queue_count > 0) {
+    i = queue_head;
+    queue_head = (queue_head + 1) % EVENT_QUEUE_SIZE;
+    queue_count--;
+
+    if(queue[i].p == PROCESS_BROADCAST) {
+      for(p = processes; p != NULL; p = p->next) {
+        call_process(p, queue[i].ev, queue[i].data);
+      }
+    } else {
+      call_process(queue[i].p, queue[i].ev, queue[i].data);
+    }
+    ran = 1;
+  }
+
+  return ran;
+}
+/*---------------------------------------------------------------------------*/
+void
+etimer_set(struct etimer *et, clock_time_t interval)
+{
+  etimer_stop(et);
+  et->start = clock_time();
+  et->interval = interval;
+  et->p = process_current;
+  et->next = timers;
+  timers = et;
+}
+/*---------------------------------------------------------------------------*/
+void
+etimer_stop(struct etimer *et)
+{
+  struct etimer **t;
+
+  for(t = &timers; *t != NULL; t = &(*t)->next) {
+    if(*t == et) {
+      *t = et->next;
+      break;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+int
+etimer_expired(struct etimer *et)
+{
+  struct etimer *t;
+
+  for(t = timers; t != NULL && t != et; t = t->next);
+  return t == NULL;
+}
+/*---------------------------------------------------------------------------*/
+/* Fires expired timers. Returns the ms until the next one, at most max */
+static unsigned long
+run_timers(unsigned long max)
+{
+  clock_time_t now = clock_time();
+  clock_time_t left;
+  struct etimer *t;
+  unsigned long ms = max;
+
+  for(t = timers; t != NULL; ) {
+    if((clock_time_t)(now - t->start) >= t->interval) {
+      struct etimer *expired = t;
+
+      t = t->next;
+      etimer_stop(expired);
+      process_post(expired->p, PROCESS_EVENT_TIMER, expired);
+      ms = 0;
+      continue;
+    }
+
+    left = t->interval - (now - t->start);
+    if(left * 1000 / CLOCK_SECOND < ms) {
+      ms = left * 1000 / CLOCK_SECOND;
+    }
+    t = t->next;
+  }
+
+  return ms;
+}
+/*---------------------------------------------------------------------------*/
+struct uip_udp_conn *
+udp_new(const uip_ipaddr_t *ripaddr, uint16_t rport, void *appstate)
+{
+  struct sockaddr_in6 sa;
+  int i;
+
+  for(i = 0; i < CONNS_MAX && conns[i].p != NULL; i++);
+  if(i == CONNS_MAX) {
+    return NULL;
+  }
+
+  conns[i].fd = socket(AF_INET6, SOCK_DGRAM, 0);
+  if(conns[i].fd < 0) {
+    perror("socket");
+    return NULL;
+  }
+
+  if(rport != 0) {
+    memset(&sa, 0, sizeof(sa));
+    sa.sin6_family = AF_INET6;
+    sa.sin6_port = rport;
+    memcpy(&sa.sin6_addr, ripaddr, sizeof(sa.sin6_addr));
+    if(connect(conns[i].fd, (struct sockaddr *)&sa, sizeof(sa)) < 0) {
+      perror("connect");
+      close(conns[i].fd);
+      return NULL;
+    }
+  }
+
+  memcpy(&conns[i].ripaddr, ripaddr, sizeof(conns[i].ripaddr));
+  conns[i].rport = rport;
+  conns[i].p = process_current;
+  return &conns[i];
+}
+/*---------------------------------------------------------------------------*/
+void
+uip_udp_remove(struct uip_udp_conn *conn)
+{
+  if(conn != NULL && conn->p != NULL) {
+    close(conn->fd);
+    conn->p = NULL;
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+uip_udp_packet_send(struct uip_udp_conn *conn, const void *data, int len)
+{
+  /* Like uIP, fire and forget. Refusals show up on the next receive */
+  if(send(conn->fd, data, len, 0) < 0 && errno != ECONNREFUSED) {
+    perror("send");
+  }
+}
+/*---------------------------------------------------------------------------*/
+int
+uiplib_ipaddrconv(const char *addrstr, uip_ipaddr_t *addr)
+{
+  return inet_pton(AF_INET6, addrstr, addr) == 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Waits up to ms for datagrams and delivers them as tcpip_event */
+static void
+run_sockets(unsigned long ms)
+{
+  struct timeval tv;
+  fd_set fds;
+  ssize_t len;
+  int max = -1;
+  int i;
+
+  FD_ZERO(&fds);
+  for(i = 0; i < CONNS_MAX; i++) {
+    if(conns[i].p != NULL) {
+      FD_SET(conns[i].fd, &fds);
+      max = conns[i].fd > max ? conns[i].fd : max;
+    }
+  }
+
+  tv.tv_sec = ms / 1000;
+  tv.tv_usec = (ms % 1000) * 1000;
+  if(select(max + 1, &fds, NULL, NULL, &tv) <= 0) {
+    return;
+  }
+
+  for(i = 0; i < CONNS_MAX; i++) {
+    if(conns[i].p == NULL || !FD_ISSET(conns[i].fd, &fds)) {
+      continue;
+    }
+
+    len = recv(conns[i].fd, uip_buf, sizeof(uip_buf), 0);
+    if(len <= 0) {
+      continue;
+    }
+
+    /* Like tcpip.c, synchronously, so uip_appdata stays valid */
+    uip_appdata = uip_buf;
+    uip_len = len;
+    call_process(conns[i].p, tcpip_event, &conns[i]);
+    uip_len = 0;
+  }
+}
+/*---------------------------------------------------------------------------*/
+int
+host_contiki_run(unsigned long ms, int (*done)(void))
+{
+  uint64_t end = now_us() + (uint64_t)ms * 1000;
+  uint64_t now;
+  int result;
+
+  while((now = now_us()) < end) {
+    if(done != NULL && (result = done()) != 0) {
+      return result;
+    }
+
+    if(run_processes()) {
+      continue;
+    }
+
+    run_sockets(run_timers((unsigned long)((end - now) / 1000)));
+  }
+
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
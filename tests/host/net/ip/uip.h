@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file
+ *   uIP's UDP API for host builds, on top of the host's IPv6 sockets
+ */
+/*---------------------------------------------------------------------------*/
+#ifndef UIP_H_
+#define UIP_H_
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+
+#include <stdint.h>
+#include <arpa/inet.h>
+/*---------------------------------------------------------------------------*/
+typedef union uip_ip6addr_t {
+  uint8_t u8[16];
+  uint16_t u16[8];
+} uip_ip6addr_t;
+
+typedef uip_ip6addr_t uip_ipaddr_t;
+
+struct uip_udp_conn {
+  uip_ipaddr_t ripaddr;
+  uint16_t rport; /* Network byte order */
+  int fd;
+  struct process *p;
+};
+
+#define UIP_HTONS(n) htons(n)
+
+/* The payload of the datagram that tcpip_event is being delivered for */
+extern void *uip_appdata;
+extern uint16_t uip_len;
+#define uip_datalen() uip_len
+#define uip_newdata() (uip_len > 0)
+
+extern process_event_t tcpip_event;
+/*---------------------------------------------------------------------------*/
+/**
+ * \brief Opens a UDP socket, connected to the peer if rport is not 0. Its
+ *        datagrams go to the calling process as tcpip_event
+ */
+struct uip_udp_conn *udp_new(const uip_ipaddr_t *ripaddr, uint16_t rport,
+                             void *appstate);
+void uip_udp_remove(struct uip_udp_conn *conn);
+void uip_udp_packet_send(struct uip_udp_conn *conn, const void *data,
+                         int len);
+int uiplib_ipaddrconv(const char *addrstr, uip_ipaddr_t *addr);
+/*---------------------------------------------------------------------------*/
+#endif /* UIP_H_ */
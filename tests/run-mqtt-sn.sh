@@ -0,0 +1,19 @@
+#!/bin/sh
+# Runs test-mqtt-sn against the gateway stand-in in tools/, and checks the
+# sequence of messages the gateway received. Usage: run-mqtt-sn.sh [port]
+
+port=${1:-18840}
+gw="$(dirname "$0")/../tools/mqttsn-gw.py"
+
+python3 -u "$gw" --port "$port" --reject-first --timeout 10 \
+  --expect CONNECT,REGISTER,PUBLISH,REGISTER,PUBLISH,PUBLISH-DUP,DISCONNECT &
+gw_pid=$!
+
+# The client retransmits its CONNECT until the gateway is up
+./test-mqtt-sn "$port"
+client=$?
+
+wait $gw_pid
+gateway=$?
+
+[ $client -eq 0 ] && [ $gateway -eq 0 ]
@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file
+ *   Round trip of motion publishes through cbor-writer.c and back.
+ *
+ *   Payloads are laid out like build_cbor_payload() in mqtt-client.c. Each
+ *   one is decoded again and every key and value compared with what went in
+ */
+/*---------------------------------------------------------------------------*/
+#include "cbor-writer.h"
+#include "cbor-reader.h"
+#include "unit-test.h"
+
+#include <stdint.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+/* As in mqtt-client.c */
+#define CBOR_PAYLOAD_VERSION    1
+#define CBOR_KEY_VERSION        0
+#define CBOR_KEY_NODE_ID        1
+#define CBOR_KEY_SEQ            2
+#define CBOR_KEY_ALIVE          3
+#define CBOR_KEY_START          4
+#define CBOR_KEY_PUB_INTERVAL   5
+#define CBOR_KEY_BATT_VOLT      6
+#define CBOR_KEY_TIME_DELTAS   11
+#define CBOR_KEY_UTC           12
+#define CBOR_KEY_AXIS_BASE     16
+
+#define AXES                    6
+#define FRAMES_MAX             64
+/*---------------------------------------------------------------------------*/
+typedef struct window {
+  uint8_t id[6];
+  uint32_t seq;
+  uint32_t alive;
+  uint32_t start;
+  uint32_t pub_interval;
+  int32_t batt;
+  uint64_t utc;
+  uint16_t frames;
+  uint32_t deltas[FRAMES_MAX];
+  int16_t axis[AXES][FRAMES_MAX];
+} window_t;
+/*---------------------------------------------------------------------------*/
+static int
+encode(const window_t *win, uint8_t *buf, uint16_t size)
+{
+  cbor_writer_t w;
+  uint16_t i;
+  int axis;
+
+  cbor_writer_init(&w, buf, size);
+  cbor_writer_map(&w, 9 + AXES);
+  cbor_writer_uint(&w, CBOR_KEY_VERSION);
+  cbor_writer_uint(&w, CBOR_PAYLOAD_VERSION);
+  cbor_writer_uint(&w, CBOR_KEY_NODE_ID);
+  cbor_writer_bytes(&w, win->id, sizeof(win->id));
+  cbor_writer_uint(&w, CBOR_KEY_SEQ);
+  cbor_writer_uint(&w, win->seq);
+  cbor_writer_uint(&w, CBOR_KEY_ALIVE);
+  cbor_writer_uint(&w, win->alive);
+  cbor_writer_uint(&w, CBOR_KEY_START);
+  cbor_writer_uint(&w, win->start);
+  cbor_writer_uint(&w, CBOR_KEY_PUB_INTERVAL);
+  cbor_writer_uint(&w, win->pub_interval);
+  cbor_writer_uint(&w, CBOR_KEY_BATT_VOLT);
+  cbor_writer_int(&w, win->batt);
+  cbor_writer_uint(&w, CBOR_KEY_UTC);
+  cbor_writer_uint64(&w, win->utc);
+  cbor_writer_uint(&w, CBOR_KEY_TIME_DELTAS);
+  cbor_writer_array(&w, win->frames - 1);
+  for(i = 1; i < win->frames; i++) {
+    cbor_writer_uint(&w, win->deltas[i]);
+  }
+  for(axis = 0; axis < AXES; axis++) {
+    cbor_writer_uint(&w, CBOR_KEY_AXIS_BASE + axis);
+    cbor_writer_array(&w, win->frames);
+    for(i = 0; i < win->frames; i++) {
+      cbor_writer_int(&w, win->axis[axis][i]);
+    }
+  }
+
+  return cbor_writer_len(&w);
+}
+/*---------------------------------------------------------------------------*/
+static void
+expect_uint(cbor_reader_t *r, uint64_t value)
+{
+  cbor_item_t item;
+
+  CHECK(cbor_reader_expect(r, CBOR_READER_UINT, &item));
+  CHECK_EQ(item.arg, value);
+}
+/*---------------------------------------------------------------------------*/
+static void
+expect_int(cbor_reader_t *r, int64_t value)
+{
+  int64_t v = 0;
+
+  CHECK(cbor_reader_int(r, &v));
+  CHECK_EQ(v, value);
+}
+/*---------------------------------------------------------------------------*/
+static void
+decode_and_compare(const window_t *win, const uint8_t *buf, int len)
+{
+  cbor_reader_t r;
+  cbor_item_t item;
+  uint16_t i;
+  int axis;
+
+  cbor_reader_init(&r, buf, len);
+
+  CHECK(cbor_reader_expect(&r, CBOR_READER_MAP, &item));
+  CHECK_EQ(item.arg, 9 + AXES);
+
+  expect_uint(&r, CBOR_KEY_VERSION);
+  expect_uint(&r, CBOR_PAYLOAD_VERSION);
+  expect_uint(&r, CBOR_KEY_NODE_ID);
+  CHECK(cbor_reader_expect(&r, CBOR_READER_BYTES, &item));
+  CHECK_EQ(item.arg, sizeof(win->id));
+  CHECK(item.data && memcmp(item.data, win->id, sizeof(win->id)) == 0);
+  expect_uint(&r, CBOR_KEY_SEQ);
+  expect_uint(&r, win->seq);
+  expect_uint(&r, CBOR_KEY_ALIVE);
+  expect_uint(&r, win->alive);
+  expect_uint(&r, CBOR_KEY_START);
+  expect_uint(&r, win->start);
+  expect_uint(&r, CBOR_KEY_PUB_INTERVAL);
+  expect_uint(&r, win->pub_interval);
+  expect_uint(&r, CBOR_KEY_BATT_VOLT);
+  expect_int(&r, win->batt);
+  expect_uint(&r, CBOR_KEY_UTC);
+  expect_uint(&r, win->utc);
+
+  expect_uint(&r, CBOR_KEY_TIME_DELTAS);
+  CHECK(cbor_reader_expect(&r, CBOR_READER_ARRAY, &item));
+  CHECK_EQ(item.arg, win->frames - 1);
+  for(i = 1; i < win->frames; i++) {
+    expect_uint(&r, win->deltas[i]);
+  }
+
+  for(axis = 0; axis < AXES; axis++) {
+    expect_uint(&r, CBOR_KEY_AXIS_BASE + axis);
+    CHECK(cbor_reader_expect(&r, CBOR_READER_ARRAY, &item));
+    CHECK_EQ(item.arg, win->frames);
+    for(i = 0; i < win->frames; i++) {
+      expect_int(&r, win->axis[axis][i]);
+    }
+  }
+
+  CHECK(cbor_reader_done(&r));
+}
+/*---------------------------------------------------------------------------*/
+/* Values either side of every CBOR argument width, for both signs */
+static const int32_t edges[] = {
+  0, 1, 23, 24, 255, 256, 32767, -1, -24, -25, -256, -257, -32768,
+};
+#define EDGES (sizeof(edges) / sizeof(edges[0]))
+
+static uint32_t lcg = 12345;
+
+static int16_t
+noise(void)
+{
+  lcg = lcg * 1103515245 + 12345;
+  return (int16_t)(lcg >> 16);
+}
+/*---------------------------------------------------------------------------*/
+static void
+fill(window_t *win, uint16_t frames, uint64_t utc)
+{
+  static const uint8_t id[6] = { 0x00, 0x12, 0x4b, 0x00, 0x06, 0x0d };
+  uint16_t i;
+  int axis;
+
+  memcpy(win->id, id, sizeof(id));
+  win->seq = 65536 + frames;
+  win->alive = 86400;
+  win->start = 4294967295UL;
+  win->pub_interval = 30;
+  win->batt = -3012; /* Not a real reading, but the encoding is signed */
+  win->utc = utc;
+  win->frames = frames;
+
+  for(i = 0; i < frames; i++) {
+    win->deltas[i] = i ? 10000 + (i % 3) * 1000 : 0;
+    for(axis = 0; axis < AXES; axis++) {
+      win->axis[axis][i] = axis == 0 ? edges[i % EDGES] : noise();
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+test_window(uint16_t frames, uint64_t utc)
+{
+  static window_t win;
+  static uint8_t buf[2048];
+  int len;
+
+  fill(&win, frames, utc);
+  len = encode(&win, buf, sizeof(buf));
+  CHECK(len > 0);
+  if(len > 0) {
+    decode_and_compare(&win, buf, len);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+test_uint64(void)
+{
+  static const uint8_t utc[] = {
+    0x1B, 0x00, 0x00, 0x01, 0x99, 0x9D, 0x11, 0x98, 0x7B,
+  };
+  uint8_t buf[16];
+  cbor_writer_t w;
+
+  /* 2025-10-01T00:00:00.123Z in ms takes the 8-byte form */
+  cbor_writer_init(&w, buf, sizeof(buf));
+  cbor_writer_uint64(&w, 1759276800123ULL);
+  CHECK_EQ(cbor_writer_len(&w), sizeof(utc));
+  CHECK(memcmp(buf, utc, sizeof(utc)) == 0);
+
+  /* Values that fit 32 bits take the short forms */
+  cbor_writer_init(&w, buf, sizeof(buf));
+  cbor_writer_uint64(&w, 23);
+  cbor_writer_uint64(&w, UINT32_MAX);
+  CHECK_EQ(cbor_writer_len(&w), 1 + 5);
+}
+/*---------------------------------------------------------------------------*/
+static void
+test_overflow(void)
+{
+  static window_t win;
+  uint8_t buf[64];
+
+  fill(&win, 8, 1759276800123ULL);
+  CHECK_EQ(encode(&win, buf, sizeof(buf)), -1);
+}
+/*---------------------------------------------------------------------------*/
+int
+main(void)
+{
+  test_uint64();
+  test_overflow();
+  test_window(2, 1759276800123ULL);
+  test_window(EDGES, 1759276800123ULL);
+  test_window(FRAMES_MAX, UINT64_MAX);
+  test_window(FRAMES_MAX, 0);
+
+  return UNIT_TEST_RESULT("test-cbor");
+}
+/*---------------------------------------------------------------------------*/
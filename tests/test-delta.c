@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file
+ *   Round trip of axis sequences through delta-codec.c and back
+ */
+/*---------------------------------------------------------------------------*/
+#include "delta-codec.h"
+#include "delta-decoder.h"
+#include "unit-test.h"
+
+#include <stdint.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+#define VALUES_MAX 256
+/*---------------------------------------------------------------------------*/
+/* Encodes, decodes and compares. Returns the encoded length */
+static int
+round_trip(const int16_t *values, uint16_t count)
+{
+  static uint8_t buf[VALUES_MAX * DELTA_CODEC_MAX_BYTES_PER_VALUE];
+  static int16_t out[VALUES_MAX];
+  delta_codec_t c;
+  uint16_t i;
+  int len;
+
+  delta_codec_init(&c, buf, sizeof(buf));
+  for(i = 0; i < count; i++) {
+    delta_codec_put(&c, values[i]);
+  }
+
+  len = delta_codec_len(&c);
+  CHECK(len >= count);
+  CHECK(len <= count * DELTA_CODEC_MAX_BYTES_PER_VALUE);
+
+  CHECK_EQ(delta_decode(buf, len, out, VALUES_MAX), count);
+  CHECK(memcmp(values, out, count * sizeof(values[0])) == 0);
+
+  return len;
+}
+/*---------------------------------------------------------------------------*/
+static void
+test_extremes(void)
+{
+  static const int16_t swing[] = { -32768, 32767, -32768, 32767, 0 };
+  static const int16_t first[] = { 32767 };
+  static const int16_t low[] = { -32768 };
+  uint8_t buf[4];
+  delta_codec_t c;
+
+  /* -32768 -> 32767 is a delta of 65535, zigzagged to 131070: 3 bytes */
+  delta_codec_init(&c, buf, sizeof(buf));
+  delta_codec_put(&c, -32768);
+  CHECK_EQ(delta_codec_len(&c), 3);
+  delta_codec_init(&c, buf, sizeof(buf));
+  c.prev = -32768;
+  delta_codec_put(&c, 32767);
+  CHECK_EQ(delta_codec_len(&c), 3);
+  CHECK_EQ(buf[0], 0xFE);
+  CHECK_EQ(buf[1], 0xFF);
+  CHECK_EQ(buf[2], 0x07);
+
+  CHECK_EQ(round_trip(swing, 5), 3 + 3 + 3 + 3 + 3);
+  CHECK_EQ(round_trip(first, 1), 3);
+  CHECK_EQ(round_trip(low, 1), 3);
+}
+/*---------------------------------------------------------------------------*/
+static void
+test_zigzag(void)
+{
+  /* 0, -1, 1, -2, 2 zigzag to 0..4. +64 is where a second byte starts */
+  static const int16_t small[] = { 0, -1, 0, 1, -1, 1, 0, 64, 0, -64 };
+  uint8_t buf[16];
+  delta_codec_t c;
+  int i;
+
+  delta_codec_init(&c, buf, sizeof(buf));
+  for(i = 0; i < 6; i++) {
+    delta_codec_put(&c, small[i]);
+  }
+  CHECK_EQ(delta_codec_len(&c), 6);
+  CHECK_EQ(buf[1], 1);
+  CHECK_EQ(buf[2], 2);
+  CHECK_EQ(buf[3], 2);
+  CHECK_EQ(buf[4], 3);
+  CHECK_EQ(buf[5], 4);
+
+  /* +64 zigzags to 128: 2 bytes. -64 to 127: 1 byte */
+  CHECK_EQ(round_trip(small, 10), 6 + 1 + 2 + 1 + 1);
+}
+/*---------------------------------------------------------------------------*/
+static void
+test_random(void)
+{
+  static int16_t values[VALUES_MAX];
+  uint32_t lcg = 1;
+  int i;
+
+  for(i = 0; i < VALUES_MAX; i++) {
+    lcg = lcg * 1103515245 + 12345;
+    values[i] = (int16_t)(lcg >> 16);
+  }
+  round_trip(values, VALUES_MAX);
+
+  /* A still sensor costs one byte per sample */
+  for(i = 0; i < VALUES_MAX; i++) {
+    values[i] = 98 + (i & 1);
+  }
+  CHECK_EQ(round_trip(values, VALUES_MAX), 2 + VALUES_MAX - 1);
+}
+/*---------------------------------------------------------------------------*/
+static void
+test_overflow(void)
+{
+  uint8_t buf[3];
+  delta_codec_t c;
+
+  /* 2 bytes each */
+  delta_codec_init(&c, buf, sizeof(buf));
+  delta_codec_put(&c, 1000);
+  delta_codec_put(&c, -1000);
+  CHECK_EQ(delta_codec_len(&c), -1);
+}
+/*---------------------------------------------------------------------------*/
+static void
+test_malformed(void)
+{
+  static const uint8_t truncated[] = { 0x80 };
+  static const uint8_t too_long[] = { 0x80, 0x80, 0x80, 0x01 };
+  static const uint8_t out_of_range[] = { 0xFE, 0xFF, 0x07, 0xFE, 0xFF, 0x07 };
+  int16_t out[4];
+
+  CHECK_EQ(delta_decode(truncated, sizeof(truncated), out, 4), -1);
+  CHECK_EQ(delta_decode(too_long, sizeof(too_long), out, 4), -1);
+  CHECK_EQ(delta_decode(out_of_range, sizeof(out_of_range), out, 4), -1);
+}
+/*---------------------------------------------------------------------------*/
+int
+main(void)
+{
+  test_extremes();
+  test_zigzag();
+  test_random();
+  test_overflow();
+  test_malformed();
+
+  return UNIT_TEST_RESULT("test-delta");
+}
+/*---------------------------------------------------------------------------*/
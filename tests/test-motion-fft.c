@@ -0,0 +1,355 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file
+ *   Accuracy of the fixed-point FFT in motion-fft.c against a
+ *   double-precision DFT of the same window.
+ *
+ *   Both sides remove the mean and apply the same Hann window. Every peak
+ *   the FFT reports must sit on a bin frequency, and its amplitude must match
+ *   the reference spectrum at that bin within the largest of:
+ *   - AMPLITUDE_TOLERANCE_PCT percent of the amplitude
+ *   - AMPLITUDE_FLOOR_PERMILLE per mille of the strongest peak in the
+ *     window, as the Q15 rounding noise scales with the input
+ *   - AMPLITUDE_TOLERANCE_ABS units
+ *
+ *   Every reference peak that stands out from its neighbours and from the
+ *   next weaker peak by more than that must be reported, the strongest one
+ *   first. Closer calls, e.g. a tone halfway between two bins, may go either
+ *   way after rounding
+ */
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+#include "motion-fft.h"
+#include "motion-buffer-stub.h"
+#include "unit-test.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+/*---------------------------------------------------------------------------*/
+#define AMPLITUDE_TOLERANCE_PCT     2
+#define AMPLITUDE_FLOOR_PERMILLE    3
+#define AMPLITUDE_TOLERANCE_ABS     2
+
+/* One more than reported, to tell whether the last one is a clear call */
+#define REF_PEAKS                   (MOTION_FFT_PEAKS + 1)
+
+#define SAMPLE_RATE               100 /* Hz */
+#define AXIS  MOTION_BUFFER_AXIS_ACC_X
+/*---------------------------------------------------------------------------*/
+typedef struct tone {
+  double bin;       /* Frequency in bins of the window; need not be whole */
+  double amplitude;
+  double phase;
+} tone_t;
+
+typedef struct ref_peak {
+  uint16_t bin;
+  double amplitude;
+} ref_peak_t;
+
+/* Sine amplitude per bin, in input units */
+static double spectrum[MOTION_FFT_MAX_SIZE / 2 + 1];
+
+/* Worst errors seen, as a share of the amplitude and of the tolerance */
+static double max_error_pct;
+static double max_error_used;
+/*---------------------------------------------------------------------------*/
+static uint32_t lcg = 1;
+
+/* Uniform noise in [-1, 1] */
+static double
+noise(void)
+{
+  lcg = lcg * 1103515245 + 12345;
+  return ((double)((lcg >> 8) & 0xFFFF) / 32767.5) - 1.0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+fill(uint16_t n, double dc, const tone_t *tones, int count, double noise_amp)
+{
+  double v;
+  uint16_t i;
+  int t;
+
+  for(i = 0; i < n; i++) {
+    v = dc + noise_amp * noise();
+    for(t = 0; t < count; t++) {
+      v += tones[t].amplitude *
+        sin(2 * M_PI * tones[t].bin * i / n + tones[t].phase);
+    }
+    v = v > 32767 ? 32767 : v < -32768 ? -32768 : v;
+    motion_buffer_stub_frames[i].axis[AXIS] = (int16_t)lround(v);
+    motion_buffer_stub_frames[i].timestamp =
+      (uint32_t)(1000 + (uint64_t)i * RTIMER_SECOND / SAMPLE_RATE);
+  }
+  motion_buffer_stub_count = n;
+}
+/*---------------------------------------------------------------------------*/
+/* The same processing as motion_fft_peaks(), in doubles */
+static int
+reference(uint16_t n, ref_peak_t *peaks)
+{
+  double x[MOTION_FFT_MAX_SIZE];
+  double power[MOTION_FFT_MAX_SIZE / 2 + 1];
+  double mean = 0, re, im;
+  uint16_t i, k;
+  int found = 0;
+  int j;
+
+  for(i = 0; i < n; i++) {
+    x[i] = motion_buffer_stub_frames[i].axis[AXIS];
+    mean += x[i];
+  }
+  mean /= n;
+
+  for(i = 0; i < n; i++) {
+    x[i] = (x[i] - mean) * (0.5 - 0.5 * cos(2 * M_PI * i / n));
+  }
+
+  for(k = 0; k <= n / 2; k++) {
+    re = 0;
+    im = 0;
+    for(i = 0; i < n; i++) {
+      re += x[i] * cos(2 * M_PI * k * i / n);
+      im -= x[i] * sin(2 * M_PI * k * i / n);
+    }
+    power[k] = re * re + im * im;
+    spectrum[k] = sqrt(power[k]) * 4 / n;
+  }
+
+  for(k = 1; k <= n / 2; k++) {
+    if(power[k] < power[k - 1] || (k < n / 2 && power[k] <= power[k + 1])) {
+      continue;
+    }
+    for(j = found; j > 0 && peaks[j - 1].amplitude < sqrt(power[k]); j--) {
+      if(j < REF_PEAKS) {
+        peaks[j] = peaks[j - 1];
+      }
+    }
+    if(j < REF_PEAKS) {
+      peaks[j].bin = k;
+      peaks[j].amplitude = sqrt(power[k]);
+      if(found < REF_PEAKS) {
+        found++;
+      }
+    }
+  }
+
+  /* Same scaling as the fixed-point result: sine amplitude in input units */
+  for(j = 0; j < found; j++) {
+    peaks[j].amplitude = peaks[j].amplitude * 4 / n;
+  }
+
+  return found;
+}
+/*---------------------------------------------------------------------------*/
+static uint32_t
+bin_freq(uint16_t bin, uint16_t n)
+{
+  uint32_t span = motion_buffer_stub_frames[n - 1].timestamp -
+    motion_buffer_stub_frames[0].timestamp;
+
+  return (uint32_t)(((uint64_t)bin * 100 * RTIMER_SECOND * (n - 1)) /
+                    ((uint64_t)n * span));
+}
+/*---------------------------------------------------------------------------*/
+static double
+tolerance(double amplitude, double strongest)
+{
+  double limit = amplitude * AMPLITUDE_TOLERANCE_PCT / 100;
+
+  if(limit < strongest * AMPLITUDE_FLOOR_PERMILLE / 1000) {
+    limit = strongest * AMPLITUDE_FLOOR_PERMILLE / 1000;
+  }
+
+  return limit > AMPLITUDE_TOLERANCE_ABS ? limit : AMPLITUDE_TOLERANCE_ABS;
+}
+/*---------------------------------------------------------------------------*/
+/* Whether a reference peak should come out of the FFT as well */
+static int
+clear_peak(const ref_peak_t *ref, int ref_found, int i, uint16_t n)
+{
+  double limit = tolerance(ref[i].amplitude, ref[0].amplitude);
+  uint16_t k = ref[i].bin;
+
+  if(ref[i].amplitude - spectrum[k - 1] <= limit ||
+     (k < n / 2 && ref[i].amplitude - spectrum[k + 1] <= limit)) {
+    return 0;
+  }
+
+  return i + 1 >= ref_found || ref[i].amplitude - ref[i + 1].amplitude > limit;
+}
+/*---------------------------------------------------------------------------*/
+static void
+compare(const char *name, uint16_t n)
+{
+  motion_fft_peak_t peaks[MOTION_FFT_PEAKS];
+  ref_peak_t ref[REF_PEAKS];
+  double error, limit;
+  int found, ref_found;
+  uint16_t k;
+  int i, j;
+
+  found = motion_fft_peaks(AXIS, 0, n, peaks);
+  ref_found = reference(n, ref);
+
+  CHECK(found > 0);
+  if(found <= 0 || ref_found <= 0) {
+    printf("%s, n=%u: no peaks\n", name, n);
+    return;
+  }
+
+  /* Everything reported is real */
+  for(j = 0; j < found; j++) {
+    for(k = 1; k <= n / 2 && bin_freq(k, n) != peaks[j].freq; k++);
+    if(k > n / 2) {
+      printf("%s, n=%u: %lu is not a bin frequency\n", name, n,
+             (unsigned long)peaks[j].freq);
+      unit_test_failures++;
+      continue;
+    }
+
+    error = fabs(peaks[j].amplitude - spectrum[k]);
+    limit = tolerance(spectrum[k], ref[0].amplitude);
+    if(error > limit) {
+      printf("%s, n=%u, bin %u: amplitude %u, reference %.2f\n", name, n, k,
+             peaks[j].amplitude, spectrum[k]);
+      unit_test_failures++;
+    }
+
+    if(spectrum[k] >= 100 && error * 100 / spectrum[k] > max_error_pct) {
+      max_error_pct = error * 100 / spectrum[k];
+    }
+    if(error * 100 / limit > max_error_used) {
+      max_error_used = error * 100 / limit;
+    }
+  }
+
+  /* Nothing clear is missing */
+  for(i = 0; i < ref_found && i < MOTION_FFT_PEAKS; i++) {
+    if(!clear_peak(ref, ref_found, i, n)) {
+      continue;
+    }
+
+    for(j = 0; j < found && peaks[j].freq != bin_freq(ref[i].bin, n); j++);
+    if(j == found) {
+      printf("%s, n=%u: no peak at bin %u (%.1f)\n", name, n, ref[i].bin,
+             ref[i].amplitude);
+      unit_test_failures++;
+    } else if(i == 0 && (ref_found == 1 ||
+                         ref[0].amplitude - ref[1].amplitude >
+                         tolerance(ref[0].amplitude, ref[0].amplitude))) {
+      CHECK_EQ(j, 0);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+test_frequency(void)
+{
+  /* 100 Hz, 64 frames: bin 8 is 12.5 Hz */
+  fill(64, 0, &(tone_t){ 8, 1000, 0 }, 1, 0);
+  CHECK_EQ(bin_freq(8, 64), 1250);
+  compare("frequency", 64);
+}
+/*---------------------------------------------------------------------------*/
+static void
+test_single_tones(void)
+{
+  static const double amplitudes[] = { 8, 50, 300, 2000, 12000, 16000 };
+  uint16_t n;
+  unsigned a;
+  double bin;
+
+  for(n = MOTION_FFT_MIN_SIZE; n <= MOTION_FFT_MAX_SIZE; n <<= 1) {
+    for(a = 0; a < sizeof(amplitudes) / sizeof(amplitudes[0]); a++) {
+      for(bin = 1; bin < n / 2; bin++) {
+        fill(n, 100, &(tone_t){ bin, amplitudes[a], bin / 3 }, 1, 0);
+        compare("tone", n);
+      }
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+test_mixtures(void)
+{
+  uint16_t n;
+  int round;
+
+  for(n = 16; n <= MOTION_FFT_MAX_SIZE; n <<= 1) {
+    for(round = 0; round < 50; round++) {
+      tone_t tones[3] = {
+        { 1 + rand() % (n / 2 - 2), 500 + rand() % 8000, rand() % 7 },
+        { 1 + rand() % (n / 2 - 2), 100 + rand() % 2000, rand() % 7 },
+        { 1 + rand() % (n / 2 - 2) + 0.5, 50 + rand() % 500, rand() % 7 },
+      };
+      fill(n, -300 + rand() % 600, tones, 3, 5);
+      compare("mixture", n);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+test_invalid(void)
+{
+  motion_fft_peak_t peaks[MOTION_FFT_PEAKS];
+
+  fill(64, 0, &(tone_t){ 4, 100, 0 }, 1, 0);
+  CHECK_EQ(motion_fft_peaks(AXIS, 0, 48, peaks), -1);
+  CHECK_EQ(motion_fft_peaks(AXIS, 1, 64, peaks), -1);
+  CHECK_EQ(motion_fft_peaks(AXIS, 0, 4, peaks), -1);
+  CHECK_EQ(motion_fft_size(7), 0);
+  CHECK_EQ(motion_fft_size(15), 8);
+  CHECK_EQ(motion_fft_size(100), 64);
+
+  /* A flat window has no peaks */
+  fill(64, 250, NULL, 0, 0);
+  CHECK_EQ(motion_fft_peaks(AXIS, 0, 64, peaks), 0);
+}
+/*---------------------------------------------------------------------------*/
+int
+main(void)
+{
+  srand(1);
+
+  test_frequency();
+  test_single_tones();
+  test_mixtures();
+  test_invalid();
+
+  printf("test-motion-fft: largest amplitude error %.2f%% (peaks >= 100), "
+         "%.0f%% of its tolerance\n", max_error_pct, max_error_used);
+
+  return UNIT_TEST_RESULT("test-motion-fft");
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,183 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file
+ *   Runs mqtt-sn.c against tools/mqttsn-gw.py over loopback UDP: CONNECT,
+ *   REGISTER/REGACK, a QoS 1 PUBLISH rejected with RC_INVALID_TOPIC_ID, the
+ *   re-registration that follows, the PUBACK of the resend, and a DUP resend
+ *   under the same message ID.
+ *   run-mqtt-sn.sh starts the gateway with --reject-first
+ *
+ *   Usage: test-mqtt-sn [gateway port]
+ */
+/*---------------------------------------------------------------------------*/
+#include "contiki.h"
+#include "mqtt-sn.h"
+#include "unit-test.h"
+
+#include <stdlib.h>
+/*---------------------------------------------------------------------------*/
+#define GATEWAY_ADDRESS "::1"
+#define TOPIC           "iot-2/evt/motion/fmt/json"
+#define CLIENT_ID       "d:host:test"
+
+/* How long to wait for an answer, in ms. Loopback needs far less */
+#define ANSWER_TIMEOUT  2000
+/* How long to wait for a PUBACK that should not come */
+#define SILENCE_TIMEOUT  300
+/*---------------------------------------------------------------------------*/
+static int connected;
+static int regacks;
+static int pubacks;
+static uint16_t puback_mid;
+/*---------------------------------------------------------------------------*/
+PROCESS(test_process, "MQTT-SN test process");
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(test_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  while(1) {
+    PROCESS_YIELD();
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+static void
+event_callback(mqtt_sn_event_t event, void *data)
+{
+  switch(event) {
+  case MQTT_SN_EVENT_CONNECTED:
+    connected = 1;
+    break;
+  case MQTT_SN_EVENT_DISCONNECTED:
+    connected = 0;
+    break;
+  case MQTT_SN_EVENT_REGACK:
+    regacks++;
+    break;
+  case MQTT_SN_EVENT_PUBACK:
+    pubacks++;
+    puback_mid = *(uint16_t *)data;
+    break;
+  default:
+    break;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+is_connected(void)
+{
+  return connected;
+}
+/*---------------------------------------------------------------------------*/
+static int regacks_wanted;
+
+static int
+got_regack(void)
+{
+  return regacks >= regacks_wanted;
+}
+/*---------------------------------------------------------------------------*/
+static int
+got_puback(void)
+{
+  return pubacks > 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+got_second_puback(void)
+{
+  return pubacks > 1;
+}
+/*---------------------------------------------------------------------------*/
+static const uint8_t payload[] = "{\"d\":{\"seq\":1}}";
+
+static int
+publish(uint16_t *mid)
+{
+  return mqtt_sn_publish(mid, TOPIC, payload, sizeof(payload) - 1,
+                         MQTT_SN_QOS_1);
+}
+/*---------------------------------------------------------------------------*/
+static int
+resend(uint16_t mid)
+{
+  return mqtt_sn_resend(mid, TOPIC, payload, sizeof(payload) - 1);
+}
+/*---------------------------------------------------------------------------*/
+int
+main(int argc, char **argv)
+{
+  uint16_t port = argc > 1 ? atoi(argv[1]) : 1884;
+  uint16_t mid = 0;
+
+  process_start(&test_process, NULL);
+  mqtt_sn_register(&test_process, CLIENT_ID, event_callback);
+
+  /* CONNECT / CONNACK */
+  CHECK(mqtt_sn_connect(GATEWAY_ADDRESS, port, 60, 0));
+  CHECK(host_contiki_run(ANSWER_TIMEOUT, is_connected));
+  CHECK(mqtt_sn_ready());
+
+  /* The first publish to a topic registers it, and has to be repeated */
+  CHECK_EQ(publish(&mid), MQTT_SN_STATUS_BUSY);
+  CHECK_EQ(publish(&mid), MQTT_SN_STATUS_BUSY);
+  regacks_wanted = 1;
+  CHECK(host_contiki_run(ANSWER_TIMEOUT, got_regack));
+
+  /* The gateway has forgotten the topic ID: no PUBACK event */
+  CHECK_EQ(publish(&mid), MQTT_SN_STATUS_OK);
+  CHECK(mid != 0);
+  CHECK(!host_contiki_run(SILENCE_TIMEOUT, got_puback));
+
+  /* So the next attempt registers again, then goes through */
+  CHECK_EQ(publish(&mid), MQTT_SN_STATUS_BUSY);
+  regacks_wanted = 2;
+  CHECK(host_contiki_run(ANSWER_TIMEOUT, got_regack));
+  CHECK_EQ(publish(&mid), MQTT_SN_STATUS_OK);
+  CHECK(host_contiki_run(ANSWER_TIMEOUT, got_puback));
+  CHECK_EQ(pubacks, 1);
+  CHECK_EQ(puback_mid, mid);
+
+  /* A resend keeps its message ID, so its PUBACK matches the first copy */
+  CHECK_EQ(resend(mid), MQTT_SN_STATUS_OK);
+  CHECK(host_contiki_run(ANSWER_TIMEOUT, got_second_puback));
+  CHECK_EQ(pubacks, 2);
+  CHECK_EQ(puback_mid, mid);
+
+  mqtt_sn_disconnect();
+  CHECK(mqtt_sn_disconnected());
+  CHECK(!connected);
+
+  return UNIT_TEST_RESULT("test-mqtt-sn");
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+"""Writes the synthetic motion traces in this directory.
+
+The traces stand in for SensorTag captures until real ones are checked in
+next to them. They are seeded, so running this again reproduces them
+exactly. Format: a header line, then one sample per line with
+acc_x,acc_y,acc_z,gyro_x,gyro_y,gyro_z in the MPU driver's units (hundredths
+of a G and hundredths of a deg/sec).
+
+Usage: generate.py [output directory]
+"""
+import math
+import os
+import random
+import sys
+
+RATE = 100       # Hz
+SAMPLES = 1024
+
+HEADER = "acc_x,acc_y,acc_z,gyro_x,gyro_y,gyro_z\n"
+
+
+def clamp(v):
+    return max(-32768, min(32767, int(round(v))))
+
+
+def still(rng, i):
+    """Resting on a table: gravity on Z, sensor noise on everything."""
+    return (rng.gauss(0, 0.7), rng.gauss(0, 0.7), 100 + rng.gauss(0, 0.7),
+            rng.gauss(0, 8), rng.gauss(0, 8), rng.gauss(0, 8))
+
+
+def walking(rng, i):
+    """Carried at about 1.8 steps per second."""
+    t = i / RATE
+    step = 2 * math.pi * 1.8 * t
+    return (25 * math.sin(step) + 8 * math.sin(2 * step) + rng.gauss(0, 2),
+            15 * math.sin(step / 2) + rng.gauss(0, 2),
+            100 + 40 * abs(math.sin(step)) + rng.gauss(0, 3),
+            2500 * math.sin(step + 0.5) + rng.gauss(0, 60),
+            1200 * math.sin(step / 2) + rng.gauss(0, 60),
+            800 * math.sin(step + 1.2) + rng.gauss(0, 60))
+
+
+def motor(rng, i):
+    """Mounted on a machine that vibrates at 24 Hz."""
+    t = i / RATE
+    hum = 2 * math.pi * 24 * t
+    return (12 * math.sin(hum) + 4 * math.sin(2 * hum) + rng.gauss(0, 1.5),
+            7 * math.sin(hum + 1.0) + rng.gauss(0, 1.5),
+            100 + 5 * math.sin(hum + 0.3) + rng.gauss(0, 1.5),
+            150 * math.sin(hum) + rng.gauss(0, 20),
+            90 * math.sin(hum + 0.7) + rng.gauss(0, 20),
+            40 * math.sin(hum + 2.1) + rng.gauss(0, 20))
+
+
+def door(rng, i):
+    """On a door that opens, stays open and slams shut again."""
+    t = i / RATE
+    gz = 0.0
+    ax = 0.0
+    if 2.0 <= t < 3.0:
+        gz = 9000 * math.sin(math.pi * (t - 2.0))
+        ax = 20 * math.sin(2 * math.pi * (t - 2.0))
+    elif 6.5 <= t < 7.1:
+        gz = -15000 * math.sin(math.pi * (t - 6.5) / 0.6)
+        ax = -30 * math.sin(2 * math.pi * (t - 6.5) / 0.6)
+    elif 7.1 <= t < 7.4:
+        # Ringing after the impact
+        decay = math.exp(-(t - 7.1) * 20)
+        ax = 180 * decay * math.sin(2 * math.pi * 35 * (t - 7.1))
+        gz = 2000 * decay * math.sin(2 * math.pi * 35 * (t - 7.1))
+    return (ax + rng.gauss(0, 0.7), rng.gauss(0, 0.7), 100 + rng.gauss(0, 0.7),
+            rng.gauss(0, 8), rng.gauss(0, 8), gz + rng.gauss(0, 8))
+
+
+def main():
+    out = sys.argv[1] if len(sys.argv) > 1 else os.path.dirname(
+        os.path.abspath(__file__))
+    for seed, f in enumerate((still, walking, motor, door)):
+        rng = random.Random(seed)
+        with open(os.path.join(out, f.__name__ + ".csv"), "w") as trace:
+            trace.write(HEADER)
+            for i in range(SAMPLES):
+                trace.write(",".join(str(clamp(v)) for v in f(rng, i)) + "\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2014, Texas Instruments Incorporated - http://www.ti.com/
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the copyright holder nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE
+ * COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/**
+ * \file
+ *   Shared checks for the host tests
+ */
+/*---------------------------------------------------------------------------*/
+#ifndef UNIT_TEST_H_
+#define UNIT_TEST_H_
+/*---------------------------------------------------------------------------*/
+#include <stdio.h>
+/*---------------------------------------------------------------------------*/
+static int unit_test_failures;
+
+/* Reports a failed condition and carries on */
+#define CHECK(c) do { \
+    if(!(c)) { \
+      printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #c); \
+      unit_test_failures++; \
+    } \
+  } while(0)
+
+/* Same, with the two values that were compared */
+#define CHECK_EQ(a, b) do { \
+    long long unit_a = (long long)(a); \
+    long long unit_b = (long long)(b); \
+    if(unit_a != unit_b) { \
+      printf("%s:%d: %s == %s failed: %lld != %lld\n", __FILE__, __LINE__, \
+             #a, #b, unit_a, unit_b); \
+      unit_test_failures++; \
+    } \
+  } while(0)
+
+/* Exit status for main() */
+#define UNIT_TEST_RESULT(name) \
+  (printf("%s: %s\n", (name), unit_test_failures ? "FAILED" : "ok"), \
+   unit_test_failures != 0)
+/*---------------------------------------------------------------------------*/
+#endif /* UNIT_TEST_H_ */
@@ -0,0 +1,187 @@
+#!/usr/bin/env python3
+"""A minimal MQTT-SN v1.2 gateway stand-in, for testing mqtt-sn.c.
+
+It speaks just enough of the protocol to answer one client over UDP:
+CONNECT, REGISTER, PUBLISH (QoS 0 and 1), SUBSCRIBE, PINGREQ and DISCONNECT.
+Topics get IDs from 1 up. Nothing is forwarded to a broker: publishes are
+printed and dropped.
+
+--reject-first forgets every registration before the first PUBLISH, as a
+restarted gateway would, so that PUBLISH is answered with
+RC_INVALID_TOPIC_ID. --expect names the message types the client must send,
+in order, with retransmissions counted once. The gateway exits after the
+client's DISCONNECT or after --timeout seconds, with status 1 if --expect
+did not match. A PUBLISH with the DUP flag is recorded as PUBLISH-DUP if
+its message ID was seen before, and as PUBLISH-DUP-NEW if not.
+
+Usage: mqttsn-gw.py [--bind ::1] [--port 1884] [--reject-first]
+                    [--expect CONNECT,REGISTER,...] [--timeout 10]
+"""
+import argparse
+import socket
+import struct
+import sys
+
+CONNECT = 0x04
+CONNACK = 0x05
+REGISTER = 0x0A
+REGACK = 0x0B
+PUBLISH = 0x0C
+PUBACK = 0x0D
+SUBSCRIBE = 0x12
+SUBACK = 0x13
+PINGREQ = 0x16
+PINGRESP = 0x17
+DISCONNECT = 0x18
+
+NAMES = {
+    CONNECT: "CONNECT", REGISTER: "REGISTER", PUBLISH: "PUBLISH",
+    SUBSCRIBE: "SUBSCRIBE", PINGREQ: "PINGREQ", DISCONNECT: "DISCONNECT",
+}
+
+RC_ACCEPTED = 0x00
+RC_INVALID_TOPIC_ID = 0x02
+
+FLAG_DUP = 0x80
+FLAG_TOPIC_PREDEFINED = 0x01
+
+
+def packet(msg_type, body=b""):
+    if len(body) + 2 <= 0xFF:
+        return bytes([len(body) + 2, msg_type]) + body
+    return struct.pack(">BHB", 0x01, len(body) + 4, msg_type) + body
+
+
+def parse(data):
+    """Returns (type, body), or None for a malformed datagram."""
+    if len(data) >= 4 and data[0] == 0x01:
+        length, pos = struct.unpack(">H", data[1:3])[0], 4
+    elif len(data) >= 2:
+        length, pos = data[0], 2
+    else:
+        return None
+    if length < pos or length > len(data):
+        return None
+    return data[pos - 1], data[pos:length]
+
+
+class Gateway:
+    def __init__(self, sock, reject_first):
+        self.sock = sock
+        self.reject_pending = reject_first
+        self.topics = {}
+        self.next_id = 1
+        self.seen = []
+        self.mids = set()
+        self.last_datagram = None
+        self.done = False
+
+    def send(self, addr, msg_type, body=b""):
+        self.sock.sendto(packet(msg_type, body), addr)
+
+    def handle(self, data, addr):
+        parsed = parse(data)
+        if parsed is None:
+            print("gw: malformed datagram %s" % data.hex())
+            return
+        msg_type, body = parsed
+
+        # Retransmissions are identical. Record them once
+        if data != self.last_datagram:
+            self.seen.append(self.name(msg_type, body))
+        self.last_datagram = data
+
+        if msg_type == CONNECT:
+            print("gw: CONNECT %s" % body[4:].decode(errors="replace"))
+            self.send(addr, CONNACK, bytes([RC_ACCEPTED]))
+        elif msg_type == REGISTER:
+            mid = body[2:4]
+            name = body[4:].decode(errors="replace")
+            if name not in self.topics:
+                self.topics[name] = self.next_id
+                self.next_id += 1
+            print("gw: REGISTER %s -> %d" % (name, self.topics[name]))
+            self.send(addr, REGACK, struct.pack(">H", self.topics[name]) +
+                      mid + bytes([RC_ACCEPTED]))
+        elif msg_type == PUBLISH:
+            self.publish(body, addr)
+        elif msg_type == SUBSCRIBE:
+            mid = body[1:3]
+            name = body[3:].decode(errors="replace")
+            topic_id = self.topics.get(name, 0)
+            print("gw: SUBSCRIBE %s" % name)
+            self.send(addr, SUBACK, bytes([body[0]]) +
+                      struct.pack(">H", topic_id) + mid + bytes([RC_ACCEPTED]))
+        elif msg_type == PINGREQ:
+            self.send(addr, PINGRESP)
+        elif msg_type == DISCONNECT:
+            print("gw: DISCONNECT")
+            self.send(addr, DISCONNECT)
+            self.done = True
+
+    def name(self, msg_type, body):
+        name = NAMES.get(msg_type, "0x%02x" % msg_type)
+        if msg_type == PUBLISH and len(body) >= 5:
+            mid = struct.unpack(">H", body[3:5])[0]
+            if body[0] & FLAG_DUP:
+                name += "-DUP" if mid in self.mids else "-DUP-NEW"
+            self.mids.add(mid)
+        return name
+
+    def publish(self, body, addr):
+        if len(body) < 5:
+            return
+        flags = body[0]
+        qos = (flags >> 5) & 0x03
+        topic_id, mid = struct.unpack(">HH", body[1:5])
+
+        if self.reject_pending:
+            print("gw: forgetting %d registrations" % len(self.topics))
+            self.topics.clear()
+            self.reject_pending = False
+
+        known = (flags & 0x03) == FLAG_TOPIC_PREDEFINED or \
+            topic_id in self.topics.values()
+        rc = RC_ACCEPTED if known else RC_INVALID_TOPIC_ID
+        print("gw: PUBLISH%s topic %d mid %d qos %d, %d bytes, rc %d" %
+              (" (dup)" if flags & FLAG_DUP else "", topic_id, mid, qos,
+               len(body) - 5, rc))
+
+        # QoS 0 publishes only hear back when the topic is unknown
+        if qos == 1 or rc != RC_ACCEPTED:
+            self.send(addr, PUBACK, body[1:5] + bytes([rc]))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("--bind", default="::1")
+    parser.add_argument("--port", type=int, default=1884)
+    parser.add_argument("--reject-first", action="store_true")
+    parser.add_argument("--expect")
+    parser.add_argument("--timeout", type=float, default=10)
+    args = parser.parse_args()
+
+    family = socket.AF_INET6 if ":" in args.bind else socket.AF_INET
+    sock = socket.socket(family, socket.SOCK_DGRAM)
+    sock.bind((args.bind, args.port))
+    sock.settimeout(args.timeout)
+    print("gw: listening on [%s]:%d" % (args.bind, args.port))
+    sys.stdout.flush()
+
+    gw = Gateway(sock, args.reject_first)
+    try:
+        while not gw.done:
+            data, addr = sock.recvfrom(1500)
+            gw.handle(data, addr)
+    except socket.timeout:
+        print("gw: timed out")
+
+    print("gw: received %s" % ",".join(gw.seen))
+    if args.expect is not None and gw.seen != args.expect.split(","):
+        print("gw: expected %s" % args.expect)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())